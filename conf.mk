@@ -0,0 +1,12 @@
+# Compiler
+CC             := cc
+# Linker [CC -fuse-ld=(USELD)]
+USELD          := # mold
+# Optimization level [CC -O(OPT_LEVEL)]
+OPT_LEVEL      := 3
+# Enable debug symbols [CC -g]
+DEBUG          := 0
+# Extra flags
+ARCH_FLAGS     := -march=native -mtune=native
+EXTRA_CFLAGS   := -fPIC -Wall -Wextra
+EXTRA_LDFLAGS  := # -flto
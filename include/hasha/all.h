@@ -2,11 +2,18 @@
  * @file hasha/all.h
  */
 
+#include "./bao.h"
 #include "./blake2.h"
 #include "./blake3.h"
 #include "./crc.h"
+#include "./cshake.h"
+#include "./k12.h"
 #include "./keccak.h"
 #include "./md5.h"
+#include "./parallelhash.h"
+#include "./pool.h"
 #include "./sha1.h"
 #include "./sha2.h"
 #include "./sha3.h"
+#include "./shake.h"
+#include "./turboshake.h"
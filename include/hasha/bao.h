@@ -0,0 +1,90 @@
+/**
+ * @file hasha/bao.h
+ * @brief Header file for Bao outboard encoding and verified slices of
+ * BLAKE3-hashed blobs.
+ *
+ * Bao stores the parent nodes of a blob's BLAKE3 tree apart from the
+ * blob: an outboard encoding is the blob length as 8 little-endian
+ * bytes, followed by every parent node (the 64-byte concatenation of
+ * its children's chaining values) in pre-order. The blob's BLAKE3 hash
+ * is the root of trust. A byte range is verified from the chunks that
+ * hold it and the parents on the paths from the root down to them, so
+ * trusting a slice takes O(log n) outboard reads instead of rehashing
+ * the whole blob.
+ *
+ * @note The blob length in the header is only authenticated by a range
+ * that includes the last chunk.
+ *
+ * @see https://github.com/oconnor663/bao for further details on Bao.
+ */
+
+#if !defined(__HASHA_BAO_H)
+#define __HASHA_BAO_H
+
+#include "internal/internal.h"
+#include "blake3.h"
+
+/**
+ * @def HA_BAO_HASH_SIZE
+ * @brief The size (in bytes) of the root hash of a Bao tree.
+ */
+#define HA_BAO_HASH_SIZE 32
+
+HA_EXTERN_C_BEG
+
+/**
+ * @brief Returns the size of the outboard encoding of a blob.
+ *
+ * @param size The blob length in bytes.
+ * @return 8 plus 64 bytes per parent node, one fewer parent than the
+ * blob has chunks.
+ */
+HA_PUBFUN uint64_t ha_bao_outboard_size(uint64_t size);
+
+/**
+ * @brief Computes the outboard encoding and the root hash of a blob.
+ *
+ * @param data Pointer to the blob.
+ * @param size The blob length in bytes.
+ * @param outboard Where to store the ha_bao_outboard_size() bytes of
+ * the encoding.
+ * @param hash Where to store the root hash, which equals the 32-byte
+ * BLAKE3 hash of the blob.
+ */
+HA_PUBFUN void ha_bao_encode_outboard(ha_inbuf_t data, size_t size,
+                                      uint8_t *outboard,
+                                      uint8_t  hash[HA_BAO_HASH_SIZE]);
+
+/**
+ * @brief Verifies a byte range of a blob against its root hash.
+ *
+ * Only the outboard header, the parents on the paths from the root to
+ * the first and last chunk of the range and the chunks of the range are
+ * read: subtrees that lie wholly inside the range are rehashed from
+ * @p data instead of being read from the outboard.
+ *
+ * @param hash The trusted root hash.
+ * @param outboard Pointer to the outboard encoding.
+ * @param outboard_size Size of the outboard encoding in bytes.
+ * @param start Offset of the range in the blob.
+ * @param length Length of the range in bytes. An empty range is checked
+ * as the byte at @p start, or as the last byte of the blob if @p start
+ * is its end.
+ * @param data The chunks that hold the checked bytes: the blob from the
+ * first checked byte rounded down to a multiple of HA_BLAKE3_CHUNK_SIZE
+ * up to the last one rounded up to one, or to the end of the blob.
+ * @param data_size Size of the buffer at @p data in bytes.
+ * @return true if the range is part of the blob with root @p hash, false
+ * if it is not, if the range or the outboard size do not match the blob
+ * length in the header, or if that length calls for more chunk bytes
+ * than @p data_size.
+ */
+HA_PUBFUN bool ha_bao_verify_range(const uint8_t  hash[HA_BAO_HASH_SIZE],
+                                   const uint8_t *outboard,
+                                   size_t outboard_size, uint64_t start,
+                                   uint64_t length, ha_inbuf_t data,
+                                   size_t data_size);
+
+HA_EXTERN_C_END
+
+#endif  // __HASHA_BAO_H
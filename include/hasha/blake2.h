@@ -1,2 +1,6 @@
 #include "./blake2b.h"
-#include "./blake2s.h"
\ No newline at end of file
+#include "./blake2bp.h"
+#include "./blake2s.h"
+#include "./blake2sp.h"
+#include "./blake2xb.h"
+#include "./blake2xs.h"
@@ -7,6 +7,21 @@
  * function declarations for initializing, updating, finalizing, and
  * computing the hash in a one-shot operation. BLAKE2b is optimized
  * for 64-bit platforms and offers high security and performance.
+ *
+ * Besides the digest length, the parameter block of the BLAKE2
+ * specification carries a key length, a salt, a personalization string
+ * and the tree parameters; ha_blake2b_init_param() takes all of them.
+ * In keyed mode (a MAC or PRF under a key of up to 64 bytes) the key,
+ * padded to a block, is hashed before the message. That block is the
+ * same for every message under the key, so ha_blake2b_save_midstate()
+ * compresses it once, and a context started from the midstate with
+ * ha_blake2b_init_midstate() hashes a short message with a single
+ * compression.
+ *
+ * The BLAKE2 kernels are picked from the CPU features. The
+ * HASHA_BLAKE2_IMPL environment variable, set to scalar, sse4.1, avx2 or
+ * avx512vl, limits all of them (BLAKE2b/s, -bp/-sp, -X) to the
+ * instruction set of that kernel.
  */
 
 #if !defined(__HASHA_BLAKE2B_H)
@@ -24,8 +39,45 @@
  */
 #define HA_BLAKE2B_DIGEST_SIZE ha_bB(512)
 
+/** @def HA_BLAKE2B_KEY_SIZE
+ *  @brief The maximum key size for keyed BLAKE2B in bytes.
+ */
+#define HA_BLAKE2B_KEY_SIZE      64
+
+/** @def HA_BLAKE2B_SALT_SIZE
+ *  @brief The size of the BLAKE2B salt in bytes.
+ */
+#define HA_BLAKE2B_SALT_SIZE     16
+
+/** @def HA_BLAKE2B_PERSONAL_SIZE
+ *  @brief The size of the BLAKE2B personalization string in bytes.
+ */
+#define HA_BLAKE2B_PERSONAL_SIZE 16
+
 HA_EXTERN_C_BEG
 
+/**
+ * @struct ha_blake2b_param
+ * @brief BLAKE2B parameter block.
+ *
+ * The fields of the 64-byte parameter block of the BLAKE2
+ * specification; ha_blake2b_param_init() sets those of sequential
+ * hashing.
+ */
+typedef struct ha_blake2b_param
+{
+  uint8_t  digest_length; /**< Length of the hash output (1 to 64). */
+  uint8_t  key_length;    /**< Length of the key (0 to 64). */
+  uint8_t  fanout;        /**< Tree fanout, 1 when sequential. */
+  uint8_t  depth;         /**< Tree depth, 1 when sequential. */
+  uint32_t leaf_length;   /**< Maximal leaf length, 0 if unlimited. */
+  uint64_t node_offset;   /**< Offset of the node in its level. */
+  uint8_t  node_depth;    /**< Depth of the node, 0 for leaves. */
+  uint8_t  inner_length;  /**< Length of the inner hashes. */
+  uint8_t  salt[HA_BLAKE2B_SALT_SIZE];         /**< Salt. */
+  uint8_t  personal[HA_BLAKE2B_PERSONAL_SIZE]; /**< Personalization. */
+} ha_blake2b_param;
+
 /**
  * @struct ha_blake2b_context
  * @brief BLAKE2B hashing context structure.
@@ -40,15 +92,100 @@ typedef struct ha_blake2b_context
   uint8_t  buf[HA_BLAKE2B_BLOCK_SIZE]; /**< Data buffer. */
   size_t   buflen; /**< Number of bytes currently in the buffer. */
   size_t   outlen; /**< Length of the hash output. */
+  /** Whether buf holds the digest of the empty input (see
+      ha_blake2b_init_midstate()). */
+  bool     midstate;
 } ha_blake2b_context;
 
+/**
+ * @struct ha_blake2b_midstate
+ * @brief A BLAKE2B context with the key block compressed.
+ */
+typedef struct ha_blake2b_midstate
+{
+  uint64_t h[8];   /**< Hash state after the key block. */
+  uint64_t t;      /**< Bytes compressed: 128 when keyed, 0 otherwise. */
+  size_t   outlen; /**< Length of the hash output. */
+  /** Digest of the empty input, which has the key block as its last. */
+  uint8_t  empty[HA_BLAKE2B_DIGEST_SIZE];
+} ha_blake2b_midstate;
+
+/**
+ * @brief Sets a BLAKE2B parameter block up for sequential hashing.
+ *
+ * @param param Pointer to the parameter block.
+ * @param digestlen Length of the hash output (1 to 64 bytes).
+ */
+HA_PUBFUN void ha_blake2b_param_init(ha_blake2b_param *param,
+                                     size_t            digestlen);
+
 /**
  * @brief Initializes a BLAKE2B context.
  *
+ * The context is set up for a HA_BLAKE2B_DIGEST_SIZE digest. Since the
+ * digest length is part of the parameter block, ha_blake2b_final() can
+ * only pick another one while no block has been compressed, that is for
+ * inputs of up to one block; use ha_blake2b_init_keyed() otherwise.
+ *
  * @param ctx Pointer to the BLAKE2B context to initialize.
  */
 HA_PUBFUN void ha_blake2b_init(ha_blake2b_context *ctx);
 
+/**
+ * @brief Initializes a BLAKE2B context from a parameter block.
+ *
+ * A digest or key length out of range is reported as an error and
+ * leaves the context without a digest length, so ha_blake2b_final()
+ * rejects it too.
+ *
+ * @param ctx Pointer to the BLAKE2B context to initialize.
+ * @param param Pointer to the parameter block.
+ * @param key Pointer to the param->key_length bytes of the key, unused
+ * when the key length is 0.
+ */
+HA_PUBFUN void ha_blake2b_init_param(ha_blake2b_context     *ctx,
+                                     const ha_blake2b_param *param,
+                                     ha_inbuf_t              key);
+
+/**
+ * @brief Initializes a BLAKE2B context for keyed hashing.
+ *
+ * Lengths out of range are rejected as in ha_blake2b_init_param().
+ *
+ * @param ctx Pointer to the BLAKE2B context to initialize.
+ * @param key Pointer to the key, unused when @p keylen is 0.
+ * @param keylen Length of the key (0 to 64 bytes); 0 hashes unkeyed.
+ * @param digestlen Length of the hash output (1 to 64 bytes).
+ */
+HA_PUBFUN void ha_blake2b_init_keyed(ha_blake2b_context *ctx,
+                                     ha_inbuf_t key, size_t keylen,
+                                     size_t digestlen);
+
+/**
+ * @brief Saves the midstate of a freshly initialized BLAKE2B context.
+ *
+ * Compresses the key block of @p ctx, which must not have been updated
+ * yet, into @p ms. @p ctx itself is left as it is.
+ *
+ * @param ctx Pointer to the BLAKE2B context initialized by
+ * ha_blake2b_init_keyed() or ha_blake2b_init_param().
+ * @param ms Pointer to the midstate to store.
+ */
+HA_PUBFUN void ha_blake2b_save_midstate(const ha_blake2b_context *ctx,
+                                        ha_blake2b_midstate      *ms);
+
+/**
+ * @brief Initializes a BLAKE2B context from a saved midstate.
+ *
+ * Continues as the context the midstate was saved from, without
+ * compressing the key block again.
+ *
+ * @param ctx Pointer to the BLAKE2B context to initialize.
+ * @param ms Pointer to the saved midstate.
+ */
+HA_PUBFUN void ha_blake2b_init_midstate(ha_blake2b_context        *ctx,
+                                        const ha_blake2b_midstate *ms);
+
 /**
  * @brief Updates the BLAKE2B hash state with input data.
  *
@@ -65,7 +202,10 @@ HA_PUBFUN void ha_blake2b_update(ha_blake2b_context *ctx, ha_inbuf_t data,
  * @param ctx Pointer to the initialized BLAKE2B context.
  * @param digest Pointer to the output buffer where the hash will be
  * stored.
- * @param digestlen Desired length of the output hash (1 to 64 bytes).
+ * @param digestlen Desired length of the output hash (1 to 64 bytes),
+ * the one the context was initialized for unless no block has been
+ * compressed yet. Any other length is reported as an error and no digest
+ * is written.
  */
 HA_PUBFUN void ha_blake2b_final(ha_blake2b_context *ctx,
                                 ha_digest_t digest, size_t digestlen);
@@ -86,6 +226,21 @@ HA_PUBFUN void ha_blake2b_final(ha_blake2b_context *ctx,
 HA_PUBFUN void ha_blake2b_hash(ha_inbuf_t data, size_t len,
                                ha_digest_t digest, size_t digestlen);
 
+/**
+ * @brief Computes the keyed BLAKE2B hash in a one-shot operation.
+ *
+ * @param key Pointer to the key, unused when @p keylen is 0.
+ * @param keylen Length of the key (0 to 64 bytes).
+ * @param data Pointer to the input data.
+ * @param len Length of the input data in bytes.
+ * @param digest Pointer to the output buffer where the hash will be
+ * stored.
+ * @param digestlen Desired length of the output hash (1 to 64 bytes).
+ */
+HA_PUBFUN void ha_blake2b_keyed_hash(ha_inbuf_t key, size_t keylen,
+                                     ha_inbuf_t data, size_t len,
+                                     ha_digest_t digest, size_t digestlen);
+
 HA_EXTERN_C_END
 
 #endif  // __HASHA_BLAKE2B_H
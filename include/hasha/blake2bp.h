@@ -0,0 +1,101 @@
+/**
+ * @file hasha/blake2bp.h
+ * @brief Header file for the BLAKE2bp hashing algorithm.
+ *
+ * BLAKE2bp is the parallel mode of BLAKE2b from the BLAKE2
+ * specification: a tree of fanout 4 and depth 2. Block i of the input
+ * (HA_BLAKE2B_BLOCK_SIZE bytes) goes to leaf i mod 4, every leaf is
+ * a BLAKE2b hash of its blocks, and the digest is the root node's
+ * BLAKE2b hash of the 4 leaf digests. The leaves are independent, so
+ * they are hashed side by side in SIMD lanes. The digest differs from
+ * the BLAKE2b one of the same input.
+ */
+
+#if !defined(__HASHA_BLAKE2BP_H)
+#define __HASHA_BLAKE2BP_H
+
+#include "internal/internal.h"
+#include "blake2b.h"
+
+/** @def HA_BLAKE2BP_LEAVES
+ *  @brief The number of leaves of a BLAKE2BP tree.
+ */
+#define HA_BLAKE2BP_LEAVES 4
+
+/** @def HA_BLAKE2BP_STRIDE
+ *  @brief The input bytes that give every leaf one block.
+ */
+#define HA_BLAKE2BP_STRIDE (HA_BLAKE2BP_LEAVES * HA_BLAKE2B_BLOCK_SIZE)
+
+/** @def HA_BLAKE2BP_DIGEST_SIZE
+ *  @brief The default output digest size for BLAKE2BP (512 bits).
+ */
+#define HA_BLAKE2BP_DIGEST_SIZE ha_bB(512)
+
+HA_EXTERN_C_BEG
+
+/**
+ * @struct ha_blake2bp_context
+ * @brief BLAKE2BP hashing context structure.
+ *
+ * A stride is only compressed once the input from its start on is longer
+ * than two strides, so that the last block of every leaf is still
+ * buffered at finalization.
+ */
+typedef struct ha_blake2bp_context
+{
+  /** Leaf states, word i of leaf l in h[i][l]. */
+  uint64_t h[8][HA_BLAKE2BP_LEAVES];
+  uint64_t t;                           /**< Bytes taken by each leaf. */
+  uint8_t  buf[2 * HA_BLAKE2BP_STRIDE]; /**< Data buffer. */
+  size_t   buflen; /**< Number of bytes currently in the buffer. */
+  size_t   outlen; /**< Length of the hash output. */
+} ha_blake2bp_context;
+
+/**
+ * @brief Initializes a BLAKE2BP context.
+ *
+ * Unlike ha_blake2b_init() this takes the digest length: every leaf
+ * hashes it into its parameter block. A length out of range is
+ * reported as an error, and final then writes no digest.
+ *
+ * @param ctx Pointer to the BLAKE2BP context to initialize.
+ * @param digestlen Length of the output hash (1 to 64 bytes).
+ */
+HA_PUBFUN void ha_blake2bp_init(ha_blake2bp_context *ctx, size_t digestlen);
+
+/**
+ * @brief Updates the BLAKE2BP hash state with input data.
+ *
+ * @param ctx Pointer to the initialized BLAKE2BP context.
+ * @param data Pointer to the input data.
+ * @param len Length of the input data in bytes.
+ */
+HA_PUBFUN void ha_blake2bp_update(ha_blake2bp_context *ctx,
+                                    ha_inbuf_t data, size_t len);
+
+/**
+ * @brief Finalizes the BLAKE2BP hash and produces the digest.
+ *
+ * @param ctx Pointer to the initialized BLAKE2BP context.
+ * @param digest Pointer to the output buffer, where the digest length
+ * given to ha_blake2bp_init() bytes are stored.
+ */
+HA_PUBFUN void ha_blake2bp_final(ha_blake2bp_context *ctx,
+                                   ha_digest_t digest);
+
+/**
+ * @brief Computes the BLAKE2BP hash in a one-shot operation.
+ *
+ * @param data Pointer to the input data.
+ * @param len Length of the input data in bytes.
+ * @param digest Pointer to the output buffer where the hash will be
+ * stored.
+ * @param digestlen Desired length of the output hash (1 to 64 bytes).
+ */
+HA_PUBFUN void ha_blake2bp_hash(ha_inbuf_t data, size_t len,
+                                  ha_digest_t digest, size_t digestlen);
+
+HA_EXTERN_C_END
+
+#endif  // __HASHA_BLAKE2BP_H
@@ -6,6 +6,11 @@
  * function, including the definition of the hash state context and
  * function declarations for initializing, updating, finalizing, and
  * computing the hash in a one-shot operation.
+ *
+ * As with BLAKE2b, ha_blake2s_init_param() takes the whole parameter
+ * block, keyed mode takes a key of up to 32 bytes, and a midstate saved
+ * with ha_blake2s_save_midstate() spares the key block's compression
+ * for every further message under the key.
  */
 
 #if !defined(__HASHA_BLAKE2S_H)
@@ -16,8 +21,45 @@
 #define HA_BLAKE2S_BLOCK_SIZE  64
 #define HA_BLAKE2S_DIGEST_SIZE ha_bB(256)
 
+/** @def HA_BLAKE2S_KEY_SIZE
+ *  @brief The maximum key size for keyed BLAKE2s in bytes.
+ */
+#define HA_BLAKE2S_KEY_SIZE      32
+
+/** @def HA_BLAKE2S_SALT_SIZE
+ *  @brief The size of the BLAKE2s salt in bytes.
+ */
+#define HA_BLAKE2S_SALT_SIZE     8
+
+/** @def HA_BLAKE2S_PERSONAL_SIZE
+ *  @brief The size of the BLAKE2s personalization string in bytes.
+ */
+#define HA_BLAKE2S_PERSONAL_SIZE 8
+
 HA_EXTERN_C_BEG
 
+/**
+ * @struct ha_blake2s_param
+ * @brief BLAKE2s parameter block.
+ *
+ * The fields of the 32-byte parameter block of the BLAKE2
+ * specification; ha_blake2s_param_init() sets those of sequential
+ * hashing.
+ */
+typedef struct ha_blake2s_param
+{
+  uint8_t  digest_length; /**< Length of the hash output (1 to 32). */
+  uint8_t  key_length;    /**< Length of the key (0 to 32). */
+  uint8_t  fanout;        /**< Tree fanout, 1 when sequential. */
+  uint8_t  depth;         /**< Tree depth, 1 when sequential. */
+  uint32_t leaf_length;   /**< Maximal leaf length, 0 if unlimited. */
+  uint64_t node_offset;   /**< Offset of the node in its level (48 bits). */
+  uint8_t  node_depth;    /**< Depth of the node, 0 for leaves. */
+  uint8_t  inner_length;  /**< Length of the inner hashes. */
+  uint8_t  salt[HA_BLAKE2S_SALT_SIZE];         /**< Salt. */
+  uint8_t  personal[HA_BLAKE2S_PERSONAL_SIZE]; /**< Personalization. */
+} ha_blake2s_param;
+
 /**
  * @struct ha_blake2s_context
  * @brief BLAKE2s hashing context structure.
@@ -33,15 +75,95 @@ typedef struct ha_blake2s_context
       buf[HA_BLAKE2S_BLOCK_SIZE]; /**< Buffer for partial input blocks. */
   size_t buflen; /**< Number of bytes currently in the buffer. */
   size_t outlen; /**< Desired output length of the hash. */
+  /** Whether buf holds the digest of the empty input (see
+      ha_blake2s_init_midstate()). */
+  bool   midstate;
 } ha_blake2s_context;
 
+/**
+ * @struct ha_blake2s_midstate
+ * @brief A BLAKE2s context with the key block compressed.
+ */
+typedef struct ha_blake2s_midstate
+{
+  uint32_t h[8];   /**< Hash state after the key block. */
+  uint32_t t;      /**< Bytes compressed: 64 when keyed, 0 otherwise. */
+  size_t   outlen; /**< Desired output length of the hash. */
+  /** Digest of the empty input, which has the key block as its last. */
+  uint8_t  empty[HA_BLAKE2S_DIGEST_SIZE];
+} ha_blake2s_midstate;
+
+/**
+ * @brief Sets a BLAKE2s parameter block up for sequential hashing.
+ *
+ * @param param Pointer to the parameter block.
+ * @param digestlen Desired length of the hash output in bytes (1–32).
+ */
+HA_PUBFUN void ha_blake2s_param_init(ha_blake2s_param *param,
+                                     size_t            digestlen);
+
 /**
  * @brief Initializes the BLAKE2s hashing context.
  *
+ * The context is set up for a HA_BLAKE2S_DIGEST_SIZE digest; see
+ * ha_blake2s_final() for when another length can still be picked.
+ *
  * @param ctx Pointer to the BLAKE2s context.
  */
 HA_PUBFUN void ha_blake2s_init(ha_blake2s_context *ctx);
 
+/**
+ * @brief Initializes the BLAKE2s hashing context from a parameter block.
+ *
+ * A digest or key length out of range is reported as an error and
+ * leaves the context without a digest length, so ha_blake2s_final()
+ * rejects it too.
+ *
+ * @param ctx Pointer to the BLAKE2s context.
+ * @param param Pointer to the parameter block.
+ * @param key Pointer to the param->key_length bytes of the key, unused
+ * when the key length is 0.
+ */
+HA_PUBFUN void ha_blake2s_init_param(ha_blake2s_context     *ctx,
+                                     const ha_blake2s_param *param,
+                                     ha_inbuf_t              key);
+
+/**
+ * @brief Initializes the BLAKE2s hashing context for keyed hashing.
+ *
+ * Lengths out of range are rejected as in ha_blake2s_init_param().
+ *
+ * @param ctx Pointer to the BLAKE2s context.
+ * @param key Pointer to the key, unused when @p keylen is 0.
+ * @param keylen Length of the key (0 to 32 bytes); 0 hashes unkeyed.
+ * @param digestlen Desired length of the hash output in bytes (1–32).
+ */
+HA_PUBFUN void ha_blake2s_init_keyed(ha_blake2s_context *ctx,
+                                     ha_inbuf_t key, size_t keylen,
+                                     size_t digestlen);
+
+/**
+ * @brief Saves the midstate of a freshly initialized BLAKE2s context.
+ *
+ * Compresses the key block of @p ctx, which must not have been updated
+ * yet, into @p ms. @p ctx itself is left as it is.
+ *
+ * @param ctx Pointer to the BLAKE2s context initialized by
+ * ha_blake2s_init_keyed() or ha_blake2s_init_param().
+ * @param ms Pointer to the midstate to store.
+ */
+HA_PUBFUN void ha_blake2s_save_midstate(const ha_blake2s_context *ctx,
+                                        ha_blake2s_midstate      *ms);
+
+/**
+ * @brief Initializes the BLAKE2s hashing context from a saved midstate.
+ *
+ * @param ctx Pointer to the BLAKE2s context.
+ * @param ms Pointer to the saved midstate.
+ */
+HA_PUBFUN void ha_blake2s_init_midstate(ha_blake2s_context        *ctx,
+                                        const ha_blake2s_midstate *ms);
+
 /**
  * @brief Updates the BLAKE2s hash with input data.
  *
@@ -65,6 +187,9 @@ HA_PUBFUN void ha_blake2s_update(ha_blake2s_context *ctx, ha_inbuf_t data,
  * @param digest Pointer to the output buffer (must be at least `outlen`
  * bytes).
  * @param digestlen Desired length of the hash output in bytes (1–32).
+ * The digest length is part of the parameter block, so it must be the
+ * one the context was initialized for once a block has been compressed;
+ * any other length is reported as an error and no digest is written.
  */
 HA_PUBFUN void ha_blake2s_final(ha_blake2s_context *ctx,
                                 ha_digest_t digest, size_t digestlen);
@@ -84,6 +209,21 @@ HA_PUBFUN void ha_blake2s_final(ha_blake2s_context *ctx,
 HA_PUBFUN void ha_blake2s_hash(ha_inbuf_t data, size_t len,
                                ha_digest_t digest, size_t digestlen);
 
+/**
+ * @brief Computes the keyed BLAKE2s hash of the input data.
+ *
+ * @param key Pointer to the key, unused when @p keylen is 0.
+ * @param keylen Length of the key (0 to 32 bytes).
+ * @param data Pointer to the input data.
+ * @param len Length of the input data in bytes.
+ * @param digest Pointer to the output buffer (must be at least `digestlen`
+ * bytes).
+ * @param digestlen Desired length of the hash output in bytes (1–32).
+ */
+HA_PUBFUN void ha_blake2s_keyed_hash(ha_inbuf_t key, size_t keylen,
+                                     ha_inbuf_t data, size_t len,
+                                     ha_digest_t digest, size_t digestlen);
+
 HA_EXTERN_C_END
 
 #endif  // __HASHA_BLAKE2S_H
@@ -0,0 +1,101 @@
+/**
+ * @file hasha/blake2sp.h
+ * @brief Header file for the BLAKE2sp hashing algorithm.
+ *
+ * BLAKE2sp is the parallel mode of BLAKE2s from the BLAKE2
+ * specification: a tree of fanout 8 and depth 2. Block i of the input
+ * (HA_BLAKE2S_BLOCK_SIZE bytes) goes to leaf i mod 8, every leaf is
+ * a BLAKE2s hash of its blocks, and the digest is the root node's
+ * BLAKE2s hash of the 8 leaf digests. The leaves are independent, so
+ * they are hashed side by side in SIMD lanes. The digest differs from
+ * the BLAKE2s one of the same input.
+ */
+
+#if !defined(__HASHA_BLAKE2SP_H)
+#define __HASHA_BLAKE2SP_H
+
+#include "internal/internal.h"
+#include "blake2s.h"
+
+/** @def HA_BLAKE2SP_LEAVES
+ *  @brief The number of leaves of a BLAKE2SP tree.
+ */
+#define HA_BLAKE2SP_LEAVES 8
+
+/** @def HA_BLAKE2SP_STRIDE
+ *  @brief The input bytes that give every leaf one block.
+ */
+#define HA_BLAKE2SP_STRIDE (HA_BLAKE2SP_LEAVES * HA_BLAKE2S_BLOCK_SIZE)
+
+/** @def HA_BLAKE2SP_DIGEST_SIZE
+ *  @brief The default output digest size for BLAKE2SP (256 bits).
+ */
+#define HA_BLAKE2SP_DIGEST_SIZE ha_bB(256)
+
+HA_EXTERN_C_BEG
+
+/**
+ * @struct ha_blake2sp_context
+ * @brief BLAKE2SP hashing context structure.
+ *
+ * A stride is only compressed once the input from its start on is longer
+ * than two strides, so that the last block of every leaf is still
+ * buffered at finalization.
+ */
+typedef struct ha_blake2sp_context
+{
+  /** Leaf states, word i of leaf l in h[i][l]. */
+  uint32_t h[8][HA_BLAKE2SP_LEAVES];
+  uint64_t t;                           /**< Bytes taken by each leaf. */
+  uint8_t  buf[2 * HA_BLAKE2SP_STRIDE]; /**< Data buffer. */
+  size_t   buflen; /**< Number of bytes currently in the buffer. */
+  size_t   outlen; /**< Length of the hash output. */
+} ha_blake2sp_context;
+
+/**
+ * @brief Initializes a BLAKE2SP context.
+ *
+ * Unlike ha_blake2s_init() this takes the digest length: every leaf
+ * hashes it into its parameter block. A length out of range is
+ * reported as an error, and final then writes no digest.
+ *
+ * @param ctx Pointer to the BLAKE2SP context to initialize.
+ * @param digestlen Length of the output hash (1 to 32 bytes).
+ */
+HA_PUBFUN void ha_blake2sp_init(ha_blake2sp_context *ctx, size_t digestlen);
+
+/**
+ * @brief Updates the BLAKE2SP hash state with input data.
+ *
+ * @param ctx Pointer to the initialized BLAKE2SP context.
+ * @param data Pointer to the input data.
+ * @param len Length of the input data in bytes.
+ */
+HA_PUBFUN void ha_blake2sp_update(ha_blake2sp_context *ctx,
+                                    ha_inbuf_t data, size_t len);
+
+/**
+ * @brief Finalizes the BLAKE2SP hash and produces the digest.
+ *
+ * @param ctx Pointer to the initialized BLAKE2SP context.
+ * @param digest Pointer to the output buffer, where the digest length
+ * given to ha_blake2sp_init() bytes are stored.
+ */
+HA_PUBFUN void ha_blake2sp_final(ha_blake2sp_context *ctx,
+                                   ha_digest_t digest);
+
+/**
+ * @brief Computes the BLAKE2SP hash in a one-shot operation.
+ *
+ * @param data Pointer to the input data.
+ * @param len Length of the input data in bytes.
+ * @param digest Pointer to the output buffer where the hash will be
+ * stored.
+ * @param digestlen Desired length of the output hash (1 to 32 bytes).
+ */
+HA_PUBFUN void ha_blake2sp_hash(ha_inbuf_t data, size_t len,
+                                  ha_digest_t digest, size_t digestlen);
+
+HA_EXTERN_C_END
+
+#endif  // __HASHA_BLAKE2SP_H
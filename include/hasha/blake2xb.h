@@ -0,0 +1,137 @@
+/**
+ * @file hasha/blake2xb.h
+ * @brief Header file for the BLAKE2Xb extendable-output function.
+ *
+ * BLAKE2Xb hashes the input once into a 64-byte root digest H0, with
+ * the output length in the parameter block, and then expands it: the
+ * output is the concatenation of output nodes, node i being the BLAKE2b
+ * hash of H0 alone under a parameter block that differs from the others
+ * only in its node offset i (and the digest length of the last node).
+ * The nodes are independent, so any range of the output is reached
+ * without computing what precedes it, and HA_BLAKE2XB_LANES nodes are
+ * compressed side by side in SIMD lanes.
+ *
+ * @see https://www.blake2.net/blake2x.pdf for further details on BLAKE2X.
+ */
+
+#if !defined(__HASHA_BLAKE2XB_H)
+#define __HASHA_BLAKE2XB_H
+
+#include "internal/internal.h"
+#include "blake2b.h"
+
+/** @def HA_BLAKE2XB_LANES
+ *  @brief The number of output nodes computed together.
+ */
+#define HA_BLAKE2XB_LANES          4
+
+/** @def HA_BLAKE2XB_NODE_SIZE
+ *  @brief The output bytes of each BLAKE2XB output node.
+ */
+#define HA_BLAKE2XB_NODE_SIZE      64
+
+/** @def HA_BLAKE2XB_UNKNOWN_LENGTH
+ *  @brief The output length for output that is read until it suffices,
+ *  up to 2^32 nodes.
+ */
+#define HA_BLAKE2XB_UNKNOWN_LENGTH 0xffffffffUL
+
+HA_EXTERN_C_BEG
+
+/**
+ * @struct ha_blake2xb_context
+ * @brief BLAKE2XB hashing context structure.
+ */
+typedef struct ha_blake2xb_context
+{
+  ha_blake2b_context root; /**< Hash of the input into H0. */
+  uint32_t xoflen; /**< Output length, or HA_BLAKE2XB_UNKNOWN_LENGTH. */
+  /** H0 padded with zeros, the message of every output node. */
+  uint8_t  block[HA_BLAKE2B_BLOCK_SIZE];
+  /** Output of the nodes from HA_BLAKE2XB_LANES * group on. */
+  uint8_t  buf[HA_BLAKE2XB_LANES * HA_BLAKE2XB_NODE_SIZE];
+  uint64_t group;     /**< Group of nodes in buf, or UINT64_MAX. */
+  uint64_t pos;       /**< Output bytes read so far. */
+  bool     finalized; /**< Whether H0 has been computed. */
+} ha_blake2xb_context;
+
+/**
+ * @brief Initializes a BLAKE2XB context.
+ *
+ * @param ctx Pointer to the BLAKE2XB context to initialize.
+ * @param outlen Length of the output (1 to 2^32 - 2 bytes), or
+ * HA_BLAKE2XB_UNKNOWN_LENGTH. It is hashed into the root, so outputs of
+ * different lengths are unrelated. Any other length is reported as an
+ * error, and the context then yields no output.
+ */
+HA_PUBFUN void ha_blake2xb_init(ha_blake2xb_context *ctx, size_t outlen);
+
+/**
+ * @brief Initializes a BLAKE2XB context for keyed hashing.
+ *
+ * @param ctx Pointer to the BLAKE2XB context to initialize.
+ * @param key Pointer to the key, unused when @p keylen is 0.
+ * @param keylen Length of the key (0 to 64 bytes).
+ * @param outlen Length of the output, as for ha_blake2xb_init().
+ */
+HA_PUBFUN void ha_blake2xb_init_keyed(ha_blake2xb_context *ctx,
+                                      ha_inbuf_t key, size_t keylen,
+                                      size_t outlen);
+
+/**
+ * @brief Updates the BLAKE2XB hash state with input data.
+ *
+ * @param ctx Pointer to the initialized BLAKE2XB context.
+ * @param data Pointer to the input data.
+ * @param len Length of the input data in bytes.
+ */
+HA_PUBFUN void ha_blake2xb_update(ha_blake2xb_context *ctx,
+                                  ha_inbuf_t data, size_t len);
+
+/**
+ * @brief Finalizes the BLAKE2XB input and reads the start of the output.
+ *
+ * @param ctx Pointer to the initialized BLAKE2XB context.
+ * @param digest Pointer to the output buffer.
+ * @param digestlen Number of output bytes to read.
+ */
+HA_PUBFUN void ha_blake2xb_final(ha_blake2xb_context *ctx,
+                                 ha_digest_t digest, size_t digestlen);
+
+/**
+ * @brief Reads more BLAKE2XB output.
+ *
+ * Continues where ha_blake2xb_final(), the previous call or
+ * ha_blake2xb_seek() left off. With a known output length, the output
+ * ends there.
+ *
+ * @param ctx Pointer to the finalized BLAKE2XB context.
+ * @param out Pointer to the output buffer.
+ * @param len Number of output bytes to read.
+ */
+HA_PUBFUN void ha_blake2xb_squeeze(ha_blake2xb_context *ctx,
+                                   ha_digest_t out, size_t len);
+
+/**
+ * @brief Moves the BLAKE2XB output position.
+ *
+ * @param ctx Pointer to the finalized BLAKE2XB context.
+ * @param pos Offset of the next output byte to read.
+ */
+HA_PUBFUN void ha_blake2xb_seek(ha_blake2xb_context *ctx, uint64_t pos);
+
+/**
+ * @brief Computes BLAKE2XB output in a one-shot operation.
+ *
+ * @param data Pointer to the input data.
+ * @param len Length of the input data in bytes.
+ * @param digest Pointer to the output buffer.
+ * @param digestlen Length of the output, which is also hashed into the
+ * root.
+ */
+HA_PUBFUN void ha_blake2xb_hash(ha_inbuf_t data, size_t len,
+                                ha_digest_t digest, size_t digestlen);
+
+HA_EXTERN_C_END
+
+#endif  // __HASHA_BLAKE2XB_H
@@ -11,6 +11,28 @@
  * processing data in chunks and producing variable-length digests. This
  * header is part of the libhasha library.
  *
+ * Besides plain hashing, BLAKE3 has a keyed mode (a MAC or PRF under a
+ * 32-byte key) and a key derivation mode, in which a context string is
+ * hashed once into the key that the key material is hashed with. Both
+ * keep their key in the context, and ha_blake3_reset() starts the next
+ * message under it, so deriving another subkey for the same context, or
+ * authenticating another message, does not hash the context string or
+ * expand the key again.
+ *
+ * The output is an unbounded stream. ha_blake3_finalize_xof() keeps the
+ * root node in a reader, from which any range of the stream can be read
+ * directly: every 64-byte output block is one compression of the root
+ * with its own counter, so ha_blake3_xof_seek() costs at most one block,
+ * and runs of blocks are computed side by side in SIMD lanes.
+ *
+ * The tree can also be hashed piecewise, for example by the storage
+ * nodes that each hold a range of a large object. A context moved to a
+ * chunk-aligned input offset with ha_blake3_set_input_offset() hashes
+ * one subtree and ends in ha_blake3_finalize_subtree(), which yields its
+ * 32-byte chaining value. ha_blake3_merge_root() combines the chaining
+ * values of consecutive subtrees into the root, with the same digest as
+ * hashing the whole input at once.
+ *
  * @note The implementation assumes that the target system supports the
  * necessary integer types and that sufficient memory is allocated for the
  * digest.
@@ -23,6 +45,25 @@
 #define __HASHA_BLAKE3_H
 
 #include "internal/internal.h"
+#include "pool.h"
+
+/**
+ * @def HA_BLAKE3_KEY_SIZE
+ * @brief The key size (in bytes) of keyed BLAKE3.
+ */
+#define HA_BLAKE3_KEY_SIZE 32
+
+/**
+ * @def HA_BLAKE3_CV_SIZE
+ * @brief The size (in bytes) of a BLAKE3 subtree chaining value.
+ */
+#define HA_BLAKE3_CV_SIZE 32
+
+/**
+ * @def HA_BLAKE3_CHUNK_SIZE
+ * @brief The size (in bytes) of a BLAKE3 chunk, the leaf of the tree.
+ */
+#define HA_BLAKE3_CHUNK_SIZE 1024
 
 HA_EXTERN_C_BEG
 
@@ -68,6 +109,12 @@ typedef struct ha_blake3_context
    */
   uint64_t  chunk;
 
+  /**
+   * @brief The chunk counter of the first chunk, nonzero for a subtree
+   * hashed at an input offset.
+   */
+  uint64_t  chunk_offset;
+
   /**
    * @brief Pointer to the current hash state.
    *
@@ -85,8 +132,62 @@ typedef struct ha_blake3_context
    * with each round consisting of 8 words (32 bytes).
    */
   uint32_t  cv_buf[54 * 8];
+
+  /**
+   * @brief The key words every chunk and parent starts from.
+   *
+   * The BLAKE3 IV for plain hashing, the key for keyed hashing and the
+   * context key for key derivation.
+   */
+  uint32_t  key[8];
+
+  /**
+   * @brief The mode flags set on every compression (0 for plain
+   * hashing).
+   */
+  uint32_t  flags;
 } ha_blake3_context;
 
+/**
+ * @brief Reader of the BLAKE3 output stream.
+ *
+ * Holds the root node, which fixes the whole output, and the position
+ * of the next byte to read.
+ */
+typedef struct ha_blake3_xof_reader
+{
+  /**
+   * @brief The message block of the root node.
+   */
+  uint32_t block[16];
+
+  /**
+   * @brief The chaining value the root node starts from.
+   */
+  uint32_t cv[8];
+
+  /**
+   * @brief The number of bytes in the root message block.
+   */
+  uint32_t length;
+
+  /**
+   * @brief The flags of the root compression, ROOT included.
+   */
+  uint32_t flags;
+
+  /**
+   * @brief The output position of the next byte to read.
+   */
+  uint64_t offset;
+
+  /**
+   * @brief The output block holding the next byte while @c offset is
+   * not a multiple of 64.
+   */
+  uint8_t  buf[64];
+} ha_blake3_xof_reader;
+
 /**
  * @brief Initializes the BLAKE3 context for hashing.
  *
@@ -97,6 +198,39 @@ typedef struct ha_blake3_context
  */
 HA_PUBFUN void ha_blake3_init(ha_blake3_context *ctx);
 
+/**
+ * @brief Initializes the BLAKE3 context for keyed hashing.
+ *
+ * @param ctx Pointer to a BLAKE3 context structure to be initialized.
+ * @param key The 32-byte key.
+ */
+HA_PUBFUN void ha_blake3_init_keyed(ha_blake3_context *ctx,
+                                    const uint8_t key[HA_BLAKE3_KEY_SIZE]);
+
+/**
+ * @brief Initializes the BLAKE3 context for key derivation.
+ *
+ * Hashes @p context into the context key; the key material is then
+ * passed to ha_blake3_update() and the derived key read with
+ * ha_blake3_final(). To derive further keys for the same context, call
+ * ha_blake3_reset() instead of initializing again: a derivation from up
+ * to 64 bytes of key material then costs a single compression.
+ *
+ * @param ctx Pointer to a BLAKE3 context structure to be initialized.
+ * @param context The context string: hardcoded, globally unique and
+ * application-specific, NUL-terminated.
+ */
+HA_PUBFUN void ha_blake3_init_derive_key(ha_blake3_context *ctx,
+                                         const char *context);
+
+/**
+ * @brief Restarts the BLAKE3 context for a new input in the same mode
+ * and under the same key.
+ *
+ * @param ctx Pointer to an initialized BLAKE3 context structure.
+ */
+HA_PUBFUN void ha_blake3_reset(ha_blake3_context *ctx);
+
 /**
  * @brief Updates the BLAKE3 hash with more input data.
  *
@@ -111,6 +245,26 @@ HA_PUBFUN void ha_blake3_init(ha_blake3_context *ctx);
 HA_PUBFUN void ha_blake3_update(ha_blake3_context *ctx, ha_inbuf_t data,
                                 size_t length);
 
+/**
+ * @brief Updates the BLAKE3 hash with input hashed on a thread pool.
+ *
+ * Behaves exactly like ha_blake3_update(), and may be mixed with it on
+ * the same context, but cuts runs of whole chunks into subtrees of
+ * 256 chunks (256 KiB). Every subtree is hashed by one pool task and
+ * its chaining value is merged into the context as the serial update
+ * would have computed it, so the digest is bit-identical. Input of
+ * less than one subtree is hashed on the calling thread.
+ *
+ * @param ctx Pointer to the BLAKE3 context structure.
+ * @param data Pointer to the input data to be hashed.
+ * @param length The length of the input data in bytes.
+ * @param pool Pool that hashes the subtrees, or NULL for the calling
+ * thread.
+ */
+HA_PUBFUN void ha_blake3_update_parallel(ha_blake3_context *ctx,
+                                         ha_inbuf_t data, size_t length,
+                                         ha_pool *pool);
+
 /**
  * @brief Finalizes the BLAKE3 hash and produces the final digest.
  *
@@ -126,6 +280,106 @@ HA_PUBFUN void ha_blake3_update(ha_blake3_context *ctx, ha_inbuf_t data,
 HA_PUBFUN void ha_blake3_final(ha_blake3_context *ctx, ha_digest_t digest,
                                size_t length);
 
+/**
+ * @brief Finalizes the BLAKE3 hash into an output stream reader.
+ *
+ * The reader starts at offset 0; ha_blake3_final() is this followed by
+ * a single read. The context must be initialized or reset before it is
+ * used again.
+ *
+ * @param ctx Pointer to the BLAKE3 context structure.
+ * @param reader Pointer to the reader to set up.
+ */
+HA_PUBFUN void ha_blake3_finalize_xof(ha_blake3_context    *ctx,
+                                      ha_blake3_xof_reader *reader);
+
+/**
+ * @brief Reads the next bytes of the BLAKE3 output stream.
+ *
+ * @param reader Pointer to the reader.
+ * @param out Pointer to the output buffer.
+ * @param length Number of bytes to read.
+ */
+HA_PUBFUN void ha_blake3_xof_read(ha_blake3_xof_reader *reader,
+                                  ha_digest_t out, size_t length);
+
+/**
+ * @brief Moves the reader to a position of the BLAKE3 output stream.
+ *
+ * Output before @p offset is not computed; the cost is at most one
+ * output block.
+ *
+ * @param reader Pointer to the reader.
+ * @param offset Position of the next byte to read.
+ */
+HA_PUBFUN void ha_blake3_xof_seek(ha_blake3_xof_reader *reader,
+                                  uint64_t              offset);
+
+/**
+ * @brief Places the input of the BLAKE3 context at an offset of a larger
+ * input, to hash one subtree of its tree.
+ *
+ * Must be called right after initialization or a reset. A subtree at
+ * @p offset holds at most as many chunks as the largest power of two
+ * that divides @p offset / HA_BLAKE3_CHUNK_SIZE, and fewer only if it
+ * ends the input; any offset works for a subtree that starts the input.
+ * The context is finished with ha_blake3_finalize_subtree().
+ *
+ * @param ctx Pointer to the BLAKE3 context structure.
+ * @param offset Input offset in bytes, a multiple of
+ * HA_BLAKE3_CHUNK_SIZE.
+ */
+HA_PUBFUN void ha_blake3_set_input_offset(ha_blake3_context *ctx,
+                                          uint64_t           offset);
+
+/**
+ * @brief Finalizes the BLAKE3 context into the chaining value of its
+ * subtree.
+ *
+ * The context must be initialized or reset before it is used again.
+ *
+ * @param ctx Pointer to the BLAKE3 context structure.
+ * @param cv Where to store the 32-byte chaining value.
+ */
+HA_PUBFUN void ha_blake3_finalize_subtree(ha_blake3_context *ctx,
+                                          uint8_t cv[HA_BLAKE3_CV_SIZE]);
+
+/**
+ * @brief Merges the chaining values of consecutive subtrees into the
+ * chaining value of the subtree that covers them.
+ *
+ * The subtrees must be of the same power-of-two number of chunks, but
+ * the last one may be shorter, and the subtree that covers them must
+ * itself be aligned as described at ha_blake3_set_input_offset().
+ *
+ * @param ctx A context initialized in the mode (and with the key) the
+ * subtrees were hashed in; it is not modified.
+ * @param cvs The @p n chaining values, in input order.
+ * @param n The number of subtrees, at least 2.
+ * @param cv Where to store the merged chaining value.
+ */
+HA_PUBFUN void ha_blake3_merge_subtrees(const ha_blake3_context *ctx,
+                                        const uint8_t *cvs, size_t n,
+                                        uint8_t cv[HA_BLAKE3_CV_SIZE]);
+
+/**
+ * @brief Merges the chaining values of the subtrees that make up the
+ * whole input into the root, and sets up a reader of its output.
+ *
+ * The subtrees are as for ha_blake3_merge_subtrees(), the first one
+ * starting at offset 0. An input that fits in a single subtree has no
+ * parent root and is hashed with ha_blake3_update() instead.
+ *
+ * @param ctx A context initialized in the mode (and with the key) the
+ * subtrees were hashed in; it is not modified.
+ * @param cvs The @p n chaining values, in input order.
+ * @param n The number of subtrees, at least 2.
+ * @param reader Pointer to the reader to set up at offset 0.
+ */
+HA_PUBFUN void ha_blake3_merge_root(const ha_blake3_context *ctx,
+                                    const uint8_t *cvs, size_t n,
+                                    ha_blake3_xof_reader *reader);
+
 /**
  * @brief Computes the BLAKE3 hash in a single operation.
  *
@@ -143,6 +397,21 @@ HA_PUBFUN void ha_blake3_final(ha_blake3_context *ctx, ha_digest_t digest,
 HA_PUBFUN void ha_blake3_hash(ha_inbuf_t data, size_t length,
                               ha_digest_t digest, size_t digest_length);
 
+/**
+ * @brief Computes the keyed BLAKE3 hash in a single operation.
+ *
+ * @param key The 32-byte key.
+ * @param data Pointer to the input data to be hashed.
+ * @param length The length of the input data in bytes.
+ * @param digest Pointer to a buffer where the resulting digest will be
+ * stored.
+ * @param digest_length The length of the digest to be produced, in bytes.
+ */
+HA_PUBFUN void ha_blake3_keyed_hash(const uint8_t key[HA_BLAKE3_KEY_SIZE],
+                                    ha_inbuf_t data, size_t length,
+                                    ha_digest_t digest,
+                                    size_t digest_length);
+
 HA_EXTERN_C_END
 
 #endif  // __HASHA_BLAKE3_H
@@ -0,0 +1,388 @@
+/**
+ * @file hasha/cshake.h
+ * @brief Header file for cSHAKE and the SP 800-185 functions built on it.
+ *
+ * This header file defines the interface for cSHAKE128/256 and the two
+ * derived functions of NIST SP 800-185 that share its context: KMAC128/
+ * 256 (a keyed MAC) and TupleHash128/256 (a hash of a sequence of
+ * strings).
+ *
+ * All of them start by absorbing a prefix that depends only on their
+ * parameters: the function name and customization string, plus the key
+ * for KMAC. The context keeps a snapshot of the sponge taken right
+ * after that prefix, so the reset functions start the next message from
+ * the pre-absorbed state instead of absorbing the prefix blocks again.
+ * With a fixed key, KMAC on short messages then costs one permutation
+ * per message instead of three.
+ *
+ * @see https://doi.org/10.6028/NIST.SP.800-185 for further details on
+ * cSHAKE, KMAC and TupleHash.
+ */
+
+#if !defined(__HASHA_CSHAKE_H)
+#define __HASHA_CSHAKE_H
+
+#include "internal/internal.h"
+#include "keccak.h"
+#include "shake.h"
+
+HA_EXTERN_C_BEG
+
+/**
+ * @struct ha_cshake_context
+ * @brief The context structure shared by cSHAKE, KMAC and TupleHash.
+ */
+typedef struct ha_cshake_context
+{
+  /**
+   * @brief The running sponge.
+   */
+  ha_keccak_context sponge;
+
+  /**
+   * @brief Snapshot of the sponge after the prefix blocks, restored by
+   * the reset functions.
+   */
+  ha_keccak_context prefix;
+
+  /**
+   * @brief Domain padding byte: HA_PB_SHAKE when cSHAKE has neither a
+   * function name nor a customization string (it is then SHAKE),
+   * HA_PB_CSHAKE otherwise.
+   */
+  uint8_t           pad;
+} ha_cshake_context;
+
+typedef ha_cshake_context ha_cshake128_context, ha_cshake256_context;
+typedef ha_cshake_context ha_kmac128_context, ha_kmac256_context;
+typedef ha_cshake_context ha_tuplehash128_context, ha_tuplehash256_context;
+
+/**
+ * @brief Initializes a cSHAKE128 context.
+ *
+ * @param ctx Pointer to the cSHAKE128 context structure to initialize.
+ * @param name Function-name string N (may be NULL when @p namelen is 0).
+ * @param namelen Length of @p name in bytes.
+ * @param custom Customization string S (may be NULL when @p customlen
+ * is 0).
+ * @param customlen Length of @p custom in bytes.
+ */
+HA_PUBFUN void ha_cshake128_init(ha_cshake128_context *ctx,
+                                 const uint8_t *name, size_t namelen,
+                                 const uint8_t *custom, size_t customlen);
+
+/**
+ * @brief Restarts a cSHAKE128, KMAC128 or TupleHash128 context for a
+ * new message with the same parameters, from the prefix snapshot.
+ *
+ * @param ctx Pointer to an initialized context structure.
+ */
+HA_PUBFUN void ha_cshake128_reset(ha_cshake128_context *ctx);
+
+/**
+ * @brief Absorbs data into the cSHAKE128 context.
+ *
+ * @param ctx Pointer to the cSHAKE128 context structure.
+ * @param data Pointer to the input data to process.
+ * @param length Length of the input data in bytes.
+ */
+HA_PUBFUN void ha_cshake128_update(ha_cshake128_context *ctx,
+                                   ha_inbuf_t data, size_t length);
+
+/**
+ * @brief Finalizes the cSHAKE128 input and reads the first output bytes.
+ *
+ * @param ctx Pointer to the cSHAKE128 context structure.
+ * @param digest Pointer to the output buffer.
+ * @param digestlen Number of output bytes to produce (may be 0).
+ */
+HA_PUBFUN void ha_cshake128_final(ha_cshake128_context *ctx,
+                                  ha_digest_t digest, size_t digestlen);
+
+/**
+ * @brief Reads the next bytes of the output stream of a finalized
+ * cSHAKE128, KMACXOF128 or TupleHashXOF128 context.
+ *
+ * @param ctx Pointer to the finalized context structure.
+ * @param out Pointer to the output buffer.
+ * @param length Number of output bytes to produce.
+ */
+HA_PUBFUN void ha_cshake128_squeeze(ha_cshake128_context *ctx,
+                                    ha_digest_t out, size_t length);
+
+/**
+ * @brief Computes cSHAKE128 output in a one-shot operation.
+ *
+ * @param data Pointer to the input data to process.
+ * @param length Length of the input data in bytes.
+ * @param name Function-name string N.
+ * @param namelen Length of @p name in bytes.
+ * @param custom Customization string S.
+ * @param customlen Length of @p custom in bytes.
+ * @param digest Pointer to the output buffer.
+ * @param digestlen Number of output bytes to produce.
+ */
+HA_PUBFUN void ha_cshake128_hash(ha_inbuf_t data, size_t length,
+                                 const uint8_t *name, size_t namelen,
+                                 const uint8_t *custom, size_t customlen,
+                                 ha_digest_t digest, size_t digestlen);
+
+/**
+ * @brief Initializes a cSHAKE256 context.
+ * @see ha_cshake128_init()
+ */
+HA_PUBFUN void ha_cshake256_init(ha_cshake256_context *ctx,
+                                 const uint8_t *name, size_t namelen,
+                                 const uint8_t *custom, size_t customlen);
+
+/**
+ * @brief Restarts a cSHAKE256, KMAC256 or TupleHash256 context.
+ * @see ha_cshake128_reset()
+ */
+HA_PUBFUN void ha_cshake256_reset(ha_cshake256_context *ctx);
+
+/**
+ * @brief Absorbs data into the cSHAKE256 context.
+ * @see ha_cshake128_update()
+ */
+HA_PUBFUN void ha_cshake256_update(ha_cshake256_context *ctx,
+                                   ha_inbuf_t data, size_t length);
+
+/**
+ * @brief Finalizes the cSHAKE256 input and reads the first output bytes.
+ * @see ha_cshake128_final()
+ */
+HA_PUBFUN void ha_cshake256_final(ha_cshake256_context *ctx,
+                                  ha_digest_t digest, size_t digestlen);
+
+/**
+ * @brief Reads the next bytes of a finalized cSHAKE256, KMACXOF256 or
+ * TupleHashXOF256 output stream.
+ * @see ha_cshake128_squeeze()
+ */
+HA_PUBFUN void ha_cshake256_squeeze(ha_cshake256_context *ctx,
+                                    ha_digest_t out, size_t length);
+
+/**
+ * @brief Computes cSHAKE256 output in a one-shot operation.
+ * @see ha_cshake128_hash()
+ */
+HA_PUBFUN void ha_cshake256_hash(ha_inbuf_t data, size_t length,
+                                 const uint8_t *name, size_t namelen,
+                                 const uint8_t *custom, size_t customlen,
+                                 ha_digest_t digest, size_t digestlen);
+
+/**
+ * @brief Initializes a KMAC128 context with a key.
+ *
+ * The padded key block is absorbed here, once; ha_cshake128_reset()
+ * starts each further message under the same key without absorbing it
+ * again.
+ *
+ * @param ctx Pointer to the KMAC128 context structure to initialize.
+ * @param key Pointer to the key.
+ * @param keylen Length of the key in bytes.
+ * @param custom Customization string S (may be NULL when @p customlen
+ * is 0).
+ * @param customlen Length of @p custom in bytes.
+ */
+HA_PUBFUN void ha_kmac128_init(ha_kmac128_context *ctx, const uint8_t *key,
+                               size_t keylen, const uint8_t *custom,
+                               size_t customlen);
+
+/**
+ * @brief Absorbs message data into the KMAC128 context.
+ *
+ * @param ctx Pointer to the KMAC128 context structure.
+ * @param data Pointer to the input data to process.
+ * @param length Length of the input data in bytes.
+ */
+HA_PUBFUN void ha_kmac128_update(ha_kmac128_context *ctx, ha_inbuf_t data,
+                                 size_t length);
+
+/**
+ * @brief Finalizes KMAC128 and writes a tag of @p maclen bytes.
+ *
+ * The requested length is part of the MAC input, so tags of different
+ * lengths are unrelated.
+ *
+ * @param ctx Pointer to the KMAC128 context structure.
+ * @param mac Pointer to the output buffer.
+ * @param maclen Tag length in bytes.
+ */
+HA_PUBFUN void ha_kmac128_final(ha_kmac128_context *ctx, ha_digest_t mac,
+                                size_t maclen);
+
+/**
+ * @brief Finalizes KMACXOF128 and reads the first @p outlen bytes.
+ *
+ * Further output is read with ha_cshake128_squeeze().
+ *
+ * @param ctx Pointer to the KMAC128 context structure.
+ * @param out Pointer to the output buffer.
+ * @param outlen Number of output bytes to produce (may be 0).
+ */
+HA_PUBFUN void ha_kmac128_final_xof(ha_kmac128_context *ctx,
+                                    ha_digest_t out, size_t outlen);
+
+/**
+ * @brief Computes a KMAC128 tag in a one-shot operation.
+ *
+ * @param key Pointer to the key.
+ * @param keylen Length of the key in bytes.
+ * @param custom Customization string S.
+ * @param customlen Length of @p custom in bytes.
+ * @param data Pointer to the message.
+ * @param length Length of the message in bytes.
+ * @param mac Pointer to the output buffer.
+ * @param maclen Tag length in bytes.
+ */
+HA_PUBFUN void ha_kmac128_hash(const uint8_t *key, size_t keylen,
+                               const uint8_t *custom, size_t customlen,
+                               ha_inbuf_t data, size_t length,
+                               ha_digest_t mac, size_t maclen);
+
+/**
+ * @brief Initializes a KMAC256 context with a key.
+ * @see ha_kmac128_init()
+ */
+HA_PUBFUN void ha_kmac256_init(ha_kmac256_context *ctx, const uint8_t *key,
+                               size_t keylen, const uint8_t *custom,
+                               size_t customlen);
+
+/**
+ * @brief Absorbs message data into the KMAC256 context.
+ * @see ha_kmac128_update()
+ */
+HA_PUBFUN void ha_kmac256_update(ha_kmac256_context *ctx, ha_inbuf_t data,
+                                 size_t length);
+
+/**
+ * @brief Finalizes KMAC256 and writes a tag of @p maclen bytes.
+ * @see ha_kmac128_final()
+ */
+HA_PUBFUN void ha_kmac256_final(ha_kmac256_context *ctx, ha_digest_t mac,
+                                size_t maclen);
+
+/**
+ * @brief Finalizes KMACXOF256 and reads the first @p outlen bytes.
+ * @see ha_kmac128_final_xof()
+ */
+HA_PUBFUN void ha_kmac256_final_xof(ha_kmac256_context *ctx,
+                                    ha_digest_t out, size_t outlen);
+
+/**
+ * @brief Computes a KMAC256 tag in a one-shot operation.
+ * @see ha_kmac128_hash()
+ */
+HA_PUBFUN void ha_kmac256_hash(const uint8_t *key, size_t keylen,
+                               const uint8_t *custom, size_t customlen,
+                               ha_inbuf_t data, size_t length,
+                               ha_digest_t mac, size_t maclen);
+
+/**
+ * @brief Initializes a TupleHash128 context.
+ *
+ * @param ctx Pointer to the TupleHash128 context structure to initialize.
+ * @param custom Customization string S (may be NULL when @p customlen
+ * is 0).
+ * @param customlen Length of @p custom in bytes.
+ */
+HA_PUBFUN void ha_tuplehash128_init(ha_tuplehash128_context *ctx,
+                                    const uint8_t *custom,
+                                    size_t customlen);
+
+/**
+ * @brief Appends one string to the tuple being hashed.
+ *
+ * Each call adds exactly one element, so ("ab", "c") and ("a", "bc")
+ * hash differently.
+ *
+ * @param ctx Pointer to the TupleHash128 context structure.
+ * @param item Pointer to the element.
+ * @param length Length of the element in bytes.
+ */
+HA_PUBFUN void ha_tuplehash128_update(ha_tuplehash128_context *ctx,
+                                      ha_inbuf_t item, size_t length);
+
+/**
+ * @brief Finalizes TupleHash128 and writes @p digestlen bytes.
+ *
+ * @param ctx Pointer to the TupleHash128 context structure.
+ * @param digest Pointer to the output buffer.
+ * @param digestlen Digest length in bytes.
+ */
+HA_PUBFUN void ha_tuplehash128_final(ha_tuplehash128_context *ctx,
+                                     ha_digest_t digest, size_t digestlen);
+
+/**
+ * @brief Finalizes TupleHashXOF128 and reads the first @p outlen bytes.
+ *
+ * Further output is read with ha_cshake128_squeeze().
+ *
+ * @param ctx Pointer to the TupleHash128 context structure.
+ * @param out Pointer to the output buffer.
+ * @param outlen Number of output bytes to produce (may be 0).
+ */
+HA_PUBFUN void ha_tuplehash128_final_xof(ha_tuplehash128_context *ctx,
+                                         ha_digest_t out, size_t outlen);
+
+/**
+ * @brief Computes TupleHash128 of @p n strings in a one-shot operation.
+ *
+ * @param items Array of @p n pointers to the elements.
+ * @param lens Array of @p n element lengths in bytes.
+ * @param n Number of elements.
+ * @param custom Customization string S.
+ * @param customlen Length of @p custom in bytes.
+ * @param digest Pointer to the output buffer.
+ * @param digestlen Digest length in bytes.
+ */
+HA_PUBFUN void ha_tuplehash128_hash(const uint8_t *const *items,
+                                    const size_t *lens, size_t n,
+                                    const uint8_t *custom,
+                                    size_t customlen, ha_digest_t digest,
+                                    size_t digestlen);
+
+/**
+ * @brief Initializes a TupleHash256 context.
+ * @see ha_tuplehash128_init()
+ */
+HA_PUBFUN void ha_tuplehash256_init(ha_tuplehash256_context *ctx,
+                                    const uint8_t *custom,
+                                    size_t customlen);
+
+/**
+ * @brief Appends one string to the tuple being hashed.
+ * @see ha_tuplehash128_update()
+ */
+HA_PUBFUN void ha_tuplehash256_update(ha_tuplehash256_context *ctx,
+                                      ha_inbuf_t item, size_t length);
+
+/**
+ * @brief Finalizes TupleHash256 and writes @p digestlen bytes.
+ * @see ha_tuplehash128_final()
+ */
+HA_PUBFUN void ha_tuplehash256_final(ha_tuplehash256_context *ctx,
+                                     ha_digest_t digest, size_t digestlen);
+
+/**
+ * @brief Finalizes TupleHashXOF256 and reads the first @p outlen bytes.
+ * @see ha_tuplehash128_final_xof()
+ */
+HA_PUBFUN void ha_tuplehash256_final_xof(ha_tuplehash256_context *ctx,
+                                         ha_digest_t out, size_t outlen);
+
+/**
+ * @brief Computes TupleHash256 of @p n strings in a one-shot operation.
+ * @see ha_tuplehash128_hash()
+ */
+HA_PUBFUN void ha_tuplehash256_hash(const uint8_t *const *items,
+                                    const size_t *lens, size_t n,
+                                    const uint8_t *custom,
+                                    size_t customlen, ha_digest_t digest,
+                                    size_t digestlen);
+
+HA_EXTERN_C_END
+
+#endif  // __HASHA_CSHAKE_H
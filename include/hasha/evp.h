@@ -114,6 +114,11 @@ enum ha_evp_hashty ha_enum_base(uint8_t)
   HA_EVPTY_SHA1,      /**< SHA-1 hash */
   HA_EVPTY_SHA2,      /**< SHA-2 (SHA-224/256/384/512) */
   HA_EVPTY_SHA3,      /**< SHA-3 (standardized version) */
+  HA_EVPTY_SHAKE,     /**< SHAKE128/SHAKE256 XOF (by keccak rate) */
+  HA_EVPTY_BLAKE2BP,  /**< BLAKE2bp (4-way parallel BLAKE2b) */
+  HA_EVPTY_BLAKE2SP,  /**< BLAKE2sp (8-way parallel BLAKE2s) */
+  HA_EVPTY_BLAKE2XB,  /**< BLAKE2Xb (BLAKE2b-based XOF) */
+  HA_EVPTY_BLAKE2XS,  /**< BLAKE2Xs (BLAKE2s-based XOF) */
 };
 
 enum ha_enum_base(int8_t)
@@ -122,6 +127,12 @@ enum ha_enum_base(int8_t)
   HA_EVPTY_SIZE_DYNAMIC = -1,
 };
 
+/**
+ * @def HA_EVP_KEY_MAX_SIZE
+ * @brief The longest key ha_evp_hasher_set_key() takes, in bytes.
+ */
+#define HA_EVP_KEY_MAX_SIZE 64
+
 /**
  * @brief Size of the EVP hasher structure.
  */
@@ -173,6 +184,28 @@ void ha_evp_hasher_set_keccak_custom(struct ha_evp_hasher *hasher,
 HA_PUBFUN
 bool ha_evp_hasher_keccak_custom(struct ha_evp_hasher *hasher);
 
+/**
+ * @brief Sets the key of keyed types (BLAKE2b, BLAKE2s)
+ *
+ * The key is copied and used by every following ha_evp_init() and
+ * ha_evp_hash(); a @p keylen of 0 hashes unkeyed again. Types without a
+ * keyed mode ignore it.
+ *
+ * @param hasher Pointer to the EVP hasher.
+ * @param key Pointer to the key, unused when @p keylen is 0.
+ * @param keylen Length of the key, at most HA_EVP_KEY_MAX_SIZE and the
+ * type's own maximum (HA_BLAKE2S_KEY_SIZE for BLAKE2s).
+ */
+HA_PUBFUN
+void ha_evp_hasher_set_key(struct ha_evp_hasher *hasher, ha_inbuf_t key,
+                           size_t keylen);
+
+/**
+ * @brief Getter for ha_evp_hasher keylen field
+ */
+HA_PUBFUN
+size_t ha_evp_hasher_keylen(struct ha_evp_hasher *hasher);
+
 /**
  * @brief Getter for ha_evp_hasher ctx_size field
  * @return Returns ha_evp_hasher->ctx_size
@@ -327,6 +360,20 @@ HA_PUBFUN void ha_evp_final(struct ha_evp_hasher *hasher,
 HA_PUBFUN void ha_evp_hash(struct ha_evp_hasher *hasher, ha_inbuf_t buf,
                            size_t len, ha_digest_t digest);
 
+/**
+ * @brief Reads more output from an extendable-output hasher.
+ *
+ * After ha_evp_final() has produced the first digestlen bytes, each call
+ * continues the output stream where the previous one stopped. Only XOF
+ * types (HA_EVPTY_SHAKE) support it; other types raise an error.
+ *
+ * @param hasher Pointer to the finalized EVP hasher.
+ * @param out Pointer to the output buffer.
+ * @param len Number of output bytes to produce.
+ */
+HA_PUBFUN void ha_evp_squeeze(struct ha_evp_hasher *hasher,
+                              ha_digest_t out, size_t len);
+
 /**
  * @brief Computes the EVP hash in a init, update, final operation.
  * ( like ha_ada_hash(hash, buf, len, digest, opt digestlen) )
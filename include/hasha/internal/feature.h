@@ -22,4 +22,13 @@
 #define __HA_FEATURE__IO 1
 #endif /* __HA_FEATURE__IO */
 
+/* __HA_FEATURE(THREADS) */
+#ifndef __HA_FEATURE__THREADS
+#if defined(_WIN32) || defined(__TINYC__)
+#define __HA_FEATURE__THREADS 0
+#else
+#define __HA_FEATURE__THREADS 1
+#endif
+#endif /* __HA_FEATURE__THREADS */
+
 #endif
\ No newline at end of file
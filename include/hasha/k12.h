@@ -0,0 +1,132 @@
+/**
+ * @file hasha/k12.h
+ * @brief Header file for the KangarooTwelve tree hash.
+ *
+ * KangarooTwelve (KT128 in RFC 9861) is an extendable-output hash built
+ * on TurboSHAKE128. Inputs of up to 8 KiB are hashed with a single
+ * TurboSHAKE128 call; longer inputs are cut into 8 KiB chunks, every
+ * chunk after the first is reduced to a 32-byte chaining value on its
+ * own, and the first chunk and the chaining values form the final node.
+ * Whole chunks handed to an update call are hashed several at a time by
+ * the multi-state keccak kernels and, given a pool, spread over its
+ * threads; the output does not depend on how the work was split.
+ *
+ * @see https://www.rfc-editor.org/rfc/rfc9861 for further details on
+ * KangarooTwelve.
+ */
+
+#if !defined(__HASHA_K12_H)
+#define __HASHA_K12_H
+
+#include "internal/internal.h"
+#include "keccak.h"
+#include "pool.h"
+
+/**
+ * @def HA_K12_CHUNK_SIZE
+ * @brief The chunk size (in bytes) of KangarooTwelve.
+ */
+#define HA_K12_CHUNK_SIZE 8192
+
+/**
+ * @def HA_K12_DIGEST_SIZE
+ * @brief The conventional KangarooTwelve output size (in bytes).
+ */
+#define HA_K12_DIGEST_SIZE 32
+
+HA_EXTERN_C_BEG
+
+/**
+ * @struct ha_k12_context
+ * @brief The KangarooTwelve context structure.
+ */
+typedef struct ha_k12_context
+{
+  /**
+   * @brief TurboSHAKE128 over the first chunk and the chaining values.
+   */
+  ha_keccak_context node;
+
+  /**
+   * @brief TurboSHAKE128 over the chunk that is being filled piecewise.
+   */
+  ha_keccak_context leaf;
+
+  /**
+   * @brief Bytes absorbed so far, including the customization string
+   * once finalization has begun.
+   */
+  uint64_t          length;
+
+  /**
+   * @brief Pool that hashes the chunks, or NULL for the calling thread.
+   */
+  ha_pool          *pool;
+} ha_k12_context;
+
+/**
+ * @brief Initializes the KangarooTwelve context.
+ *
+ * @param ctx Pointer to the KangarooTwelve context structure to
+ * initialize.
+ * @param pool Pool that hashes the chunks, or NULL to hash them on the
+ * calling thread. It must outlive the context.
+ */
+HA_PUBFUN void ha_k12_init(ha_k12_context *ctx, ha_pool *pool);
+
+/**
+ * @brief Absorbs data into the KangarooTwelve context.
+ *
+ * @param ctx Pointer to the KangarooTwelve context structure.
+ * @param data Pointer to the input data to process.
+ * @param length Length of the input data in bytes.
+ */
+HA_PUBFUN void ha_k12_update(ha_k12_context *ctx, ha_inbuf_t data,
+                             size_t length);
+
+/**
+ * @brief Finalizes KangarooTwelve and reads the first output bytes.
+ *
+ * Further output is read with ha_k12_squeeze().
+ *
+ * @param ctx Pointer to the KangarooTwelve context structure.
+ * @param custom Customization string C (may be NULL when @p customlen
+ * is 0).
+ * @param customlen Length of @p custom in bytes.
+ * @param digest Pointer to the output buffer.
+ * @param digestlen Number of output bytes to produce (may be 0).
+ */
+HA_PUBFUN void ha_k12_final(ha_k12_context *ctx, const uint8_t *custom,
+                            size_t customlen, ha_digest_t digest,
+                            size_t digestlen);
+
+/**
+ * @brief Reads the next bytes of the KangarooTwelve output stream.
+ *
+ * @param ctx Pointer to a finalized KangarooTwelve context structure.
+ * @param out Pointer to the output buffer.
+ * @param length Number of output bytes to produce.
+ */
+HA_PUBFUN void ha_k12_squeeze(ha_k12_context *ctx, ha_digest_t out,
+                              size_t length);
+
+/**
+ * @brief Computes @p digestlen bytes of KangarooTwelve output in a
+ * one-shot operation.
+ *
+ * @param data Pointer to the input data to process.
+ * @param length Length of the input data in bytes.
+ * @param custom Customization string C.
+ * @param customlen Length of @p custom in bytes.
+ * @param pool Pool that hashes the chunks, or NULL.
+ * @param digest Pointer to the output buffer.
+ * @param digestlen Number of output bytes to produce.
+ */
+HA_PUBFUN void ha_k12_hash(ha_inbuf_t data, size_t length,
+                           const uint8_t *custom, size_t customlen,
+                           ha_pool *pool, ha_digest_t digest,
+                           size_t digestlen);
+
+HA_EXTERN_C_END
+
+#endif  // __HASHA_K12_H
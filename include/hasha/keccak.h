@@ -71,6 +71,8 @@ enum ha_pb ha_enum_base(uint8_t)
 {
   HA_PB_KECCAK = 0x01,
   HA_PB_SHA3   = 0x06,
+  HA_PB_SHAKE  = 0x1f,
+  HA_PB_CSHAKE = 0x04,
 };
 
 HA_EXTERN_C_BEG
@@ -88,10 +90,10 @@ typedef struct ha_keccak_context
   /**
    * @brief The Keccak state array.
    *
-   * This array holds the internal state of the Keccak hash function (200
-   * bytes).
+   * This array holds the internal state of the Keccak hash function, 25
+   * 64-bit lanes (200 bytes) in native byte order.
    */
-  uint8_t state[200];
+  uint64_t state[25];
 
   /**
    * @brief The rate (number of bits processed per round).
@@ -124,6 +126,14 @@ typedef struct ha_keccak_context
    * in the current round.
    */
   size_t  squeeze_index;
+
+  /**
+   * @brief The number of keccak-p[1600] rounds per permutation.
+   *
+   * 24 (the full keccak-f[1600]) for every function except the
+   * TurboSHAKE family, which uses 12.
+   */
+  unsigned rounds;
 } ha_keccak_context;
 
 /**
@@ -281,6 +291,24 @@ HA_PUBFUN void ha_keccak_256_final(ha_keccak_256_context *ctx,
 HA_PUBFUN void ha_keccak_256_hash(ha_inbuf_t data, size_t length,
                                   ha_digest_t digest);
 
+/**
+ * @brief Computes the Keccak-256 hashes of several messages.
+ *
+ * Four messages are absorbed at once, one per SIMD lane of the
+ * keccak-f[1600] permutation, where the CPU has AVX2, which suits
+ * batches of short keys. The result is identical to calling
+ * ha_keccak_256_hash() on each message.
+ *
+ * @param bufs Array of @p n pointers to the input messages.
+ * @param lens Array of @p n message lengths in bytes.
+ * @param n Number of messages.
+ * @param digests Output buffer for @p n consecutive digests (32 bytes
+ * each).
+ */
+HA_PUBFUN void ha_keccak_256_hash_many(const uint8_t *const *bufs,
+                                       const size_t *lens, size_t n,
+                                       uint8_t *digests);
+
 /**
  * @brief Initializes the Keccak-384 context.
  *
@@ -49,20 +49,43 @@ HA_EXTERN_C_BEG
  */
 HA_PUBFUN void ha_keccakf1600(uint64_t *state);
 
+/**
+ * @brief Performs the Keccak-f[1600] permutation on four states.
+ *
+ * The four independent states are permuted side by side, one per 64-bit
+ * lane of an AVX2 register, where the CPU allows it, and one after
+ * another otherwise. Each state is updated in place exactly as
+ * ha_keccakf1600() would.
+ *
+ * @param states Pointers to the four 25-word states.
+ */
+HA_PUBFUN void ha_keccakf1600_x4(uint64_t *states[4]);
+
 /**
  * @brief Returns the implementation ID of the Keccak-f[1600] function.
  *
- * This function returns a unique implementation identifier for the
- * Keccakf1600 permutation used in the library. The ID can be used to
- * identify which version or variant of the Keccakf1600 function is being
- * utilized.
+ * The permutation kernel is picked once per process from the kernels
+ * the CPU supports: 0 (scalar), 1 (lane-complementing scalar) or 2
+ * (scalar with BMI1/BMI2). The environment variable
+ * HASHA_KECCAKF1600_IMPL, set to a kernel name or ID, overrides the
+ * choice when the CPU can run the named kernel.
  *
- * @return The implementation ID for the Keccakf1600 function.
- *         This ID can be used for debugging, performance tracking, or
- * identifying specific optimizations used in the implementation.
+ * 3 (AVX-512) is never picked on its own: on a single state it runs
+ * level with 2, not faster, so it gives SHA-3 no speedup. It is an
+ * opt-in, used only when HASHA_KECCAKF1600_IMPL names it.
+ *
+ * @return The implementation ID of the kernel in use.
  */
 HA_PUBFUN int  ha_keccakf1600_implid(void);
 
+/**
+ * @brief Returns the name of the Keccak-f[1600] kernel in use.
+ *
+ * @return A static string such as "scalar" or "lanecomp", also accepted
+ * by the HASHA_KECCAKF1600_IMPL environment variable.
+ */
+HA_PUBFUN const char *ha_keccakf1600_implname(void);
+
 HA_EXTERN_C_END
 
 #endif  // __HASHA_KECCAKF1600_H
@@ -101,6 +101,25 @@ HA_PUBFUN void ha_md5_final(ha_md5_context *ctx, ha_digest_t digest);
 HA_PUBFUN void ha_md5_hash(ha_inbuf_t data, size_t len,
                            ha_digest_t digest);
 
+/**
+ * @brief Computes the MD5 hashes of several messages.
+ *
+ * MD5 is serial within a message, so the messages are hashed side by
+ * side in SIMD lanes where the CPU allows it (8 or 16 at a time); a
+ * lane that finishes early is refilled with the next message, so
+ * lengths may differ freely. The result is identical to calling
+ * ha_md5_hash() on each message.
+ *
+ * @param bufs Array of @p n pointers to the input messages.
+ * @param lens Array of @p n message lengths in bytes.
+ * @param n Number of messages.
+ * @param digests Output buffer for @p n consecutive digests (16 bytes
+ * each).
+ */
+HA_PUBFUN void ha_md5_hash_many(const uint8_t *const *bufs,
+                                const size_t *lens, size_t n,
+                                uint8_t *digests);
+
 HA_EXTERN_C_END
 
 #endif  // __HASHA_MD5_H
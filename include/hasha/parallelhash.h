@@ -0,0 +1,211 @@
+/**
+ * @file hasha/parallelhash.h
+ * @brief Header file for the ParallelHash functions of SP 800-185.
+ *
+ * ParallelHash128/256 cut the input into blocks of a fixed size, hash
+ * every block on its own with SHAKE128/256 and hash the resulting
+ * chaining values, in order, with cSHAKE. The blocks are independent, so
+ * whole blocks handed to an update call are hashed several at a time by
+ * the multi-state keccak kernels and, given a pool, spread over its
+ * threads. The digest does not depend on how the work was split.
+ *
+ * @see https://doi.org/10.6028/NIST.SP.800-185 for further details on
+ * ParallelHash.
+ */
+
+#if !defined(__HASHA_PARALLELHASH_H)
+#define __HASHA_PARALLELHASH_H
+
+#include "cshake.h"
+#include "internal/internal.h"
+#include "keccak.h"
+#include "pool.h"
+
+/**
+ * @def HA_PARALLELHASH_BLOCKSIZE
+ * @brief The block size (in bytes) used when 0 is passed to the init and
+ * hash functions.
+ */
+#define HA_PARALLELHASH_BLOCKSIZE 8192
+
+HA_EXTERN_C_BEG
+
+/**
+ * @struct ha_parallelhash_context
+ * @brief The context structure used by both ParallelHash variants.
+ */
+typedef struct ha_parallelhash_context
+{
+  /**
+   * @brief cSHAKE over the encoded block size and the chaining values.
+   */
+  ha_cshake_context outer;
+
+  /**
+   * @brief SHAKE over the block that is being filled piecewise.
+   */
+  ha_keccak_context leaf;
+
+  /**
+   * @brief The block size B in bytes.
+   */
+  size_t            blocksize;
+
+  /**
+   * @brief Bytes absorbed into @ref leaf so far.
+   */
+  size_t            leaf_length;
+
+  /**
+   * @brief Number of blocks whose chaining value has been absorbed.
+   */
+  uint64_t          nblocks;
+
+  /**
+   * @brief Pool that hashes the blocks, or NULL for the calling thread.
+   */
+  ha_pool          *pool;
+} ha_parallelhash_context;
+
+typedef ha_parallelhash_context ha_parallelhash128_context,
+    ha_parallelhash256_context;
+
+/**
+ * @brief Initializes a ParallelHash128 context.
+ *
+ * @param ctx Pointer to the ParallelHash128 context structure to
+ * initialize.
+ * @param blocksize Block size B in bytes, 0 for
+ * HA_PARALLELHASH_BLOCKSIZE.
+ * @param custom Customization string S (may be NULL when @p customlen
+ * is 0).
+ * @param customlen Length of @p custom in bytes.
+ * @param pool Pool that hashes the blocks, or NULL to hash them on the
+ * calling thread. It must outlive the context.
+ */
+HA_PUBFUN void ha_parallelhash128_init(ha_parallelhash128_context *ctx,
+                                       size_t blocksize,
+                                       const uint8_t *custom,
+                                       size_t customlen, ha_pool *pool);
+
+/**
+ * @brief Absorbs data into the ParallelHash128 context.
+ *
+ * Whole blocks in @p data are hashed in batches; large updates are
+ * therefore what the pool speeds up.
+ *
+ * @param ctx Pointer to the ParallelHash128 context structure.
+ * @param data Pointer to the input data to process.
+ * @param length Length of the input data in bytes.
+ */
+HA_PUBFUN void ha_parallelhash128_update(ha_parallelhash128_context *ctx,
+                                         ha_inbuf_t data, size_t length);
+
+/**
+ * @brief Finalizes ParallelHash128 and writes @p digestlen bytes.
+ *
+ * @param ctx Pointer to the ParallelHash128 context structure.
+ * @param digest Pointer to the output buffer.
+ * @param digestlen Digest length in bytes.
+ */
+HA_PUBFUN void ha_parallelhash128_final(ha_parallelhash128_context *ctx,
+                                        ha_digest_t digest,
+                                        size_t digestlen);
+
+/**
+ * @brief Finalizes ParallelHashXOF128 and reads the first @p outlen
+ * bytes.
+ *
+ * Further output is read with ha_parallelhash128_squeeze().
+ *
+ * @param ctx Pointer to the ParallelHash128 context structure.
+ * @param out Pointer to the output buffer.
+ * @param outlen Number of output bytes to produce (may be 0).
+ */
+HA_PUBFUN void ha_parallelhash128_final_xof(
+    ha_parallelhash128_context *ctx, ha_digest_t out, size_t outlen);
+
+/**
+ * @brief Reads the next bytes of the ParallelHashXOF128 output stream.
+ *
+ * @param ctx Pointer to a context finalized with
+ * ha_parallelhash128_final_xof().
+ * @param out Pointer to the output buffer.
+ * @param length Number of output bytes to produce.
+ */
+HA_PUBFUN void ha_parallelhash128_squeeze(ha_parallelhash128_context *ctx,
+                                          ha_digest_t out, size_t length);
+
+/**
+ * @brief Computes ParallelHash128 in a one-shot operation.
+ *
+ * @param data Pointer to the input data to process.
+ * @param length Length of the input data in bytes.
+ * @param blocksize Block size B in bytes, 0 for
+ * HA_PARALLELHASH_BLOCKSIZE.
+ * @param custom Customization string S.
+ * @param customlen Length of @p custom in bytes.
+ * @param pool Pool that hashes the blocks, or NULL.
+ * @param digest Pointer to the output buffer.
+ * @param digestlen Digest length in bytes.
+ */
+HA_PUBFUN void ha_parallelhash128_hash(ha_inbuf_t data, size_t length,
+                                       size_t blocksize,
+                                       const uint8_t *custom,
+                                       size_t customlen, ha_pool *pool,
+                                       ha_digest_t digest,
+                                       size_t digestlen);
+
+/**
+ * @brief Initializes a ParallelHash256 context.
+ * @see ha_parallelhash128_init()
+ */
+HA_PUBFUN void ha_parallelhash256_init(ha_parallelhash256_context *ctx,
+                                       size_t blocksize,
+                                       const uint8_t *custom,
+                                       size_t customlen, ha_pool *pool);
+
+/**
+ * @brief Absorbs data into the ParallelHash256 context.
+ * @see ha_parallelhash128_update()
+ */
+HA_PUBFUN void ha_parallelhash256_update(ha_parallelhash256_context *ctx,
+                                         ha_inbuf_t data, size_t length);
+
+/**
+ * @brief Finalizes ParallelHash256 and writes @p digestlen bytes.
+ * @see ha_parallelhash128_final()
+ */
+HA_PUBFUN void ha_parallelhash256_final(ha_parallelhash256_context *ctx,
+                                        ha_digest_t digest,
+                                        size_t digestlen);
+
+/**
+ * @brief Finalizes ParallelHashXOF256 and reads the first @p outlen
+ * bytes.
+ * @see ha_parallelhash128_final_xof()
+ */
+HA_PUBFUN void ha_parallelhash256_final_xof(
+    ha_parallelhash256_context *ctx, ha_digest_t out, size_t outlen);
+
+/**
+ * @brief Reads the next bytes of the ParallelHashXOF256 output stream.
+ * @see ha_parallelhash128_squeeze()
+ */
+HA_PUBFUN void ha_parallelhash256_squeeze(ha_parallelhash256_context *ctx,
+                                          ha_digest_t out, size_t length);
+
+/**
+ * @brief Computes ParallelHash256 in a one-shot operation.
+ * @see ha_parallelhash128_hash()
+ */
+HA_PUBFUN void ha_parallelhash256_hash(ha_inbuf_t data, size_t length,
+                                       size_t blocksize,
+                                       const uint8_t *custom,
+                                       size_t customlen, ha_pool *pool,
+                                       ha_digest_t digest,
+                                       size_t digestlen);
+
+HA_EXTERN_C_END
+
+#endif  // __HASHA_PARALLELHASH_H
@@ -0,0 +1,54 @@
+/**
+ * @file hasha/pool.h
+ * @brief Header file for the worker thread pool.
+ *
+ * The tree and parallel hashes (ParallelHash, ...) can spread their
+ * independent leaves over several threads. They take a pool created
+ * here; passing NULL instead hashes everything on the calling thread.
+ * A pool may be shared by any number of contexts, but runs the work of
+ * one call at a time.
+ */
+
+#if !defined(__HASHA_POOL_H)
+#define __HASHA_POOL_H
+
+#include "internal/internal.h"
+
+HA_EXTERN_C_BEG
+
+/**
+ * @struct ha_pool
+ * @brief An opaque pool of worker threads.
+ */
+typedef struct ha_pool ha_pool;
+
+/**
+ * @brief Creates a pool of worker threads.
+ *
+ * The calling thread takes part in the work, so a pool of @p nthreads
+ * starts @p nthreads - 1 workers. Without thread support the pool
+ * runs everything on the calling thread.
+ *
+ * @param nthreads Number of threads, or 0 for one per online CPU.
+ * @return The new pool, or NULL if it could not be created.
+ */
+HA_PUBFUN ha_pool *ha_pool_create(size_t nthreads);
+
+/**
+ * @brief Stops the workers and frees the pool.
+ *
+ * @param pool The pool to destroy, may be NULL.
+ */
+HA_PUBFUN void ha_pool_destroy(ha_pool *pool);
+
+/**
+ * @brief Returns the number of threads that run the pool's work.
+ *
+ * @param pool The pool, may be NULL.
+ * @return The thread count including the caller, 1 for a NULL pool.
+ */
+HA_PUBFUN size_t ha_pool_size(const ha_pool *pool);
+
+HA_EXTERN_C_END
+
+#endif  // __HASHA_POOL_H
@@ -283,6 +283,24 @@ HA_PUBFUN void ha_sha2_224_final(ha_sha2_224_context *ctx,
 HA_PUBFUN void ha_sha2_224_hash(ha_inbuf_t data, size_t length,
                                 ha_digest_t digest);
 
+/**
+ * @brief Computes the SHA-2 224-bit hashes of several messages.
+ *
+ * The messages are hashed side by side in SIMD lanes where the CPU
+ * allows it (4, 8 or 16 at a time); a lane that finishes early is
+ * refilled with the next message, so lengths may differ freely. The
+ * result is identical to calling ha_sha2_224_hash() on each message.
+ *
+ * @param bufs Array of @p n pointers to the input messages.
+ * @param lens Array of @p n message lengths in bytes.
+ * @param n Number of messages.
+ * @param digests Output buffer for @p n consecutive digests (28 bytes
+ * each).
+ */
+HA_PUBFUN void ha_sha2_224_hash_many(const uint8_t *const *bufs,
+                                     const size_t *lens, size_t n,
+                                     uint8_t *digests);
+
 /**
  * @brief Transforms the data in the SHA-2 256-bit context.
  *
@@ -296,6 +314,21 @@ HA_PUBFUN void ha_sha2_224_hash(ha_inbuf_t data, size_t length,
 HA_PUBFUN void ha_sha2_256_transform(ha_sha2_256_context *ctx,
                                      ha_inbuf_t           data);
 
+/**
+ * @brief Transforms consecutive data blocks in the SHA-2 256-bit context.
+ *
+ * Equivalent to calling ha_sha2_256_transform() on each of the @p nblocks
+ * blocks in turn, but the blocks are read in place with a single call
+ * into the compression function. The message length is not updated.
+ *
+ * @param ctx Pointer to the SHA-2 256-bit context structure.
+ * @param data Pointer to @p nblocks input blocks (64 bytes each).
+ * @param nblocks Number of blocks to process.
+ */
+HA_PUBFUN void ha_sha2_256_transform_blocks(ha_sha2_256_context *ctx,
+                                            ha_inbuf_t data,
+                                            size_t     nblocks);
+
 /**
  * @brief Initializes the SHA-2 256-bit context.
  *
@@ -348,6 +381,24 @@ HA_PUBFUN void ha_sha2_256_final(ha_sha2_256_context *ctx,
 HA_PUBFUN void ha_sha2_256_hash(ha_inbuf_t data, size_t length,
                                 ha_digest_t digest);
 
+/**
+ * @brief Computes the SHA-2 256-bit hashes of several messages.
+ *
+ * The messages are hashed side by side in SIMD lanes where the CPU
+ * allows it (4, 8 or 16 at a time); a lane that finishes early is
+ * refilled with the next message, so lengths may differ freely. The
+ * result is identical to calling ha_sha2_256_hash() on each message.
+ *
+ * @param bufs Array of @p n pointers to the input messages.
+ * @param lens Array of @p n message lengths in bytes.
+ * @param n Number of messages.
+ * @param digests Output buffer for @p n consecutive digests (32 bytes
+ * each).
+ */
+HA_PUBFUN void ha_sha2_256_hash_many(const uint8_t *const *bufs,
+                                     const size_t *lens, size_t n,
+                                     uint8_t *digests);
+
 /**
  * @brief Transforms the data in the SHA-2 384-bit context.
  *
@@ -413,6 +464,25 @@ HA_PUBFUN void ha_sha2_384_final(ha_sha2_384_context *ctx,
 HA_PUBFUN void ha_sha2_384_hash(ha_inbuf_t data, size_t length,
                                 ha_digest_t digest);
 
+/**
+ * @brief Computes the SHA-2 384-bit hashes of several messages.
+ *
+ * The messages are hashed side by side in 64-bit SIMD lanes where the
+ * CPU allows it (4 with AVX2, 8 with AVX-512); a lane that finishes
+ * early is refilled with the next message, so lengths may differ
+ * freely. The result is identical to calling ha_sha2_384_hash() on each
+ * message.
+ *
+ * @param bufs Array of @p n pointers to the input messages.
+ * @param lens Array of @p n message lengths in bytes.
+ * @param n Number of messages.
+ * @param digests Output buffer for @p n consecutive digests (48 bytes
+ * each).
+ */
+HA_PUBFUN void ha_sha2_384_hash_many(const uint8_t *const *bufs,
+                                     const size_t *lens, size_t n,
+                                     uint8_t *digests);
+
 /**
  * @brief Transforms the data in the SHA-2 512-bit context.
  *
@@ -426,6 +496,21 @@ HA_PUBFUN void ha_sha2_384_hash(ha_inbuf_t data, size_t length,
 HA_PUBFUN void ha_sha2_512_transform(ha_sha2_512_context *ctx,
                                      ha_inbuf_t           data);
 
+/**
+ * @brief Transforms consecutive data blocks in the SHA-2 512-bit context.
+ *
+ * Equivalent to calling ha_sha2_512_transform() on each of the @p nblocks
+ * blocks in turn, but the blocks are read in place with a single call
+ * into the compression function. The message length is not updated.
+ *
+ * @param ctx Pointer to the SHA-2 512-bit context structure.
+ * @param data Pointer to @p nblocks input blocks (128 bytes each).
+ * @param nblocks Number of blocks to process.
+ */
+HA_PUBFUN void ha_sha2_512_transform_blocks(ha_sha2_512_context *ctx,
+                                            ha_inbuf_t data,
+                                            size_t     nblocks);
+
 /**
  * @brief Initializes the SHA-2 512-bit context.
  *
@@ -478,6 +563,25 @@ HA_PUBFUN void ha_sha2_512_final(ha_sha2_512_context *ctx,
 HA_PUBFUN void ha_sha2_512_hash(ha_inbuf_t data, size_t length,
                                 ha_digest_t digest);
 
+/**
+ * @brief Computes the SHA-2 512-bit hashes of several messages.
+ *
+ * The messages are hashed side by side in 64-bit SIMD lanes where the
+ * CPU allows it (4 with AVX2, 8 with AVX-512); a lane that finishes
+ * early is refilled with the next message, so lengths may differ
+ * freely. The result is identical to calling ha_sha2_512_hash() on each
+ * message.
+ *
+ * @param bufs Array of @p n pointers to the input messages.
+ * @param lens Array of @p n message lengths in bytes.
+ * @param n Number of messages.
+ * @param digests Output buffer for @p n consecutive digests (64 bytes
+ * each).
+ */
+HA_PUBFUN void ha_sha2_512_hash_many(const uint8_t *const *bufs,
+                                     const size_t *lens, size_t n,
+                                     uint8_t *digests);
+
 /**
  * @brief Transforms the data in the SHA-2 512-224-bit context.
  *
@@ -544,6 +648,25 @@ HA_PUBFUN void ha_sha2_512_224_final(ha_sha2_512_224_context *ctx,
 HA_PUBFUN void ha_sha2_512_224_hash(ha_inbuf_t data, size_t length,
                                     ha_digest_t digest);
 
+/**
+ * @brief Computes the SHA-2 512-224-bit hashes of several messages.
+ *
+ * The messages are hashed side by side in 64-bit SIMD lanes where the
+ * CPU allows it (4 with AVX2, 8 with AVX-512); a lane that finishes
+ * early is refilled with the next message, so lengths may differ
+ * freely. The result is identical to calling ha_sha2_512_224_hash() on
+ * each message.
+ *
+ * @param bufs Array of @p n pointers to the input messages.
+ * @param lens Array of @p n message lengths in bytes.
+ * @param n Number of messages.
+ * @param digests Output buffer for @p n consecutive digests (28 bytes
+ * each).
+ */
+HA_PUBFUN void ha_sha2_512_224_hash_many(const uint8_t *const *bufs,
+                                         const size_t *lens, size_t n,
+                                         uint8_t *digests);
+
 /**
  * @brief Transforms the data in the SHA-2 512-256-bit context.
  *
@@ -610,6 +733,25 @@ HA_PUBFUN void ha_sha2_512_256_final(ha_sha2_512_256_context *ctx,
 HA_PUBFUN void ha_sha2_512_256_hash(ha_inbuf_t data, size_t length,
                                     ha_digest_t digest);
 
+/**
+ * @brief Computes the SHA-2 512-256-bit hashes of several messages.
+ *
+ * The messages are hashed side by side in 64-bit SIMD lanes where the
+ * CPU allows it (4 with AVX2, 8 with AVX-512); a lane that finishes
+ * early is refilled with the next message, so lengths may differ
+ * freely. The result is identical to calling ha_sha2_512_256_hash() on
+ * each message.
+ *
+ * @param bufs Array of @p n pointers to the input messages.
+ * @param lens Array of @p n message lengths in bytes.
+ * @param n Number of messages.
+ * @param digests Output buffer for @p n consecutive digests (32 bytes
+ * each).
+ */
+HA_PUBFUN void ha_sha2_512_256_hash_many(const uint8_t *const *bufs,
+                                         const size_t *lens, size_t n,
+                                         uint8_t *digests);
+
 HA_EXTERN_C_END
 
 #endif  // __HASHA_SHA2_H
@@ -165,6 +165,25 @@ HA_PUBFUN void ha_sha3_256_final(ha_sha3_256_context *ctx,
 HA_PUBFUN void ha_sha3_256_hash(ha_inbuf_t data, size_t length,
                                 ha_digest_t digest);
 
+/**
+ * @brief Computes the SHA3-256 hashes of several messages.
+ *
+ * Four messages are absorbed at once, one per SIMD lane of the
+ * keccak-f[1600] permutation, where the CPU has AVX2; a lane that
+ * finishes early is refilled with the next message, so lengths may
+ * differ freely. The result is identical to calling ha_sha3_256_hash()
+ * on each message.
+ *
+ * @param bufs Array of @p n pointers to the input messages.
+ * @param lens Array of @p n message lengths in bytes.
+ * @param n Number of messages.
+ * @param digests Output buffer for @p n consecutive digests (32 bytes
+ * each).
+ */
+HA_PUBFUN void ha_sha3_256_hash_many(const uint8_t *const *bufs,
+                                     const size_t *lens, size_t n,
+                                     uint8_t *digests);
+
 /**
  * @brief Initializes the SHA3-384 context.
  *
@@ -0,0 +1,166 @@
+/**
+ * @file hasha/shake.h
+ * @brief Header file for the SHAKE extendable-output functions.
+ *
+ * This header file defines the interface for SHAKE128 and SHAKE256, the
+ * extendable-output functions (XOFs) of FIPS 202. Unlike the SHA3 hashes
+ * they produce output of any length: after finalization the sponge can
+ * be squeezed repeatedly, each call continuing the same output stream
+ * where the previous one stopped.
+ *
+ * The SHAKE functions share the Keccak sponge (see keccak.h) with SHA3
+ * and differ from it only in the rate and the domain padding.
+ *
+ * @see https://nvlpubs.nist.gov/nistpubs/FIPS/NIST.FIPS.202.pdf for
+ * further details on the SHAKE functions.
+ */
+
+#if !defined(__HASHA_SHAKE_H)
+#define __HASHA_SHAKE_H
+
+#include "internal/internal.h"
+
+/**
+ * @def HA_SHAKE128_RATE
+ * @brief The rate (in bytes) of SHAKE128, also the keccak rate that
+ * selects SHAKE128 for HA_EVPTY_SHAKE hashers.
+ */
+#define HA_SHAKE128_RATE 168
+
+/**
+ * @def HA_SHAKE256_RATE
+ * @brief The rate (in bytes) of SHAKE256.
+ */
+#define HA_SHAKE256_RATE 136
+
+HA_EXTERN_C_BEG
+
+/**
+ * @struct ha_shake_context
+ * @brief The context structure used by both SHAKE variants.
+ *
+ * This structure holds the sponge state, rate, capacity, and the absorb
+ * and squeeze positions, so a finalized context keeps track of how much
+ * output has been read.
+ */
+typedef struct ha_keccak_context ha_shake_context;
+
+typedef ha_shake_context ha_shake128_context, ha_shake256_context;
+
+/**
+ * @brief Initializes the SHAKE128 context.
+ *
+ * @param ctx Pointer to the SHAKE128 context structure to initialize.
+ */
+HA_PUBFUN void ha_shake128_init(ha_shake128_context *ctx);
+
+/**
+ * @brief Absorbs data into the SHAKE128 context.
+ *
+ * @param ctx Pointer to the SHAKE128 context structure.
+ * @param data Pointer to the input data to process.
+ * @param length Length of the input data in bytes.
+ */
+HA_PUBFUN void ha_shake128_update(ha_shake128_context *ctx,
+                                  ha_inbuf_t data, size_t length);
+
+/**
+ * @brief Finalizes the SHAKE128 input and reads the first output bytes.
+ *
+ * No data may be absorbed afterwards. Further output is read with
+ * ha_shake128_squeeze(); @p digestlen may be 0 to read everything that
+ * way.
+ *
+ * @param ctx Pointer to the SHAKE128 context structure.
+ * @param digest Pointer to the output buffer.
+ * @param digestlen Number of output bytes to produce.
+ */
+HA_PUBFUN void ha_shake128_final(ha_shake128_context *ctx,
+                                 ha_digest_t digest, size_t digestlen);
+
+/**
+ * @brief Reads the next bytes of the SHAKE128 output stream.
+ *
+ * Continues the output of a finalized context where the previous
+ * ha_shake128_final() or ha_shake128_squeeze() call stopped, so reading
+ * the output in pieces yields the same bytes as reading it at once.
+ *
+ * @param ctx Pointer to a finalized SHAKE128 context structure.
+ * @param out Pointer to the output buffer.
+ * @param length Number of output bytes to produce.
+ */
+HA_PUBFUN void ha_shake128_squeeze(ha_shake128_context *ctx,
+                                   ha_digest_t out, size_t length);
+
+/**
+ * @brief Computes @p digestlen bytes of SHAKE128 output in a one-shot
+ * operation.
+ *
+ * @param data Pointer to the input data to process.
+ * @param length Length of the input data in bytes.
+ * @param digest Pointer to the output buffer.
+ * @param digestlen Number of output bytes to produce.
+ */
+HA_PUBFUN void ha_shake128_hash(ha_inbuf_t data, size_t length,
+                                ha_digest_t digest, size_t digestlen);
+
+/**
+ * @brief Initializes the SHAKE256 context.
+ *
+ * @param ctx Pointer to the SHAKE256 context structure to initialize.
+ */
+HA_PUBFUN void ha_shake256_init(ha_shake256_context *ctx);
+
+/**
+ * @brief Absorbs data into the SHAKE256 context.
+ *
+ * @param ctx Pointer to the SHAKE256 context structure.
+ * @param data Pointer to the input data to process.
+ * @param length Length of the input data in bytes.
+ */
+HA_PUBFUN void ha_shake256_update(ha_shake256_context *ctx,
+                                  ha_inbuf_t data, size_t length);
+
+/**
+ * @brief Finalizes the SHAKE256 input and reads the first output bytes.
+ *
+ * No data may be absorbed afterwards. Further output is read with
+ * ha_shake256_squeeze(); @p digestlen may be 0 to read everything that
+ * way.
+ *
+ * @param ctx Pointer to the SHAKE256 context structure.
+ * @param digest Pointer to the output buffer.
+ * @param digestlen Number of output bytes to produce.
+ */
+HA_PUBFUN void ha_shake256_final(ha_shake256_context *ctx,
+                                 ha_digest_t digest, size_t digestlen);
+
+/**
+ * @brief Reads the next bytes of the SHAKE256 output stream.
+ *
+ * Continues the output of a finalized context where the previous
+ * ha_shake256_final() or ha_shake256_squeeze() call stopped, so reading
+ * the output in pieces yields the same bytes as reading it at once.
+ *
+ * @param ctx Pointer to a finalized SHAKE256 context structure.
+ * @param out Pointer to the output buffer.
+ * @param length Number of output bytes to produce.
+ */
+HA_PUBFUN void ha_shake256_squeeze(ha_shake256_context *ctx,
+                                   ha_digest_t out, size_t length);
+
+/**
+ * @brief Computes @p digestlen bytes of SHAKE256 output in a one-shot
+ * operation.
+ *
+ * @param data Pointer to the input data to process.
+ * @param length Length of the input data in bytes.
+ * @param digest Pointer to the output buffer.
+ * @param digestlen Number of output bytes to produce.
+ */
+HA_PUBFUN void ha_shake256_hash(ha_inbuf_t data, size_t length,
+                                ha_digest_t digest, size_t digestlen);
+
+HA_EXTERN_C_END
+
+#endif  // __HASHA_SHAKE_H
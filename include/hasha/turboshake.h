@@ -0,0 +1,150 @@
+/**
+ * @file hasha/turboshake.h
+ * @brief Header file for the TurboSHAKE extendable-output functions.
+ *
+ * This header file defines the interface for TurboSHAKE128 and
+ * TurboSHAKE256 (RFC 9861): SHAKE128/256 with the keccak permutation cut
+ * down to its last 12 rounds and a caller-chosen domain separation byte
+ * in place of the fixed SHAKE padding. With half the rounds they process
+ * about twice as many bytes per second as SHAKE.
+ *
+ * @see https://www.rfc-editor.org/rfc/rfc9861 for further details on
+ * TurboSHAKE.
+ */
+
+#if !defined(__HASHA_TURBOSHAKE_H)
+#define __HASHA_TURBOSHAKE_H
+
+#include "internal/internal.h"
+#include "keccak.h"
+#include "shake.h"
+
+/**
+ * @def HA_TURBOSHAKE_DOMAIN
+ * @brief The default domain separation byte of TurboSHAKE.
+ */
+#define HA_TURBOSHAKE_DOMAIN 0x1f
+
+HA_EXTERN_C_BEG
+
+/**
+ * @struct ha_turboshake_context
+ * @brief The context structure used by both TurboSHAKE variants.
+ */
+typedef struct ha_turboshake_context
+{
+  /**
+   * @brief The 12-round sponge.
+   */
+  ha_keccak_context sponge;
+
+  /**
+   * @brief The domain separation byte D (0x01 to 0x7f).
+   */
+  uint8_t           domain;
+} ha_turboshake_context;
+
+typedef ha_turboshake_context ha_turboshake128_context,
+    ha_turboshake256_context;
+
+/**
+ * @brief Initializes the TurboSHAKE128 context.
+ *
+ * @param ctx Pointer to the TurboSHAKE128 context structure to
+ * initialize.
+ * @param domain Domain separation byte D in the range 0x01 to 0x7f,
+ * usually HA_TURBOSHAKE_DOMAIN.
+ */
+HA_PUBFUN void ha_turboshake128_init(ha_turboshake128_context *ctx,
+                                     uint8_t domain);
+
+/**
+ * @brief Absorbs data into the TurboSHAKE128 context.
+ *
+ * @param ctx Pointer to the TurboSHAKE128 context structure.
+ * @param data Pointer to the input data to process.
+ * @param length Length of the input data in bytes.
+ */
+HA_PUBFUN void ha_turboshake128_update(ha_turboshake128_context *ctx,
+                                       ha_inbuf_t data, size_t length);
+
+/**
+ * @brief Finalizes the TurboSHAKE128 input and reads the first output
+ * bytes.
+ *
+ * Further output is read with ha_turboshake128_squeeze().
+ *
+ * @param ctx Pointer to the TurboSHAKE128 context structure.
+ * @param digest Pointer to the output buffer.
+ * @param digestlen Number of output bytes to produce (may be 0).
+ */
+HA_PUBFUN void ha_turboshake128_final(ha_turboshake128_context *ctx,
+                                      ha_digest_t digest,
+                                      size_t digestlen);
+
+/**
+ * @brief Reads the next bytes of the TurboSHAKE128 output stream.
+ *
+ * @param ctx Pointer to a finalized TurboSHAKE128 context structure.
+ * @param out Pointer to the output buffer.
+ * @param length Number of output bytes to produce.
+ */
+HA_PUBFUN void ha_turboshake128_squeeze(ha_turboshake128_context *ctx,
+                                        ha_digest_t out, size_t length);
+
+/**
+ * @brief Computes @p digestlen bytes of TurboSHAKE128 output in a
+ * one-shot operation.
+ *
+ * @param data Pointer to the input data to process.
+ * @param length Length of the input data in bytes.
+ * @param domain Domain separation byte D (0x01 to 0x7f).
+ * @param digest Pointer to the output buffer.
+ * @param digestlen Number of output bytes to produce.
+ */
+HA_PUBFUN void ha_turboshake128_hash(ha_inbuf_t data, size_t length,
+                                     uint8_t domain, ha_digest_t digest,
+                                     size_t digestlen);
+
+/**
+ * @brief Initializes the TurboSHAKE256 context.
+ * @see ha_turboshake128_init()
+ */
+HA_PUBFUN void ha_turboshake256_init(ha_turboshake256_context *ctx,
+                                     uint8_t domain);
+
+/**
+ * @brief Absorbs data into the TurboSHAKE256 context.
+ * @see ha_turboshake128_update()
+ */
+HA_PUBFUN void ha_turboshake256_update(ha_turboshake256_context *ctx,
+                                       ha_inbuf_t data, size_t length);
+
+/**
+ * @brief Finalizes the TurboSHAKE256 input and reads the first output
+ * bytes.
+ * @see ha_turboshake128_final()
+ */
+HA_PUBFUN void ha_turboshake256_final(ha_turboshake256_context *ctx,
+                                      ha_digest_t digest,
+                                      size_t digestlen);
+
+/**
+ * @brief Reads the next bytes of the TurboSHAKE256 output stream.
+ * @see ha_turboshake128_squeeze()
+ */
+HA_PUBFUN void ha_turboshake256_squeeze(ha_turboshake256_context *ctx,
+                                        ha_digest_t out, size_t length);
+
+/**
+ * @brief Computes @p digestlen bytes of TurboSHAKE256 output in a
+ * one-shot operation.
+ * @see ha_turboshake128_hash()
+ */
+HA_PUBFUN void ha_turboshake256_hash(ha_inbuf_t data, size_t length,
+                                     uint8_t domain, ha_digest_t digest,
+                                     size_t digestlen);
+
+HA_EXTERN_C_END
+
+#endif  // __HASHA_TURBOSHAKE_H
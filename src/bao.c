@@ -0,0 +1,219 @@
+#define HA_BUILD
+
+#include "../include/hasha/bao.h"
+
+#include "./blake3.h"
+
+/*
+ * The tree is the BLAKE3 one: the left child of a node over n > 1
+ * chunks covers the largest power of two of them below n. In pre-order
+ * the parents of the left child follow the node at once, and those of
+ * the right child start 64 bytes per left chunk after it.
+ *
+ * Encoding recurses down to groups of BAO_GROUP chunks, hashes each
+ * group side by side in SIMD lanes and builds the group's parents from
+ * the chunk chaining values.
+ */
+
+#define BAO_HEADER_SIZE 8
+#define BAO_NODE_SIZE   64
+#define BAO_GROUP       64
+
+HA_PRVFUN uint64_t
+bao_chunks (uint64_t size)
+{
+  return size ? (size + BLAKE3_CHUNK_LEN - 1) / BLAKE3_CHUNK_LEN : 1;
+}
+
+/* chunks under the left child of a node over n > 1 chunks */
+HA_PRVFUN uint64_t
+bao_left (uint64_t n)
+{
+  uint64_t left = 1;
+
+  while (left * 2 < n)
+    left *= 2;
+  return left;
+}
+
+HA_PRVFUN void
+bao_parent_cv (const uint8_t node[BAO_NODE_SIZE], int root, uint8_t cv[32])
+{
+  uint32_t m[16], out[16];
+  size_t i;
+
+  ha_imp_blake3_load (m, node);
+  ha_imp_blake3_compress (out, m, HA_BLAKE3_H0, 0, 64,
+                          BLAKE3_FLAG_PARENT | (root ? BLAKE3_FLAG_ROOT : 0));
+  for (i = 0; i < 8; ++i)
+    store_le32 (cv + 4 * i, out[i]);
+}
+
+/* the chaining value, or the root hash, of the whole chunks from chunk
+   on held in data */
+HA_PRVFUN void
+bao_subtree_cv (const uint8_t *data, size_t size, uint64_t chunk, int root,
+                uint8_t cv[32])
+{
+  ha_blake3_context ctx;
+
+  ha_blake3_init (&ctx);
+  if (root)
+    {
+      ha_blake3_update (&ctx, data, size);
+      ha_blake3_final (&ctx, cv, 32);
+      return;
+    }
+  ha_blake3_set_input_offset (&ctx, chunk * BLAKE3_CHUNK_LEN);
+  ha_blake3_update (&ctx, data, size);
+  ha_blake3_finalize_subtree (&ctx, cv);
+}
+
+/* writes the parents over the n chaining values at cvs to out in
+   pre-order, and their root's chaining value to cv */
+static void
+bao_encode_cvs (const uint8_t *cvs, size_t n, uint8_t *out, int root,
+                uint8_t cv[32])
+{
+  size_t left;
+
+  if (n == 1)
+    {
+      memcpy (cv, cvs, 32);
+      return;
+    }
+  left = (size_t)bao_left (n);
+  bao_encode_cvs (cvs, left, out + BAO_NODE_SIZE, 0, out);
+  bao_encode_cvs (cvs + 32 * left, n - left, out + BAO_NODE_SIZE * left, 0,
+                  out + 32);
+  bao_parent_cv (out, root, cv);
+}
+
+/* writes the parents of the subtree over the size bytes at data, which
+   start at chunk, to out in pre-order, and its chaining value to cv */
+static void
+bao_encode_data (const uint8_t *data, size_t size, uint64_t chunk,
+                 uint8_t *out, int root, uint8_t cv[32])
+{
+  const uint8_t *inputs[BAO_GROUP] = { 0 };
+  uint8_t cvs[BAO_GROUP * 32];
+  size_t n = (size_t)bao_chunks (size), full = size / BLAKE3_CHUNK_LEN, i;
+
+  if (n > BAO_GROUP)
+    {
+      size_t left = (size_t)bao_left (n), split = left * BLAKE3_CHUNK_LEN;
+
+      bao_encode_data (data, split, chunk, out + BAO_NODE_SIZE, 0, out);
+      bao_encode_data (data + split, size - split, chunk + left,
+                       out + BAO_NODE_SIZE * left, 0, out + 32);
+      bao_parent_cv (out, root, cv);
+      return;
+    }
+
+  for (i = 0; i < full; ++i)
+    inputs[i] = data + i * BLAKE3_CHUNK_LEN;
+  ha_imp_blake3_hash_many (inputs, full, BLAKE3_CHUNK_LEN / 64, HA_BLAKE3_H0,
+                           chunk, 1, 0, BLAKE3_FLAG_CHUNK_START,
+                           BLAKE3_FLAG_CHUNK_END, cvs);
+  if (full < n)
+    bao_subtree_cv (data + full * BLAKE3_CHUNK_LEN,
+                    size - full * BLAKE3_CHUNK_LEN, chunk + full, 0,
+                    cvs + 32 * full);
+  bao_encode_cvs (cvs, n, out, root, cv);
+}
+
+struct bao_range
+{
+  const uint8_t *outboard; /* the first parent node */
+  const uint8_t *data;     /* the first chunk of the range */
+  uint64_t size;           /* blob length */
+  uint64_t first, last;    /* chunks of the range */
+};
+
+/* checks the subtree over the n chunks from chunk on, whose parents
+   start at node, against cv */
+static bool
+bao_verify (const struct bao_range *r, uint64_t chunk, uint64_t n,
+            const uint8_t *node, const uint8_t cv[32], int root)
+{
+  uint8_t check[32];
+  uint64_t left;
+
+  if (r->first <= chunk && chunk + n - 1 <= r->last)
+    {
+      uint64_t end = (chunk + n) * BLAKE3_CHUNK_LEN;
+
+      if (end > r->size)
+        end = r->size;
+      bao_subtree_cv (r->data + (chunk - r->first) * BLAKE3_CHUNK_LEN,
+                      (size_t)(end - chunk * BLAKE3_CHUNK_LEN), chunk, root,
+                      check);
+      return memcmp (check, cv, 32) == 0;
+    }
+
+  /* a node the range only partly covers: n > 1 */
+  bao_parent_cv (node, root, check);
+  if (memcmp (check, cv, 32) != 0)
+    return false;
+  left = bao_left (n);
+  if (r->first < chunk + left
+      && !bao_verify (r, chunk, left, node + BAO_NODE_SIZE, node, 0))
+    return false;
+  if (r->last >= chunk + left
+      && !bao_verify (r, chunk + left, n - left,
+                      node + BAO_NODE_SIZE * left, node + 32, 0))
+    return false;
+  return true;
+}
+
+HA_PUBFUN uint64_t
+ha_bao_outboard_size (uint64_t size)
+{
+  return BAO_HEADER_SIZE + BAO_NODE_SIZE * (bao_chunks (size) - 1);
+}
+
+HA_PUBFUN void
+ha_bao_encode_outboard (ha_inbuf_t data, size_t size, uint8_t *outboard,
+                        uint8_t hash[HA_BAO_HASH_SIZE])
+{
+  store_le64 (outboard, size);
+  if (size <= BLAKE3_CHUNK_LEN)
+    ha_blake3_hash (data, size, hash, HA_BAO_HASH_SIZE);
+  else
+    bao_encode_data (data, size, 0, outboard + BAO_HEADER_SIZE, 1, hash);
+}
+
+HA_PUBFUN bool
+ha_bao_verify_range (const uint8_t hash[HA_BAO_HASH_SIZE],
+                     const uint8_t *outboard, size_t outboard_size,
+                     uint64_t start, uint64_t length, ha_inbuf_t data,
+                     size_t data_size)
+{
+  struct bao_range r;
+  uint64_t n, end;
+
+  if (outboard_size < BAO_HEADER_SIZE)
+    return false;
+  r.size = load_le64 (outboard);
+  n = bao_chunks (r.size);
+  if (r.size / BLAKE3_CHUNK_LEN >= (uint64_t)1 << 54
+      || outboard_size != ha_bao_outboard_size (r.size) || start > r.size
+      || length > r.size - start)
+    return false;
+
+  r.outboard = outboard + BAO_HEADER_SIZE;
+  r.data = data;
+  r.first = start / BLAKE3_CHUNK_LEN;
+  r.last = length ? (start + length - 1) / BLAKE3_CHUNK_LEN : r.first;
+  if (r.first == n)
+    r.first = r.last = n - 1;
+
+  /* the header is not trusted yet: bound the chunks read by the buffer
+     before hashing any of them */
+  end = (r.last + 1) * BLAKE3_CHUNK_LEN;
+  if (end > r.size)
+    end = r.size;
+  if (data_size < end - r.first * BLAKE3_CHUNK_LEN)
+    return false;
+  return bao_verify (&r, 0, n, r.outboard, hash, 1);
+}
@@ -0,0 +1,89 @@
+#ifndef __hasha_imp_blake2_h
+#define __hasha_imp_blake2_h
+
+#include "../include/hasha/blake2b.h"
+#include "../include/hasha/blake2b_k.h"
+#include "../include/hasha/blake2bp.h"
+#include "../include/hasha/blake2s.h"
+#include "../include/hasha/blake2s_k.h"
+#include "../include/hasha/blake2sp.h"
+#include "../include/hasha/blake2xb.h"
+#include "../include/hasha/blake2xs.h"
+#include "./cpu.h"
+
+/* compress one 128-byte block into h with counter t and finalization
+   flags f */
+typedef void (*ha_imp_blake2b_compress_fn) (uint64_t h[8],
+                                            const uint8_t block[128],
+                                            const uint64_t t[2],
+                                            const uint64_t f[2]);
+
+/* compress one 64-byte block into h with counter t and finalization
+   flags f */
+typedef void (*ha_imp_blake2s_compress_fn) (uint32_t h[8],
+                                            const uint8_t block[64],
+                                            const uint32_t t[2],
+                                            const uint32_t f[2]);
+
+/* compress n consecutive strides of one block per leaf into the leaf
+   states h[word][leaf]; t counts the bytes each leaf has taken so far */
+typedef void (*ha_imp_blake2bp_compress_fn) (
+    uint64_t h[8][HA_BLAKE2BP_LEAVES], const uint8_t *data, size_t n,
+    uint64_t t);
+typedef void (*ha_imp_blake2sp_compress_fn) (
+    uint32_t h[8][HA_BLAKE2SP_LEAVES], const uint8_t *data, size_t n,
+    uint64_t t);
+
+/* compress the last and only block of HA_BLAKE2XB_LANES output nodes,
+   whose states are h[word][node], all with the message block of len
+   bytes */
+typedef void (*ha_imp_blake2xb_nodes_fn) (uint64_t h[8][HA_BLAKE2XB_LANES],
+                                          const uint8_t block[128],
+                                          size_t len);
+typedef void (*ha_imp_blake2xs_nodes_fn) (uint32_t h[8][HA_BLAKE2XS_LANES],
+                                          const uint8_t block[64],
+                                          size_t len);
+
+/* the CPU features the BLAKE2 kernels may use: all of them, or those of
+   the kernel HASHA_BLAKE2_IMPL names (scalar, sse4.1, avx2, avx512vl);
+   unknown names and kernels the CPU cannot run are ignored */
+unsigned ha_imp_blake2_features (void);
+
+#if defined(HA_IMP_X86_SIMD)
+void ha_imp_blake2b_compress_sse41 (uint64_t h[8], const uint8_t block[128],
+                                    const uint64_t t[2], const uint64_t f[2]);
+void ha_imp_blake2b_compress_avx2 (uint64_t h[8], const uint8_t block[128],
+                                   const uint64_t t[2], const uint64_t f[2]);
+void ha_imp_blake2b_compress_avx512vl (uint64_t h[8],
+                                       const uint8_t block[128],
+                                       const uint64_t t[2],
+                                       const uint64_t f[2]);
+void ha_imp_blake2s_compress_sse41 (uint32_t h[8], const uint8_t block[64],
+                                    const uint32_t t[2], const uint32_t f[2]);
+void ha_imp_blake2s_compress_avx512vl (uint32_t h[8],
+                                       const uint8_t block[64],
+                                       const uint32_t t[2],
+                                       const uint32_t f[2]);
+void ha_imp_blake2bp_compress_avx2 (uint64_t h[8][HA_BLAKE2BP_LEAVES],
+                                    const uint8_t *data, size_t n,
+                                    uint64_t t);
+void ha_imp_blake2bp_compress_avx512vl (uint64_t h[8][HA_BLAKE2BP_LEAVES],
+                                        const uint8_t *data, size_t n,
+                                        uint64_t t);
+void ha_imp_blake2sp_compress_avx2 (uint32_t h[8][HA_BLAKE2SP_LEAVES],
+                                    const uint8_t *data, size_t n,
+                                    uint64_t t);
+void ha_imp_blake2sp_compress_avx512vl (uint32_t h[8][HA_BLAKE2SP_LEAVES],
+                                        const uint8_t *data, size_t n,
+                                        uint64_t t);
+void ha_imp_blake2xb_nodes_avx2 (uint64_t h[8][HA_BLAKE2XB_LANES],
+                                 const uint8_t block[128], size_t len);
+void ha_imp_blake2xb_nodes_avx512vl (uint64_t h[8][HA_BLAKE2XB_LANES],
+                                     const uint8_t block[128], size_t len);
+void ha_imp_blake2xs_nodes_avx2 (uint32_t h[8][HA_BLAKE2XS_LANES],
+                                 const uint8_t block[64], size_t len);
+void ha_imp_blake2xs_nodes_avx512vl (uint32_t h[8][HA_BLAKE2XS_LANES],
+                                     const uint8_t block[64], size_t len);
+#endif
+
+#endif
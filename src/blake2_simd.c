@@ -0,0 +1,493 @@
+#define HA_BUILD
+
+#include "./blake2.h"
+
+/*
+ * Row-vectorized BLAKE2 compression: row r of the 4x4 state v is one
+ * vector (v[4r] .. v[4r + 3]), 4x64 bits for BLAKE2b and 4x32 bits for
+ * BLAKE2s, so the four column G functions of a round run side by side.
+ * Rotating rows a, c and d against b lines the diagonals up as columns
+ * for the second half of the round, and rotating them back restores the
+ * rows.
+ *
+ * The rounds are unrolled with constant indices, which folds the sigma
+ * lookups into the message gathers. Without AVX-512VL the rotations by
+ * 32 (BLAKE2b), 16 and 8 (BLAKE2s), 24 and 16 (BLAKE2b) move whole bytes
+ * and take one pshufd or pshufb, BLAKE2b's rotation by 63 is an add and
+ * a shift; with it every rotation is one vprorq / vprord. On SSE4.1 a
+ * BLAKE2b row takes two 128-bit registers, and its rotations by a lane
+ * are palignr pairs across them.
+ *
+ * BLAKE2bp and BLAKE2sp instead put one leaf in each lane (4x64 and 8x32
+ * bits), as the BLAKE3 many-input kernels do: a stride holds one block
+ * per leaf, and each square of `lanes' message words is transposed so
+ * that word w of every leaf's block lands in m[w]. The output nodes of
+ * BLAKE2Xb and BLAKE2Xs share one message, the root digest, which is
+ * broadcast instead, and differ only in their parameter blocks.
+ */
+
+#if defined(HA_IMP_X86_SIMD)
+
+typedef uint64_t blake2b_v2 __attribute__ ((vector_size (16)));
+typedef uint64_t blake2b_v4 __attribute__ ((vector_size (32)));
+typedef uint32_t blake2s_v4 __attribute__ ((vector_size (16)));
+typedef uint32_t blake2s_v8 __attribute__ ((vector_size (32)));
+typedef uint32_t blake2_d4 __attribute__ ((vector_size (16)));
+typedef uint32_t blake2_d8 __attribute__ ((vector_size (32)));
+typedef uint8_t blake2_b16 __attribute__ ((vector_size (16)));
+typedef uint8_t blake2_b32 __attribute__ ((vector_size (32)));
+
+#define BLAKE2_ROTR(x, n, w) (((x) >> (n)) | ((x) << ((w) - (n))))
+
+#define BLAKE2B_R24_B16                                                       \
+  { 3, 4, 5, 6, 7, 0, 1, 2, 11, 12, 13, 14, 15, 8, 9, 10 }
+#define BLAKE2B_R16_B16                                                       \
+  { 2, 3, 4, 5, 6, 7, 0, 1, 10, 11, 12, 13, 14, 15, 8, 9 }
+#define BLAKE2B_R24_B32                                                       \
+  { 3,  4,  5,  6,  7,  0,  1,  2,  11, 12, 13, 14, 15, 8,  9,  10,           \
+    19, 20, 21, 22, 23, 16, 17, 18, 27, 28, 29, 30, 31, 24, 25, 26 }
+#define BLAKE2B_R16_B32                                                       \
+  { 2,  3,  4,  5,  6,  7,  0,  1,  10, 11, 12, 13, 14, 15, 8,  9,            \
+    18, 19, 20, 21, 22, 23, 16, 17, 26, 27, 28, 29, 30, 31, 24, 25 }
+#define BLAKE2S_R16_B16                                                       \
+  { 2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13 }
+#define BLAKE2S_R8_B16                                                        \
+  { 1, 2, 3, 0, 5, 6, 7, 4, 9, 10, 11, 8, 13, 14, 15, 12 }
+#define BLAKE2S_R16_B32                                                       \
+  { 2,  3,  0,  1,  6,  7,  4,  5,  10, 11, 8,  9,  14, 15, 12, 13,           \
+    18, 19, 16, 17, 22, 23, 20, 21, 26, 27, 24, 25, 30, 31, 28, 29 }
+#define BLAKE2S_R8_B32                                                        \
+  { 1,  2,  3,  0,  5,  6,  7,  4,  9,  10, 11, 8,  13, 14, 15, 12,           \
+    17, 18, 19, 16, 21, 22, 23, 20, 25, 26, 27, 24, 29, 30, 31, 28 }
+
+/* the four G functions on the columns of a, b, c, d, with message words
+   x and y; R1 .. R4 are the rotations of the kernel. Adding the message
+   word first keeps one add off the dependency chain through b. */
+#define BLAKE2_G4(a, b, c, d, x, y, R1, R2, R3, R4)                           \
+  a = a + x + b;                                                              \
+  d = R1 (d ^ a);                                                             \
+  c += d;                                                                     \
+  b = R2 (b ^ c);                                                             \
+  a = a + y + b;                                                              \
+  d = R3 (d ^ a);                                                             \
+  c += d;                                                                     \
+  b = R4 (b ^ c);
+
+/* b, the row the next G needs first, stays put: a, c and d are rotated
+   around it, so the diagonal of column j lands in lane j + 1 */
+#define BLAKE2_ROUND(vec, s, r, R1, R2, R3, R4)                               \
+  x = (vec){ m[s[r][0]], m[s[r][2]], m[s[r][4]], m[s[r][6]] };                \
+  y = (vec){ m[s[r][1]], m[s[r][3]], m[s[r][5]], m[s[r][7]] };                \
+  BLAKE2_G4 (a, b, c, d, x, y, R1, R2, R3, R4)                                \
+  a = __builtin_shuffle (a, (vec){ 3, 0, 1, 2 });                             \
+  c = __builtin_shuffle (c, (vec){ 1, 2, 3, 0 });                             \
+  d = __builtin_shuffle (d, (vec){ 2, 3, 0, 1 });                             \
+  x = (vec){ m[s[r][14]], m[s[r][8]], m[s[r][10]], m[s[r][12]] };             \
+  y = (vec){ m[s[r][15]], m[s[r][9]], m[s[r][11]], m[s[r][13]] };             \
+  BLAKE2_G4 (a, b, c, d, x, y, R1, R2, R3, R4)                                \
+  a = __builtin_shuffle (a, (vec){ 1, 2, 3, 0 });                             \
+  c = __builtin_shuffle (c, (vec){ 3, 0, 1, 2 });                             \
+  d = __builtin_shuffle (d, (vec){ 2, 3, 0, 1 });
+
+#define BLAKE2B_ROUND(r)                                                      \
+  BLAKE2_ROUND (blake2b_v4, HA_BLAKE2B_SIGMA, r, BLAKE2B_ROTR32,              \
+                BLAKE2B_ROTR24, BLAKE2B_ROTR16, BLAKE2B_ROTR63)
+
+#define BLAKE2S_ROUND(r)                                                      \
+  BLAKE2_ROUND (blake2s_v4, HA_BLAKE2S_SIGMA, r, BLAKE2S_ROTR16,              \
+                BLAKE2S_ROTR12, BLAKE2S_ROTR8, BLAKE2S_ROTR7)
+
+#define BLAKE2B_KERNEL(name, isa)                                             \
+  HA_IMP_TARGET (isa)                                                         \
+  void name (uint64_t h[8], const uint8_t block[128], const uint64_t t[2],    \
+             const uint64_t f[2])                                             \
+  {                                                                           \
+    blake2b_v4 a, b, c, d, x, y, h0, h1;                                      \
+    uint64_t m[16];                                                           \
+                                                                              \
+    memcpy (m, block, sizeof (m));                                            \
+    memcpy (&h0, h, sizeof (h0));                                             \
+    memcpy (&h1, h + 4, sizeof (h1));                                         \
+    a = h0;                                                                   \
+    b = h1;                                                                   \
+    memcpy (&c, HA_BLAKE2B_H0, sizeof (c));                                   \
+    memcpy (&d, HA_BLAKE2B_H0 + 4, sizeof (d));                               \
+    d ^= (blake2b_v4){ t[0], t[1], f[0], f[1] };                              \
+                                                                              \
+    BLAKE2B_ROUND (0);                                                        \
+    BLAKE2B_ROUND (1);                                                        \
+    BLAKE2B_ROUND (2);                                                        \
+    BLAKE2B_ROUND (3);                                                        \
+    BLAKE2B_ROUND (4);                                                        \
+    BLAKE2B_ROUND (5);                                                        \
+    BLAKE2B_ROUND (6);                                                        \
+    BLAKE2B_ROUND (7);                                                        \
+    BLAKE2B_ROUND (8);                                                        \
+    BLAKE2B_ROUND (9);                                                        \
+    BLAKE2B_ROUND (10);                                                       \
+    BLAKE2B_ROUND (11);                                                       \
+                                                                              \
+    h0 ^= a ^ c;                                                              \
+    h1 ^= b ^ d;                                                              \
+    memcpy (h, &h0, sizeof (h0));                                             \
+    memcpy (h + 4, &h1, sizeof (h1));                                         \
+  }
+
+#define BLAKE2S_KERNEL(name, isa)                                             \
+  HA_IMP_TARGET (isa)                                                         \
+  void name (uint32_t h[8], const uint8_t block[64], const uint32_t t[2],     \
+             const uint32_t f[2])                                             \
+  {                                                                           \
+    blake2s_v4 a, b, c, d, x, y, h0, h1;                                      \
+    uint32_t m[16];                                                           \
+                                                                              \
+    memcpy (m, block, sizeof (m));                                            \
+    memcpy (&h0, h, sizeof (h0));                                             \
+    memcpy (&h1, h + 4, sizeof (h1));                                         \
+    a = h0;                                                                   \
+    b = h1;                                                                   \
+    memcpy (&c, HA_BLAKE2S_H0, sizeof (c));                                   \
+    memcpy (&d, HA_BLAKE2S_H0 + 4, sizeof (d));                               \
+    d ^= (blake2s_v4){ t[0], t[1], f[0], f[1] };                              \
+                                                                              \
+    BLAKE2S_ROUND (0);                                                        \
+    BLAKE2S_ROUND (1);                                                        \
+    BLAKE2S_ROUND (2);                                                        \
+    BLAKE2S_ROUND (3);                                                        \
+    BLAKE2S_ROUND (4);                                                        \
+    BLAKE2S_ROUND (5);                                                        \
+    BLAKE2S_ROUND (6);                                                        \
+    BLAKE2S_ROUND (7);                                                        \
+    BLAKE2S_ROUND (8);                                                        \
+    BLAKE2S_ROUND (9);                                                        \
+                                                                              \
+    h0 ^= a ^ c;                                                              \
+    h1 ^= b ^ d;                                                              \
+    memcpy (h, &h0, sizeof (h0));                                             \
+    memcpy (h + 4, &h1, sizeof (h1));                                         \
+  }
+
+/* BLAKE2b in 128-bit registers: each row is split into a low half (lanes
+   0, 1) and a high half (lanes 2, 3), the G functions run on both, and
+   a row rotation by one lane is a pair of palignr across the halves */
+#define BLAKE2_HALVES_ROTL1(lo, hi)                                           \
+  tmp = __builtin_shuffle (lo, hi, (blake2b_v2){ 1, 2 });                     \
+  hi = __builtin_shuffle (hi, lo, (blake2b_v2){ 1, 2 });                      \
+  lo = tmp;
+#define BLAKE2_HALVES_ROTR1(lo, hi)                                           \
+  tmp = __builtin_shuffle (hi, lo, (blake2b_v2){ 1, 2 });                     \
+  hi = __builtin_shuffle (lo, hi, (blake2b_v2){ 1, 2 });                      \
+  lo = tmp;
+#define BLAKE2_HALVES_SWAP(lo, hi)                                            \
+  tmp = lo;                                                                   \
+  lo = hi;                                                                    \
+  hi = tmp;
+
+#define BLAKE2B_HALVES_G4(r, a, b, c, d, i, j, k, l)                          \
+  x = (blake2b_v2){ m[HA_BLAKE2B_SIGMA[r][i]], m[HA_BLAKE2B_SIGMA[r][k]] };   \
+  y = (blake2b_v2){ m[HA_BLAKE2B_SIGMA[r][j]], m[HA_BLAKE2B_SIGMA[r][l]] };   \
+  BLAKE2_G4 (a, b, c, d, x, y, BLAKE2B_ROTR32, BLAKE2B_ROTR24,                \
+             BLAKE2B_ROTR16, BLAKE2B_ROTR63)
+
+#define BLAKE2B_HALVES_ROUND(r)                                               \
+  BLAKE2B_HALVES_G4 (r, a0, b0, c0, d0, 0, 1, 2, 3)                           \
+  BLAKE2B_HALVES_G4 (r, a1, b1, c1, d1, 4, 5, 6, 7)                           \
+  BLAKE2_HALVES_ROTR1 (a0, a1)                                                \
+  BLAKE2_HALVES_ROTL1 (c0, c1)                                                \
+  BLAKE2_HALVES_SWAP (d0, d1)                                                 \
+  BLAKE2B_HALVES_G4 (r, a0, b0, c0, d0, 14, 15, 8, 9)                         \
+  BLAKE2B_HALVES_G4 (r, a1, b1, c1, d1, 10, 11, 12, 13)                       \
+  BLAKE2_HALVES_ROTL1 (a0, a1)                                                \
+  BLAKE2_HALVES_ROTR1 (c0, c1)                                                \
+  BLAKE2_HALVES_SWAP (d0, d1)
+
+#define BLAKE2B_HALVES_KERNEL(name, isa)                                      \
+  HA_IMP_TARGET (isa)                                                         \
+  void name (uint64_t h[8], const uint8_t block[128], const uint64_t t[2],    \
+             const uint64_t f[2])                                             \
+  {                                                                           \
+    blake2b_v2 a0, a1, b0, b1, c0, c1, d0, d1, x, y, tmp, hv[4];              \
+    uint64_t m[16];                                                           \
+                                                                              \
+    memcpy (m, block, sizeof (m));                                            \
+    memcpy (hv, h, sizeof (hv));                                              \
+    a0 = hv[0], a1 = hv[1], b0 = hv[2], b1 = hv[3];                           \
+    memcpy (&c0, HA_BLAKE2B_H0, sizeof (c0));                                 \
+    memcpy (&c1, HA_BLAKE2B_H0 + 2, sizeof (c1));                             \
+    memcpy (&d0, HA_BLAKE2B_H0 + 4, sizeof (d0));                             \
+    memcpy (&d1, HA_BLAKE2B_H0 + 6, sizeof (d1));                             \
+    d0 ^= (blake2b_v2){ t[0], t[1] };                                         \
+    d1 ^= (blake2b_v2){ f[0], f[1] };                                         \
+                                                                              \
+    BLAKE2B_HALVES_ROUND (0);                                                 \
+    BLAKE2B_HALVES_ROUND (1);                                                 \
+    BLAKE2B_HALVES_ROUND (2);                                                 \
+    BLAKE2B_HALVES_ROUND (3);                                                 \
+    BLAKE2B_HALVES_ROUND (4);                                                 \
+    BLAKE2B_HALVES_ROUND (5);                                                 \
+    BLAKE2B_HALVES_ROUND (6);                                                 \
+    BLAKE2B_HALVES_ROUND (7);                                                 \
+    BLAKE2B_HALVES_ROUND (8);                                                 \
+    BLAKE2B_HALVES_ROUND (9);                                                 \
+    BLAKE2B_HALVES_ROUND (10);                                                \
+    BLAKE2B_HALVES_ROUND (11);                                                \
+                                                                              \
+    hv[0] ^= a0 ^ c0;                                                         \
+    hv[1] ^= a1 ^ c1;                                                         \
+    hv[2] ^= b0 ^ d0;                                                         \
+    hv[3] ^= b1 ^ d1;                                                         \
+    memcpy (h, hv, sizeof (hv));                                              \
+  }
+
+/* G on one leaf per lane; the kernel names its rotations R1 .. R4 */
+#define BLAKE2_MANY_G(sigmatb, r, i, a, b, c, d)                              \
+  a += b + m[sigmatb[r][2 * i + 0]];                                          \
+  d = BLAKE2_MANY_R1 (d ^ a);                                                 \
+  c += d;                                                                     \
+  b = BLAKE2_MANY_R2 (b ^ c);                                                 \
+  a += b + m[sigmatb[r][2 * i + 1]];                                          \
+  d = BLAKE2_MANY_R3 (d ^ a);                                                 \
+  c += d;                                                                     \
+  b = BLAKE2_MANY_R4 (b ^ c);
+
+#define BLAKE2B_MANY_ROUNDS                                                   \
+  ha_primitive_blake_round (HA_BLAKE2B_SIGMA, BLAKE2_MANY_G, 0);              \
+  ha_primitive_blake_round (HA_BLAKE2B_SIGMA, BLAKE2_MANY_G, 1);              \
+  ha_primitive_blake_round (HA_BLAKE2B_SIGMA, BLAKE2_MANY_G, 2);              \
+  ha_primitive_blake_round (HA_BLAKE2B_SIGMA, BLAKE2_MANY_G, 3);              \
+  ha_primitive_blake_round (HA_BLAKE2B_SIGMA, BLAKE2_MANY_G, 4);              \
+  ha_primitive_blake_round (HA_BLAKE2B_SIGMA, BLAKE2_MANY_G, 5);              \
+  ha_primitive_blake_round (HA_BLAKE2B_SIGMA, BLAKE2_MANY_G, 6);              \
+  ha_primitive_blake_round (HA_BLAKE2B_SIGMA, BLAKE2_MANY_G, 7);              \
+  ha_primitive_blake_round (HA_BLAKE2B_SIGMA, BLAKE2_MANY_G, 8);              \
+  ha_primitive_blake_round (HA_BLAKE2B_SIGMA, BLAKE2_MANY_G, 9);              \
+  ha_primitive_blake_round (HA_BLAKE2B_SIGMA, BLAKE2_MANY_G, 10);             \
+  ha_primitive_blake_round (HA_BLAKE2B_SIGMA, BLAKE2_MANY_G, 11);
+
+#define BLAKE2S_MANY_ROUNDS                                                   \
+  ha_primitive_blake_round (HA_BLAKE2S_SIGMA, BLAKE2_MANY_G, 0);              \
+  ha_primitive_blake_round (HA_BLAKE2S_SIGMA, BLAKE2_MANY_G, 1);              \
+  ha_primitive_blake_round (HA_BLAKE2S_SIGMA, BLAKE2_MANY_G, 2);              \
+  ha_primitive_blake_round (HA_BLAKE2S_SIGMA, BLAKE2_MANY_G, 3);              \
+  ha_primitive_blake_round (HA_BLAKE2S_SIGMA, BLAKE2_MANY_G, 4);              \
+  ha_primitive_blake_round (HA_BLAKE2S_SIGMA, BLAKE2_MANY_G, 5);              \
+  ha_primitive_blake_round (HA_BLAKE2S_SIGMA, BLAKE2_MANY_G, 6);              \
+  ha_primitive_blake_round (HA_BLAKE2S_SIGMA, BLAKE2_MANY_G, 7);              \
+  ha_primitive_blake_round (HA_BLAKE2S_SIGMA, BLAKE2_MANY_G, 8);              \
+  ha_primitive_blake_round (HA_BLAKE2S_SIGMA, BLAKE2_MANY_G, 9);
+
+/* transposes the lanes x lanes square r, t is scratch; i and s are
+   counters and lomask and himask the interleaving shuffles */
+#define BLAKE2_TRANSPOSE(r, t, lanes)                                         \
+  for (s = 1; s < (lanes); s <<= 1)                                           \
+    {                                                                         \
+      for (i = 0; i < (lanes) / 2; ++i)                                       \
+        {                                                                     \
+          t[2 * i] = __builtin_shuffle (r[i], r[i + (lanes) / 2], lomask);    \
+          t[2 * i + 1]                                                        \
+              = __builtin_shuffle (r[i], r[i + (lanes) / 2], himask);         \
+        }                                                                     \
+      memcpy (r, t, sizeof (r));                                              \
+    }
+
+/* compresses n strides of `lanes' blocks, block l of each into leaf l;
+   t counts the bytes each leaf has taken before the first stride, its
+   high half is zero for 64-bit words */
+#define BLAKE2_MANY_KERNEL(name, word, vec, lanes, iv, rounds, isa, lo, hi)   \
+  HA_IMP_TARGET (isa)                                                         \
+  void name (word h[8][lanes], const uint8_t *data, size_t n, uint64_t t)     \
+  {                                                                           \
+    const vec lomask = lo, himask = hi;                                       \
+    const size_t block = 16 * sizeof (word);                                  \
+    vec hv[8], m[16], v[16];                                                  \
+    size_t i, l, w, s;                                                        \
+                                                                              \
+    memcpy (hv, h, sizeof (hv));                                              \
+    for (; n; --n, data += (lanes) * block)                                   \
+      {                                                                       \
+        t += block;                                                           \
+        for (w = 0; w < 16; w += (lanes))                                     \
+          {                                                                   \
+            vec r[lanes], q[lanes];                                           \
+                                                                              \
+            for (l = 0; l < (lanes); ++l)                                     \
+              memcpy (&r[l], data + block * l + sizeof (word) * w,            \
+                      sizeof (vec));                                          \
+            BLAKE2_TRANSPOSE (r, q, lanes);                                   \
+            memcpy (m + w, r, sizeof (r));                                    \
+          }                                                                   \
+                                                                              \
+        for (i = 0; i < 8; ++i)                                               \
+          {                                                                   \
+            v[i] = hv[i];                                                     \
+            v[i + 8] = (vec){ 0 } + iv[i];                                    \
+          }                                                                   \
+        v[12] ^= (word)t;                                                     \
+        v[13] ^= (word)(t >> 32 >> (8 * sizeof (word) - 32));                 \
+                                                                              \
+        rounds                                                                \
+                                                                              \
+        for (i = 0; i < 8; ++i)                                               \
+          hv[i] ^= v[i] ^ v[i + 8];                                           \
+      }                                                                       \
+    memcpy (h, hv, sizeof (hv));                                              \
+  }
+
+/* compresses the last and only block of `lanes' nodes, node l with
+   state h[word][l]; every node has the message block of len bytes */
+#define BLAKE2_NODES_KERNEL(name, word, vec, lanes, iv, rounds, isa)          \
+  HA_IMP_TARGET (isa)                                                         \
+  void name (word h[8][lanes], const uint8_t block[16 * sizeof (word)],      \
+             size_t len)                                                      \
+  {                                                                           \
+    vec hv[8], m[16], v[16];                                                  \
+    word x;                                                                   \
+    size_t i;                                                                 \
+                                                                              \
+    memcpy (hv, h, sizeof (hv));                                              \
+    for (i = 0; i < 16; ++i)                                                  \
+      {                                                                       \
+        memcpy (&x, block + sizeof (word) * i, sizeof (word));                \
+        m[i] = (vec){ 0 } + x;                                                \
+      }                                                                       \
+    for (i = 0; i < 8; ++i)                                                   \
+      {                                                                       \
+        v[i] = hv[i];                                                         \
+        v[i + 8] = (vec){ 0 } + iv[i];                                        \
+      }                                                                       \
+    v[12] ^= (word)len;                                                       \
+    v[14] = ~v[14];                                                           \
+                                                                              \
+    rounds                                                                    \
+                                                                              \
+    for (i = 0; i < 8; ++i)                                                   \
+      hv[i] ^= v[i] ^ v[i + 8];                                               \
+    memcpy (h, hv, sizeof (hv));                                              \
+  }
+
+#define BLAKE2BP_KERNEL(name, isa)                                            \
+  BLAKE2_MANY_KERNEL (name, uint64_t, blake2b_v4, 4, HA_BLAKE2B_H0,           \
+                      BLAKE2B_MANY_ROUNDS, isa, BLAKE2_LO4, BLAKE2_HI4)
+
+#define BLAKE2SP_KERNEL(name, isa)                                            \
+  BLAKE2_MANY_KERNEL (name, uint32_t, blake2s_v8, 8, HA_BLAKE2S_H0,           \
+                      BLAKE2S_MANY_ROUNDS, isa, BLAKE2_LO8, BLAKE2_HI8)
+
+#define BLAKE2XB_KERNEL(name, isa)                                            \
+  BLAKE2_NODES_KERNEL (name, uint64_t, blake2b_v4, 4, HA_BLAKE2B_H0,          \
+                       BLAKE2B_MANY_ROUNDS, isa)
+
+#define BLAKE2XS_KERNEL(name, isa)                                            \
+  BLAKE2_NODES_KERNEL (name, uint32_t, blake2s_v8, 8, HA_BLAKE2S_H0,          \
+                       BLAKE2S_MANY_ROUNDS, isa)
+
+#define BLAKE2_LO4 { 0, 4, 1, 5 }
+#define BLAKE2_HI4 { 2, 6, 3, 7 }
+#define BLAKE2_LO8 { 0, 8, 1, 9, 2, 10, 3, 11 }
+#define BLAKE2_HI8 { 4, 12, 5, 13, 6, 14, 7, 15 }
+
+#define BLAKE2B_ROTR32(x)                                                     \
+  ((blake2b_v2)__builtin_shuffle ((blake2_d4)(x), (blake2_d4){ 1, 0, 3, 2 }))
+#define BLAKE2B_ROTR24(x)                                                     \
+  ((blake2b_v2)__builtin_shuffle ((blake2_b16)(x),                            \
+                                  (blake2_b16)BLAKE2B_R24_B16))
+#define BLAKE2B_ROTR16(x)                                                     \
+  ((blake2b_v2)__builtin_shuffle ((blake2_b16)(x),                            \
+                                  (blake2_b16)BLAKE2B_R16_B16))
+#define BLAKE2B_ROTR63(x) (((x) >> 63) ^ ((x) + (x)))
+BLAKE2B_HALVES_KERNEL (ha_imp_blake2b_compress_sse41, "sse4.1")
+#undef BLAKE2B_ROTR32
+#undef BLAKE2B_ROTR24
+#undef BLAKE2B_ROTR16
+#undef BLAKE2B_ROTR63
+
+#define BLAKE2B_ROTR32(x)                                                     \
+  ((blake2b_v4)__builtin_shuffle ((blake2_d8)(x),                             \
+                                  (blake2_d8){ 1, 0, 3, 2, 5, 4, 7, 6 }))
+#define BLAKE2B_ROTR24(x)                                                     \
+  ((blake2b_v4)__builtin_shuffle ((blake2_b32)(x),                            \
+                                  (blake2_b32)BLAKE2B_R24_B32))
+#define BLAKE2B_ROTR16(x)                                                     \
+  ((blake2b_v4)__builtin_shuffle ((blake2_b32)(x),                            \
+                                  (blake2_b32)BLAKE2B_R16_B32))
+#define BLAKE2B_ROTR63(x) (((x) >> 63) ^ ((x) + (x)))
+BLAKE2B_KERNEL (ha_imp_blake2b_compress_avx2, "avx2")
+#define BLAKE2_MANY_R1 BLAKE2B_ROTR32
+#define BLAKE2_MANY_R2 BLAKE2B_ROTR24
+#define BLAKE2_MANY_R3 BLAKE2B_ROTR16
+#define BLAKE2_MANY_R4 BLAKE2B_ROTR63
+BLAKE2BP_KERNEL (ha_imp_blake2bp_compress_avx2, "avx2")
+BLAKE2XB_KERNEL (ha_imp_blake2xb_nodes_avx2, "avx2")
+#undef BLAKE2B_ROTR32
+#undef BLAKE2B_ROTR24
+#undef BLAKE2B_ROTR16
+#undef BLAKE2B_ROTR63
+
+#define BLAKE2B_ROTR32(x) BLAKE2_ROTR (x, 32, 64)
+#define BLAKE2B_ROTR24(x) BLAKE2_ROTR (x, 24, 64)
+#define BLAKE2B_ROTR16(x) BLAKE2_ROTR (x, 16, 64)
+#define BLAKE2B_ROTR63(x) BLAKE2_ROTR (x, 63, 64)
+BLAKE2B_KERNEL (ha_imp_blake2b_compress_avx512vl, "avx2,avx512f,avx512vl")
+BLAKE2BP_KERNEL (ha_imp_blake2bp_compress_avx512vl, "avx2,avx512f,avx512vl")
+BLAKE2XB_KERNEL (ha_imp_blake2xb_nodes_avx512vl, "avx2,avx512f,avx512vl")
+#undef BLAKE2_MANY_R1
+#undef BLAKE2_MANY_R2
+#undef BLAKE2_MANY_R3
+#undef BLAKE2_MANY_R4
+#undef BLAKE2B_ROTR32
+#undef BLAKE2B_ROTR24
+#undef BLAKE2B_ROTR16
+#undef BLAKE2B_ROTR63
+
+#define BLAKE2S_ROTR16(x)                                                     \
+  ((blake2s_v4)__builtin_shuffle ((blake2_b16)(x),                            \
+                                  (blake2_b16)BLAKE2S_R16_B16))
+#define BLAKE2S_ROTR12(x) BLAKE2_ROTR (x, 12, 32)
+#define BLAKE2S_ROTR8(x)                                                      \
+  ((blake2s_v4)__builtin_shuffle ((blake2_b16)(x),                            \
+                                  (blake2_b16)BLAKE2S_R8_B16))
+#define BLAKE2S_ROTR7(x) BLAKE2_ROTR (x, 7, 32)
+BLAKE2S_KERNEL (ha_imp_blake2s_compress_sse41, "sse4.1")
+#undef BLAKE2S_ROTR16
+#undef BLAKE2S_ROTR12
+#undef BLAKE2S_ROTR8
+#undef BLAKE2S_ROTR7
+
+#define BLAKE2S_ROTR16(x) BLAKE2_ROTR (x, 16, 32)
+#define BLAKE2S_ROTR12(x) BLAKE2_ROTR (x, 12, 32)
+#define BLAKE2S_ROTR8(x)  BLAKE2_ROTR (x, 8, 32)
+#define BLAKE2S_ROTR7(x)  BLAKE2_ROTR (x, 7, 32)
+BLAKE2S_KERNEL (ha_imp_blake2s_compress_avx512vl,
+                "sse4.1,avx512f,avx512vl")
+#undef BLAKE2S_ROTR16
+#undef BLAKE2S_ROTR12
+#undef BLAKE2S_ROTR8
+#undef BLAKE2S_ROTR7
+
+#define BLAKE2_MANY_R1(x)                                                     \
+  ((blake2s_v8)__builtin_shuffle ((blake2_b32)(x),                            \
+                                  (blake2_b32)BLAKE2S_R16_B32))
+#define BLAKE2_MANY_R2(x) BLAKE2_ROTR (x, 12, 32)
+#define BLAKE2_MANY_R3(x)                                                     \
+  ((blake2s_v8)__builtin_shuffle ((blake2_b32)(x),                            \
+                                  (blake2_b32)BLAKE2S_R8_B32))
+#define BLAKE2_MANY_R4(x) BLAKE2_ROTR (x, 7, 32)
+BLAKE2SP_KERNEL (ha_imp_blake2sp_compress_avx2, "avx2")
+BLAKE2XS_KERNEL (ha_imp_blake2xs_nodes_avx2, "avx2")
+#undef BLAKE2_MANY_R1
+#undef BLAKE2_MANY_R2
+#undef BLAKE2_MANY_R3
+#undef BLAKE2_MANY_R4
+
+#define BLAKE2_MANY_R1(x) BLAKE2_ROTR (x, 16, 32)
+#define BLAKE2_MANY_R2(x) BLAKE2_ROTR (x, 12, 32)
+#define BLAKE2_MANY_R3(x) BLAKE2_ROTR (x, 8, 32)
+#define BLAKE2_MANY_R4(x) BLAKE2_ROTR (x, 7, 32)
+BLAKE2SP_KERNEL (ha_imp_blake2sp_compress_avx512vl, "avx2,avx512f,avx512vl")
+BLAKE2XS_KERNEL (ha_imp_blake2xs_nodes_avx512vl, "avx2,avx512f,avx512vl")
+#undef BLAKE2_MANY_R1
+#undef BLAKE2_MANY_R2
+#undef BLAKE2_MANY_R3
+#undef BLAKE2_MANY_R4
+
+#endif
@@ -1,26 +1,34 @@
 #define HA_BUILD
 
-#include "../include/hasha/blake2s.h"
-#include "../include/hasha/blake2s_k.h"
-
+#include "./blake2.h"
 #include "./endian.h"
 
-HA_PRVFUN void
-ha_blake2s_compress (ha_blake2s_context *ctx, const uint8_t block[64])
+#include "../include/hasha/internal/error.h"
+
+static char *g_ha_blake2s_error_strings[] = {
+#define LENGTH_ERROR 0
+  "%s length %zu is out of range",
+#define OUTLEN_ERROR 1
+  "digest length %zu does not match the context's %zu",
+};
+
+static void
+blake2s_compress_scalar (uint32_t h[8], const uint8_t block[64],
+                         const uint32_t t[2], const uint32_t f[2])
 {
   uint32_t v[16], m[16];
   int i;
 
   for (i = 0; i < 8; i++)
     {
-      v[i] = ctx->h[i];
+      v[i] = h[i];
       v[i + 8] = HA_BLAKE2S_H0[i];
     }
 
-  v[12] ^= ctx->t[0];
-  v[13] ^= ctx->t[1];
-  v[14] ^= ctx->f[0];
-  v[15] ^= ctx->f[1];
+  v[12] ^= t[0];
+  v[13] ^= t[1];
+  v[14] ^= f[0];
+  v[15] ^= f[1];
 
 #ifdef HA_ONLY_LE
   for (i = 0; i < 16; i++)
@@ -46,60 +54,250 @@ ha_blake2s_compress (ha_blake2s_context *ctx, const uint8_t block[64])
   ha_primitive_blake32_round (HA_BLAKE2S_SIGMA, 9);
 
   for (i = 0; i < 8; i++)
-    ctx->h[i] ^= v[i] ^ v[i + 8];
+    h[i] ^= v[i] ^ v[i + 8];
+}
+
+static ha_imp_blake2s_compress_fn
+blake2s_compress_select (unsigned features)
+{
+#if defined(HA_IMP_X86_SIMD)
+  const unsigned avx512vl = HA_CPU_SSE41 | HA_CPU_AVX512F | HA_CPU_AVX512VL;
+
+  if ((features & avx512vl) == avx512vl)
+    return ha_imp_blake2s_compress_avx512vl;
+  if (features & HA_CPU_SSE41)
+    return ha_imp_blake2s_compress_sse41;
+#else
+  (void)features;
+#endif
+  return blake2s_compress_scalar;
+}
+
+HA_PRVFUN void
+blake2s_compress (uint32_t h[8], const uint8_t block[64], const uint32_t t[2],
+                  const uint32_t f[2])
+{
+  static ha_imp_blake2s_compress_fn fn = NULL;
+  if (!fn)
+    fn = blake2s_compress_select (ha_imp_blake2_features ());
+  fn (h, block, t, f);
+}
+
+HA_PRVFUN void
+ha_blake2s_compress (ha_blake2s_context *ctx, const uint8_t block[64])
+{
+  blake2s_compress (ctx->h, block, ctx->t, ctx->f);
+}
+
+/* adds inc to the byte counter, carrying into its high word */
+HA_PRVFUN void
+blake2s_increment (ha_blake2s_context *ctx, uint32_t inc)
+{
+  ctx->t[0] += inc;
+  ctx->t[1] += ctx->t[0] < inc;
+}
+
+/* h = IV ^ the parameter block, read as eight little-endian words */
+HA_PRVFUN void
+blake2s_param_load (uint32_t h[8], const ha_blake2s_param *param)
+{
+  size_t i;
+
+  memcpy (h, HA_BLAKE2S_H0, 8 * sizeof (*h));
+  h[0] ^= (uint32_t)param->digest_length | (uint32_t)param->key_length << 8
+          | (uint32_t)param->fanout << 16 | (uint32_t)param->depth << 24;
+  h[1] ^= param->leaf_length;
+  h[2] ^= (uint32_t)param->node_offset;
+  h[3] ^= (uint32_t)(param->node_offset >> 32 & 0xffff)
+          | (uint32_t)param->node_depth << 16
+          | (uint32_t)param->inner_length << 24;
+  for (i = 0; i < 2; ++i)
+    {
+      h[4 + i] ^= load_le32 (param->salt + 4 * i);
+      h[6 + i] ^= load_le32 (param->personal + 4 * i);
+    }
+}
+
+/* the parameter block holds the lengths in a byte each: a 256-byte key
+   would wrap to an unkeyed 0 */
+HA_PRVFUN bool
+blake2s_lengths_valid (size_t digestlen, size_t keylen)
+{
+  if (digestlen < 1 || digestlen > HA_BLAKE2S_DIGEST_SIZE)
+    {
+      ha_throw_error (0, ha_curpos, g_ha_blake2s_error_strings[LENGTH_ERROR],
+                      "digest", digestlen);
+      return false;
+    }
+  if (keylen > HA_BLAKE2S_KEY_SIZE)
+    {
+      ha_throw_error (0, ha_curpos, g_ha_blake2s_error_strings[LENGTH_ERROR],
+                      "key", keylen);
+      return false;
+    }
+  return true;
+}
+
+HA_PUBFUN void
+ha_blake2s_param_init (ha_blake2s_param *param, size_t digestlen)
+{
+  memset (param, 0, sizeof (*param));
+  if (blake2s_lengths_valid (digestlen, 0))
+    param->digest_length = (uint8_t)digestlen;
+  param->fanout = 1;
+  param->depth = 1;
+}
+
+HA_PUBFUN void
+ha_blake2s_init_param (ha_blake2s_context *ctx, const ha_blake2s_param *param,
+                       ha_inbuf_t key)
+{
+  memset (ctx, 0, sizeof (*ctx));
+  if (!blake2s_lengths_valid (param->digest_length, param->key_length))
+    return;
+  blake2s_param_load (ctx->h, param);
+  ctx->outlen = param->digest_length;
+
+  /* the key, padded with zeros, is the first block; it stays buffered
+     until more input arrives, as the empty input ends with it */
+  if (param->key_length)
+    {
+      memcpy (ctx->buf, key, param->key_length);
+      ctx->buflen = 64;
+    }
+}
+
+HA_PUBFUN void
+ha_blake2s_init_keyed (ha_blake2s_context *ctx, ha_inbuf_t key, size_t keylen,
+                       size_t digestlen)
+{
+  ha_blake2s_param param;
+
+  if (!blake2s_lengths_valid (digestlen, keylen))
+    {
+      memset (ctx, 0, sizeof (*ctx));
+      return;
+    }
+  ha_blake2s_param_init (&param, digestlen);
+  param.key_length = (uint8_t)keylen;
+  ha_blake2s_init_param (ctx, &param, key);
 }
 
 HA_PUBFUN void
 ha_blake2s_init (ha_blake2s_context *ctx)
+{
+  ha_blake2s_init_keyed (ctx, NULL, 0, HA_BLAKE2S_DIGEST_SIZE);
+}
+
+HA_PUBFUN void
+ha_blake2s_save_midstate (const ha_blake2s_context *ctx,
+                          ha_blake2s_midstate *ms)
+{
+  ha_blake2s_context empty = *ctx;
+  const uint32_t t[2] = { 64, 0 }, f[2] = { 0, 0 };
+
+  ha_blake2s_final (&empty, ms->empty, ctx->outlen);
+  memcpy (ms->h, ctx->h, sizeof (ms->h));
+  ms->t = (uint32_t)ctx->buflen;
+  ms->outlen = ctx->outlen;
+  if (ctx->buflen)
+    blake2s_compress (ms->h, ctx->buf, t, f);
+}
+
+HA_PUBFUN void
+ha_blake2s_init_midstate (ha_blake2s_context *ctx,
+                          const ha_blake2s_midstate *ms)
 {
   memset (ctx, 0, sizeof (*ctx));
-  memcpy (ctx->h, HA_BLAKE2S_H0, sizeof (ctx->h));
+  memcpy (ctx->h, ms->h, sizeof (ctx->h));
+  ctx->t[0] = ms->t;
+  ctx->outlen = ms->outlen;
+  if (ms->t)
+    {
+      memcpy (ctx->buf, ms->empty, ms->outlen);
+      ctx->midstate = true;
+    }
 }
 
 HA_PUBFUN void
 ha_blake2s_update (ha_blake2s_context *ctx, ha_inbuf_t data, size_t len)
 {
-  while (len > 0)
+  if (len)
+    ctx->midstate = false;
+
+  /* the last block is held back for final, which compresses it with
+     the finalization flag: a full buffer is only compressed once more
+     input follows it */
+  if (ctx->buflen && ctx->buflen + len > 64)
     {
       size_t fill = 64 - ctx->buflen;
-      size_t to_copy = len < fill ? len : fill;
-      memcpy (ctx->buf + ctx->buflen, data, to_copy);
-      ctx->buflen += to_copy;
-      data += to_copy;
-      len -= to_copy;
 
-      if (ctx->buflen == 64)
-        {
-          ctx->t[0] += 64;
-          ha_blake2s_compress (ctx, ctx->buf);
-          ctx->buflen = 0;
-        }
+      memcpy (ctx->buf + ctx->buflen, data, fill);
+      data += fill;
+      len -= fill;
+      blake2s_increment (ctx, 64);
+      ha_blake2s_compress (ctx, ctx->buf);
+      ctx->buflen = 0;
+    }
+
+  /* straight from data: the whole blocks before the last */
+  while (len > 64)
+    {
+      blake2s_increment (ctx, 64);
+      ha_blake2s_compress (ctx, data);
+      data += 64;
+      len -= 64;
     }
+
+  memcpy (ctx->buf + ctx->buflen, data, len);
+  ctx->buflen += len;
 }
 
 HA_PUBFUN void
 ha_blake2s_final (ha_blake2s_context *ctx, ha_digest_t digest,
                   size_t digestlen)
 {
-  ctx->h[0] ^= (uint32_t)digestlen | (1U << 16) | (1U << 24);
-  ctx->outlen = digestlen;
+  if (!blake2s_lengths_valid (digestlen, 0))
+    return;
+
+  /* the digest length is in the parameter block, which only h holds
+     unmixed until the first compression (a midstate has compressed the
+     key block); a rejected init left no length at all */
+  if (digestlen != ctx->outlen)
+    {
+      if (!ctx->outlen || ctx->t[0] || ctx->t[1])
+        {
+          ha_throw_error (0, ha_curpos,
+                          g_ha_blake2s_error_strings[OUTLEN_ERROR],
+                          digestlen, ctx->outlen);
+          return;
+        }
+      ctx->h[0] ^= (uint32_t)(ctx->outlen ^ digestlen);
+      ctx->outlen = digestlen;
+    }
+
+  if (ctx->midstate)
+    {
+      memcpy (digest, ctx->buf, digestlen);
+      return;
+    }
 
-  ctx->t[0] += ctx->buflen;
+  blake2s_increment (ctx, (uint32_t)ctx->buflen);
   ctx->f[0] = ~0U;
   memset (ctx->buf + ctx->buflen, 0, 64 - ctx->buflen);
   ha_blake2s_compress (ctx, ctx->buf);
 
 #ifdef HA_ONLY_LE
-  memcpy (digest, ctx->h, ctx->outlen);
+  memcpy (digest, ctx->h, digestlen);
 #else
   for (size_t i = 0; i < digestlen / 4; i++)
     store_le32 (digest + i * 4, ctx->h[i]);
 
-  if (digestlen % 8 != 0)
+  if (digestlen % 4 != 0)
     {
-      uint64_t word = ctx->h[digestlen / 4];
+      uint32_t word = ctx->h[digestlen / 4];
       for (size_t j = 0; j < digestlen % 4; j++)
-        digest[(digestlen / 4) * 4 + j] = (word >> (4 * j)) & 0xFF;
+        digest[(digestlen / 4) * 4 + j] = (word >> (8 * j)) & 0xFF;
     }
 #endif
 }
@@ -107,9 +305,391 @@ ha_blake2s_final (ha_blake2s_context *ctx, ha_digest_t digest,
 HA_PUBFUN void
 ha_blake2s_hash (ha_inbuf_t data, size_t len, ha_digest_t digest,
                  size_t digestlen)
+{
+  ha_blake2s_keyed_hash (NULL, 0, data, len, digest, digestlen);
+}
+
+HA_PUBFUN void
+ha_blake2s_keyed_hash (ha_inbuf_t key, size_t keylen, ha_inbuf_t data,
+                       size_t len, ha_digest_t digest, size_t digestlen)
 {
   ha_blake2s_context ctx;
-  ha_blake2s_init (&ctx);
+
+  if (!blake2s_lengths_valid (digestlen, keylen))
+    return;
+  ha_blake2s_init_keyed (&ctx, key, keylen, digestlen);
   ha_blake2s_update (&ctx, data, len);
   ha_blake2s_final (&ctx, digest, digestlen);
 }
+
+/*
+ * BLAKE2sp: the nodes' parameter blocks differ from the sequential
+ * one in the fanout (8), depth (2), node offset, node depth and inner
+ * length (32) fields.
+ */
+
+#define BLAKE2SP_LEAVES HA_BLAKE2SP_LEAVES
+#define BLAKE2SP_STRIDE HA_BLAKE2SP_STRIDE
+
+HA_PRVFUN void
+blake2sp_node_init (uint32_t h[8], size_t outlen, uint64_t offset,
+                    uint32_t depth)
+{
+  ha_blake2s_param param;
+
+  ha_blake2s_param_init (&param, outlen);
+  param.fanout = BLAKE2SP_LEAVES;
+  param.depth = 2;
+  param.node_offset = offset;
+  param.node_depth = (uint8_t)depth;
+  param.inner_length = 32;
+  blake2s_param_load (h, &param);
+}
+
+HA_PRVFUN void
+blake2sp_counter (uint32_t tt[2], uint64_t t)
+{
+  tt[0] = (uint32_t)t;
+  tt[1] = (uint32_t)(t >> 32);
+}
+
+static void
+blake2sp_compress_scalar (uint32_t h[8][BLAKE2SP_LEAVES], const uint8_t *data,
+                          size_t n, uint64_t t)
+{
+  const uint32_t f[2] = { 0, 0 };
+  uint32_t leaf[8], tt[2];
+  size_t i, l;
+
+  for (; n; --n, data += BLAKE2SP_STRIDE)
+    {
+      blake2sp_counter (tt, t += 64);
+      for (l = 0; l < BLAKE2SP_LEAVES; ++l)
+        {
+          for (i = 0; i < 8; ++i)
+            leaf[i] = h[i][l];
+          blake2s_compress (leaf, data + 64 * l, tt, f);
+          for (i = 0; i < 8; ++i)
+            h[i][l] = leaf[i];
+        }
+    }
+}
+
+static ha_imp_blake2sp_compress_fn
+blake2sp_compress_select (void)
+{
+#if defined(HA_IMP_X86_SIMD)
+  const unsigned features = ha_imp_blake2_features ();
+  const unsigned avx512vl = HA_CPU_AVX2 | HA_CPU_AVX512F | HA_CPU_AVX512VL;
+
+  if ((features & avx512vl) == avx512vl)
+    return ha_imp_blake2sp_compress_avx512vl;
+  if (features & HA_CPU_AVX2)
+    return ha_imp_blake2sp_compress_avx2;
+#endif
+  return blake2sp_compress_scalar;
+}
+
+HA_PRVFUN void
+blake2sp_compress (ha_blake2sp_context *ctx, const uint8_t *data, size_t n)
+{
+  static ha_imp_blake2sp_compress_fn fn = NULL;
+  if (!fn)
+    fn = blake2sp_compress_select ();
+  fn (ctx->h, data, n, ctx->t);
+  ctx->t += 64 * (uint64_t)n;
+}
+
+HA_PUBFUN void
+ha_blake2sp_init (ha_blake2sp_context *ctx, size_t digestlen)
+{
+  uint32_t leaf[8];
+  size_t i, l;
+
+  memset (ctx, 0, sizeof (*ctx));
+  /* a rejected length leaves outlen 0, for which final writes nothing */
+  if (!blake2s_lengths_valid (digestlen, 0))
+    return;
+  ctx->outlen = digestlen;
+  for (l = 0; l < BLAKE2SP_LEAVES; ++l)
+    {
+      blake2sp_node_init (leaf, digestlen, l, 0);
+      for (i = 0; i < 8; ++i)
+        ctx->h[i][l] = leaf[i];
+    }
+}
+
+HA_PUBFUN void
+ha_blake2sp_update (ha_blake2sp_context *ctx, ha_inbuf_t data, size_t len)
+{
+  size_t fill, n;
+
+  /* top the buffer up to two strides and compress the first one, and the
+     second too when more than a stride still follows */
+  if (ctx->buflen && ctx->buflen + len > 2 * BLAKE2SP_STRIDE)
+    {
+      fill = 2 * BLAKE2SP_STRIDE - ctx->buflen;
+      memcpy (ctx->buf + ctx->buflen, data, fill);
+      data += fill;
+      len -= fill;
+      n = len > BLAKE2SP_STRIDE ? 2 : 1;
+      blake2sp_compress (ctx, ctx->buf, n);
+      if (n == 1)
+        memcpy (ctx->buf, ctx->buf + BLAKE2SP_STRIDE, BLAKE2SP_STRIDE);
+      ctx->buflen = (2 - n) * BLAKE2SP_STRIDE;
+    }
+
+  /* straight from data: the strides with more than two from their start
+     on */
+  if (!ctx->buflen && len > 2 * BLAKE2SP_STRIDE)
+    {
+      n = (len - BLAKE2SP_STRIDE - 1) / BLAKE2SP_STRIDE;
+      blake2sp_compress (ctx, data, n);
+      data += n * BLAKE2SP_STRIDE;
+      len -= n * BLAKE2SP_STRIDE;
+    }
+
+  memcpy (ctx->buf + ctx->buflen, data, len);
+  ctx->buflen += len;
+}
+
+HA_PUBFUN void
+ha_blake2sp_final (ha_blake2sp_context *ctx, ha_digest_t digest)
+{
+  uint8_t leaves[BLAKE2SP_LEAVES * 32], block[64];
+  uint32_t leaf[8], t[2], f[2];
+  size_t blocks = (ctx->buflen + 63) / 64, i, k, l, len;
+
+  /* the init rejected the digest length */
+  if (!ctx->outlen)
+    return;
+
+  for (l = 0; l < BLAKE2SP_LEAVES; ++l)
+    {
+      for (i = 0; i < 8; ++i)
+        leaf[i] = ctx->h[i][l];
+      f[0] = f[1] = 0;
+      k = l;
+      if (k + BLAKE2SP_LEAVES < blocks)
+        {
+          blake2sp_counter (t, ctx->t + 64);
+          blake2s_compress (leaf, ctx->buf + 64 * k, t, f);
+          k += BLAKE2SP_LEAVES;
+        }
+
+      /* the leaf's last block, empty if the input never reached it */
+      len = ctx->buflen > 64 * k ? ctx->buflen - 64 * k : 0;
+      if (len > 64)
+        len = 64;
+      memset (block, 0, sizeof (block));
+      memcpy (block, ctx->buf + 64 * k, len);
+      blake2sp_counter (t, ctx->t + 64 * (k / BLAKE2SP_LEAVES) + len);
+      f[0] = ~0u;
+      f[1] = l == BLAKE2SP_LEAVES - 1 ? ~0u : 0;
+      blake2s_compress (leaf, block, t, f);
+      for (i = 0; i < 8; ++i)
+        store_le32 (leaves + 32 * l + 4 * i, leaf[i]);
+    }
+
+  blake2sp_node_init (leaf, ctx->outlen, 0, 1);
+  for (k = 0; k < sizeof (leaves) / 64; ++k)
+    {
+      blake2sp_counter (t, 64 * (k + 1));
+      f[0] = f[1] = k + 1 == sizeof (leaves) / 64 ? ~0u : 0;
+      blake2s_compress (leaf, leaves + 64 * k, t, f);
+    }
+  for (i = 0; i < 8; ++i)
+    store_le32 (leaves + 4 * i, leaf[i]);
+  memcpy (digest, leaves, ctx->outlen);
+}
+
+HA_PUBFUN void
+ha_blake2sp_hash (ha_inbuf_t data, size_t len, ha_digest_t digest,
+                  size_t digestlen)
+{
+  ha_blake2sp_context ctx;
+  ha_blake2sp_init (&ctx, digestlen);
+  ha_blake2sp_update (&ctx, data, len);
+  ha_blake2sp_final (&ctx, digest);
+}
+
+/*
+ * BLAKE2Xs: the root is a sequential BLAKE2s-256 with the output length
+ * in the upper 16 bits of the 48-bit node offset field. Output node i
+ * has fanout and depth 0, leaf and inner length 32, and node offset i in
+ * the lower 32 bits of that field.
+ */
+
+#define BLAKE2XS_LANES     HA_BLAKE2XS_LANES
+#define BLAKE2XS_NODE_SIZE HA_BLAKE2XS_NODE_SIZE
+
+static void
+blake2xs_nodes_scalar (uint32_t h[8][BLAKE2XS_LANES], const uint8_t block[64],
+                       size_t len)
+{
+  const uint32_t t[2] = { (uint32_t)len, 0 }, f[2] = { ~0U, 0 };
+  uint32_t node[8];
+  size_t i, l;
+
+  for (l = 0; l < BLAKE2XS_LANES; ++l)
+    {
+      for (i = 0; i < 8; ++i)
+        node[i] = h[i][l];
+      blake2s_compress (node, block, t, f);
+      for (i = 0; i < 8; ++i)
+        h[i][l] = node[i];
+    }
+}
+
+static ha_imp_blake2xs_nodes_fn
+blake2xs_nodes_select (void)
+{
+#if defined(HA_IMP_X86_SIMD)
+  const unsigned features = ha_imp_blake2_features ();
+  const unsigned avx512vl = HA_CPU_AVX2 | HA_CPU_AVX512F | HA_CPU_AVX512VL;
+
+  if ((features & avx512vl) == avx512vl)
+    return ha_imp_blake2xs_nodes_avx512vl;
+  if (features & HA_CPU_AVX2)
+    return ha_imp_blake2xs_nodes_avx2;
+#endif
+  return blake2xs_nodes_scalar;
+}
+
+HA_PRVFUN void
+blake2xs_nodes (uint32_t h[8][BLAKE2XS_LANES], const uint8_t block[64],
+                size_t len)
+{
+  static ha_imp_blake2xs_nodes_fn fn = NULL;
+  if (!fn)
+    fn = blake2xs_nodes_select ();
+  fn (h, block, len);
+}
+
+/* computes the output of the nodes from BLAKE2XS_LANES * group on into
+   ctx->buf */
+HA_PRVFUN void
+blake2xs_output (ha_blake2xs_context *ctx, uint64_t group)
+{
+  ha_blake2s_param param;
+  uint32_t h[8][BLAKE2XS_LANES], node[8];
+  uint64_t index, left;
+  size_t i, l;
+
+  ha_blake2s_param_init (&param, BLAKE2XS_NODE_SIZE);
+  param.fanout = 0;
+  param.depth = 0;
+  param.leaf_length = BLAKE2XS_NODE_SIZE;
+  param.inner_length = BLAKE2XS_NODE_SIZE;
+  for (l = 0; l < BLAKE2XS_LANES; ++l)
+    {
+      /* with a known length, the last node is the only short one */
+      index = group * BLAKE2XS_LANES + l;
+      left = ctx->xoflen - index * BLAKE2XS_NODE_SIZE;
+      param.digest_length = BLAKE2XS_NODE_SIZE;
+      if (ctx->xoflen != HA_BLAKE2XS_UNKNOWN_LENGTH
+          && index * BLAKE2XS_NODE_SIZE < ctx->xoflen
+          && left < BLAKE2XS_NODE_SIZE)
+        param.digest_length = (uint8_t)left;
+      param.node_offset = (uint64_t)ctx->xoflen << 32 | (uint32_t)index;
+      blake2s_param_load (node, &param);
+      for (i = 0; i < 8; ++i)
+        h[i][l] = node[i];
+    }
+
+  blake2xs_nodes (h, ctx->block, HA_BLAKE2S_DIGEST_SIZE);
+  for (l = 0; l < BLAKE2XS_LANES; ++l)
+    for (i = 0; i < 8; ++i)
+      store_le32 (ctx->buf + BLAKE2XS_NODE_SIZE * l + 4 * i, h[i][l]);
+  ctx->group = group;
+}
+
+HA_PUBFUN void
+ha_blake2xs_init_keyed (ha_blake2xs_context *ctx, ha_inbuf_t key,
+                        size_t keylen, size_t outlen)
+{
+  ha_blake2s_param param;
+
+  memset (ctx, 0, sizeof (*ctx));
+  if (!blake2s_lengths_valid (HA_BLAKE2S_DIGEST_SIZE, keylen))
+    return;
+  /* the unknown length is the largest value the field holds */
+  if (!outlen || outlen > HA_BLAKE2XS_UNKNOWN_LENGTH)
+    {
+      ha_throw_error (0, ha_curpos, g_ha_blake2s_error_strings[LENGTH_ERROR],
+                      "output", outlen);
+      return;
+    }
+  ctx->xoflen = (uint32_t)outlen;
+  ctx->group = UINT64_MAX;
+  ha_blake2s_param_init (&param, HA_BLAKE2S_DIGEST_SIZE);
+  param.key_length = (uint8_t)keylen;
+  param.node_offset = (uint64_t)ctx->xoflen << 32;
+  ha_blake2s_init_param (&ctx->root, &param, key);
+}
+
+HA_PUBFUN void
+ha_blake2xs_init (ha_blake2xs_context *ctx, size_t outlen)
+{
+  ha_blake2xs_init_keyed (ctx, NULL, 0, outlen);
+}
+
+HA_PUBFUN void
+ha_blake2xs_update (ha_blake2xs_context *ctx, ha_inbuf_t data, size_t len)
+{
+  ha_blake2s_update (&ctx->root, data, len);
+}
+
+HA_PUBFUN void
+ha_blake2xs_squeeze (ha_blake2xs_context *ctx, ha_digest_t out, size_t len)
+{
+  uint64_t group;
+  size_t off, n;
+
+  if (ctx->xoflen != HA_BLAKE2XS_UNKNOWN_LENGTH
+      && len > (ctx->pos < ctx->xoflen ? ctx->xoflen - ctx->pos : 0))
+    {
+      n = ctx->pos < ctx->xoflen ? (size_t)(ctx->xoflen - ctx->pos) : 0;
+      memset (out + n, 0, len - n);
+      len = n;
+    }
+
+  for (; len; out += n, len -= n, ctx->pos += n)
+    {
+      group = ctx->pos / sizeof (ctx->buf);
+      off = (size_t)(ctx->pos % sizeof (ctx->buf));
+      n = sizeof (ctx->buf) - off < len ? sizeof (ctx->buf) - off : len;
+      if (group != ctx->group)
+        blake2xs_output (ctx, group);
+      memcpy (out, ctx->buf + off, n);
+    }
+}
+
+HA_PUBFUN void
+ha_blake2xs_seek (ha_blake2xs_context *ctx, uint64_t pos)
+{
+  ctx->pos = pos;
+}
+
+HA_PUBFUN void
+ha_blake2xs_final (ha_blake2xs_context *ctx, ha_digest_t digest,
+                   size_t digestlen)
+{
+  if (!ctx->finalized)
+    {
+      ha_blake2s_final (&ctx->root, ctx->block, HA_BLAKE2S_DIGEST_SIZE);
+      ctx->finalized = true;
+    }
+  ctx->pos = 0;
+  ha_blake2xs_squeeze (ctx, digest, digestlen);
+}
+
+HA_PUBFUN void
+ha_blake2xs_hash (ha_inbuf_t data, size_t len, ha_digest_t digest,
+                  size_t digestlen)
+{
+  ha_blake2xs_context ctx;
+  ha_blake2xs_init (&ctx, digestlen);
+  ha_blake2xs_update (&ctx, data, len);
+  ha_blake2xs_final (&ctx, digest, digestlen);
+}
@@ -1,70 +1,61 @@
 #define HA_BUILD
 
 #include "../include/hasha/blake3.h"
-#include "../include/hasha/blake3_k.h"
 
-#define BLAKE3_FLAG_CHUNK_START (1u << 0)
-#define BLAKE3_FLAG_CHUNK_END (1u << 1)
-#define BLAKE3_FLAG_PARENT (1u << 2)
-#define BLAKE3_FLAG_ROOT (1u << 3)
+#include "./blake3.h"
+#include "./pool.h"
 
-HA_PRVFUN void
-blake3_compress (uint32_t *outbuf, const uint32_t m[static 16],
-                 const uint32_t h[static 8], uint64_t t, uint32_t b,
-                 uint32_t d)
-{
-  uint32_t v[16] = { h[0],
-                     h[1],
-                     h[2],
-                     h[3],
-                     h[4],
-                     h[5],
-                     h[6],
-                     h[7],
-                     HA_BLAKE3_H0[0],
-                     HA_BLAKE3_H0[1],
-                     HA_BLAKE3_H0[2],
-                     HA_BLAKE3_H0[3],
-                     t,
-                     t >> 32,
-                     b,
-                     d };
-  uint32_t i;
-
-  ha_primitive_blake32_round (HA_BLAKE3_SIMA, 0);
-  ha_primitive_blake32_round (HA_BLAKE3_SIMA, 1);
-  ha_primitive_blake32_round (HA_BLAKE3_SIMA, 2);
-  ha_primitive_blake32_round (HA_BLAKE3_SIMA, 3);
-  ha_primitive_blake32_round (HA_BLAKE3_SIMA, 4);
-  ha_primitive_blake32_round (HA_BLAKE3_SIMA, 5);
-  ha_primitive_blake32_round (HA_BLAKE3_SIMA, 6);
-
-  if (d & BLAKE3_FLAG_ROOT)
-    for (i = 8; i < 16; ++i)
-      outbuf[i] = v[i] ^ h[i - 8];
-  for (i = 0; i < 8; ++i)
-    outbuf[i] = v[i] ^ v[i + 8];
-}
+/* chunks hashed per ha_imp_blake3_hash_many () call */
+#define BLAKE3_MANY_BATCH 16
+
+/* ha_blake3_update_parallel (): a pool task hashes one subtree of
+   2^BLAKE3_TASK_LEVEL chunks, a pool job covers BLAKE3_JOB_TASKS of them */
+#define BLAKE3_TASK_LEVEL  8
+#define BLAKE3_TASK_CHUNKS (1u << BLAKE3_TASK_LEVEL)
+#define BLAKE3_JOB_TASKS   64
 
+/* the subtree of 2^level chunks whose chaining value is at ctx->cv is
+   complete: merges the subtrees it completes and opens the next chunk.
+   The subtree must start at a multiple of its size. */
 HA_PRVFUN void
-blake3_load (uint32_t d[static 16], const uint8_t s[static 64])
+blake3_subtree_done (ha_blake3_context *ctx, unsigned level)
 {
-  uint32_t *end;
+  uint32_t *cv = ctx->cv;
+  uint64_t t;
 
-  for (end = d + 16; d < end; ++d, s += 4)
+  ctx->block = 0;
+  ctx->chunk += (uint64_t)1 << level;
+  for (t = (ctx->chunk - ctx->chunk_offset) >> level; (t & 1) == 0; t >>= 1)
     {
-      *d = (uint32_t)s[0] | (uint32_t)s[1] << 8 | (uint32_t)s[2] << 16
-           | (uint32_t)s[3] << 24;
+      cv -= 8;
+      ha_imp_blake3_compress (cv, cv, ctx->key, 0, 64,
+                              ctx->flags | BLAKE3_FLAG_PARENT);
     }
+  cv += 8;
+  memcpy (cv, ctx->key, sizeof (ctx->key));
+  ctx->cv = cv;
+}
+
+HA_PRVFUN void
+blake3_chunk_done (ha_blake3_context *ctx)
+{
+  blake3_subtree_done (ctx, 0);
+}
+
+/* pushes the 32-byte chaining value of a subtree of 2^level chunks */
+HA_PRVFUN void
+blake3_push_cv (ha_blake3_context *ctx, const uint8_t *cv, unsigned level)
+{
+  ha_imp_blake3_load_cv (ctx->cv, cv);
+  blake3_subtree_done (ctx, level);
 }
 
 HA_PRVFUN void
 blake3_block (ha_blake3_context *ctx, const unsigned char *buf)
 {
   uint32_t m[16], flags, *cv = ctx->cv;
-  uint64_t t;
 
-  flags = 0;
+  flags = ctx->flags;
   switch (ctx->block)
     {
     case 0:
@@ -74,28 +65,115 @@ blake3_block (ha_blake3_context *ctx, const unsigned char *buf)
       flags |= BLAKE3_FLAG_CHUNK_END;
       break;
     }
-  blake3_load (m, buf);
-  blake3_compress (cv, m, cv, ctx->chunk, 64, flags);
+  ha_imp_blake3_load (m, buf);
+  ha_imp_blake3_compress (cv, m, cv, ctx->chunk, 64, flags);
   if (++ctx->block == 16)
+    blake3_chunk_done (ctx);
+}
+
+/* hashes nchunks whole chunks starting at a chunk boundary, side by side
+   in SIMD lanes, and pushes their chaining values in order */
+HA_PRVFUN void
+blake3_chunks (ha_blake3_context *ctx, const uint8_t *data, size_t nchunks)
+{
+  const uint8_t *inputs[BLAKE3_MANY_BATCH];
+  uint8_t cvs[BLAKE3_MANY_BATCH * 32];
+  size_t n, i;
+
+  for (; nchunks; nchunks -= n, data += n * BLAKE3_CHUNK_LEN)
     {
-      ctx->block = 0;
-      for (t = ++ctx->chunk; (t & 1) == 0; t >>= 1)
-        {
-          cv -= 8;
-          blake3_compress (cv, cv, HA_BLAKE3_H0, 0, 64, BLAKE3_FLAG_PARENT);
-        }
-      cv += 8;
-      memcpy (cv, HA_BLAKE3_H0, sizeof (HA_BLAKE3_H0));
+      n = nchunks < BLAKE3_MANY_BATCH ? nchunks : BLAKE3_MANY_BATCH;
+      for (i = 0; i < n; ++i)
+        inputs[i] = data + i * BLAKE3_CHUNK_LEN;
+      ha_imp_blake3_hash_many (inputs, n, BLAKE3_CHUNK_LEN / 64, ctx->key,
+                               ctx->chunk, 1, ctx->flags,
+                               BLAKE3_FLAG_CHUNK_START, BLAKE3_FLAG_CHUNK_END,
+                               cvs);
+      for (i = 0; i < n; ++i)
+        blake3_push_cv (ctx, cvs + 32 * i, 0);
+    }
+}
+
+struct blake3_job
+{
+  const uint8_t *data;
+  uint64_t chunk; /* counter of the first chunk at data */
+  const uint32_t *key;
+  uint32_t flags;
+  uint8_t *cvs;
+};
+
+/* hashes the task-th subtree of the job: its chunks side by side, then
+   each level of parents side by side until one chaining value is left */
+static void
+blake3_subtree_task (void *arg, size_t task)
+{
+  const struct blake3_job *job = arg;
+  const uint8_t *inputs[BLAKE3_TASK_CHUNKS];
+  uint8_t cvs[2][BLAKE3_TASK_CHUNKS * 32], *out;
+  const uint8_t *data
+      = job->data + (size_t)task * BLAKE3_TASK_CHUNKS * BLAKE3_CHUNK_LEN;
+  size_t n = BLAKE3_TASK_CHUNKS, i;
+  int cur = 0;
+
+  for (i = 0; i < n; ++i)
+    inputs[i] = data + i * BLAKE3_CHUNK_LEN;
+  ha_imp_blake3_hash_many (inputs, n, BLAKE3_CHUNK_LEN / 64, job->key,
+                           job->chunk + (uint64_t)task * BLAKE3_TASK_CHUNKS,
+                           1, job->flags, BLAKE3_FLAG_CHUNK_START,
+                           BLAKE3_FLAG_CHUNK_END, cvs[cur]);
+  for (; n > 1; cur = !cur)
+    {
+      n /= 2;
+      for (i = 0; i < n; ++i)
+        inputs[i] = cvs[cur] + 64 * i;
+      out = n > 1 ? cvs[!cur] : job->cvs + 32 * task;
+      ha_imp_blake3_hash_many (inputs, n, 1, job->key, 0, 0,
+                               job->flags | BLAKE3_FLAG_PARENT, 0, 0, out);
     }
-  ctx->cv = cv;
 }
 
 HA_PUBFUN void
 ha_blake3_init (ha_blake3_context *ctx)
 {
-  ctx->bytes = ctx->block = ctx->chunk = 0;
+  memcpy (ctx->key, HA_BLAKE3_H0, sizeof (ctx->key));
+  ctx->flags = 0;
+  ha_blake3_reset (ctx);
+}
+
+HA_PUBFUN void
+ha_blake3_init_keyed (ha_blake3_context *ctx,
+                      const uint8_t key[HA_BLAKE3_KEY_SIZE])
+{
+  ha_imp_blake3_load_cv (ctx->key, key);
+  ctx->flags = BLAKE3_FLAG_KEYED_HASH;
+  ha_blake3_reset (ctx);
+}
+
+HA_PUBFUN void
+ha_blake3_init_derive_key (ha_blake3_context *ctx, const char *context)
+{
+  uint8_t key[HA_BLAKE3_KEY_SIZE];
+
+  /* the context string is hashed on its own into the key that the key
+     material is then hashed with */
+  memcpy (ctx->key, HA_BLAKE3_H0, sizeof (ctx->key));
+  ctx->flags = BLAKE3_FLAG_DERIVE_KEY_CONTEXT;
+  ha_blake3_reset (ctx);
+  ha_blake3_update (ctx, (const uint8_t *)context, strlen (context));
+  ha_blake3_final (ctx, key, sizeof (key));
+
+  ha_imp_blake3_load_cv (ctx->key, key);
+  ctx->flags = BLAKE3_FLAG_DERIVE_KEY_MATERIAL;
+  ha_blake3_reset (ctx);
+}
+
+HA_PUBFUN void
+ha_blake3_reset (ha_blake3_context *ctx)
+{
+  ctx->bytes = ctx->block = ctx->chunk = ctx->chunk_offset = 0;
   ctx->cv = ctx->cv_buf;
-  memcpy (ctx->cv, HA_BLAKE3_H0, sizeof (HA_BLAKE3_H0));
+  memcpy (ctx->cv, ctx->key, sizeof (ctx->key));
 }
 
 HA_PUBFUN void
@@ -117,6 +195,16 @@ ha_blake3_update (ha_blake3_context *ctx, ha_inbuf_t data, size_t length)
       blake3_block (ctx, ctx->input);
     }
 
+  /* the last byte always stays buffered: the final block is compressed
+     by ha_blake3_final () */
+  for (; ctx->block && length > 64; pos += 64, length -= 64)
+    blake3_block (ctx, pos);
+  if (length > BLAKE3_CHUNK_LEN)
+    {
+      n = (length - 1) / BLAKE3_CHUNK_LEN;
+      blake3_chunks (ctx, pos, n);
+      pos += n * BLAKE3_CHUNK_LEN, length -= n * BLAKE3_CHUNK_LEN;
+    }
   for (; length > 64; pos += 64, length -= 64)
     blake3_block (ctx, pos);
   ctx->bytes = length;
@@ -124,43 +212,218 @@ ha_blake3_update (ha_blake3_context *ctx, ha_inbuf_t data, size_t length)
 }
 
 HA_PUBFUN void
-ha_blake3_final (ha_blake3_context *ctx, ha_digest_t digest, size_t length)
+ha_blake3_update_parallel (ha_blake3_context *ctx, ha_inbuf_t data,
+                           size_t length, ha_pool *pool)
 {
-  uint32_t f, b, x = 0, *in, *cv, m[16], root[16];
-  size_t i;
+  uint8_t cvs[BLAKE3_JOB_TASKS * 32];
+  const uint8_t *pos = data;
+  struct blake3_job job;
+  size_t n, i, j;
+
+  /* close the open chunk so that the subtrees start on a boundary; its
+     last block stays buffered until more input shows it is not final */
+  if (ctx->block || ctx->bytes)
+    {
+      n = BLAKE3_CHUNK_LEN - 64 * ctx->block - ctx->bytes;
+      if (length <= n)
+        {
+          ha_blake3_update (ctx, pos, length);
+          return;
+        }
+      ha_blake3_update (ctx, pos, n);
+      pos += n, length -= n;
+      blake3_block (ctx, ctx->input);
+      ctx->bytes = 0;
+    }
+
+  /* whole chunks up to the next task-sized boundary, then whole
+     subtrees, keeping the last byte back as ha_blake3_update () does */
+  n = length ? (length - 1) / BLAKE3_CHUNK_LEN : 0;
+  if (n >= BLAKE3_TASK_CHUNKS)
+    {
+      i = (size_t)(-ctx->chunk & (BLAKE3_TASK_CHUNKS - 1));
+      blake3_chunks (ctx, pos, i);
+      pos += i * BLAKE3_CHUNK_LEN, length -= i * BLAKE3_CHUNK_LEN;
+      n -= i;
+    }
+  for (job.cvs = cvs; n >= BLAKE3_TASK_CHUNKS;)
+    {
+      i = n / BLAKE3_TASK_CHUNKS;
+      if (i > BLAKE3_JOB_TASKS)
+        i = BLAKE3_JOB_TASKS;
+      job.data = pos;
+      job.chunk = ctx->chunk;
+      job.key = ctx->key;
+      job.flags = ctx->flags;
+      ha_imp_pool_run (pool, blake3_subtree_task, &job, i);
+
+      for (j = 0; j < i; ++j)
+        blake3_push_cv (ctx, cvs + 32 * j, BLAKE3_TASK_LEVEL);
+      pos += i * BLAKE3_TASK_CHUNKS * BLAKE3_CHUNK_LEN;
+      length -= i * BLAKE3_TASK_CHUNKS * BLAKE3_CHUNK_LEN;
+      n -= i * BLAKE3_TASK_CHUNKS;
+    }
+  ha_blake3_update (ctx, pos, length);
+}
+
+HA_PUBFUN void
+ha_blake3_finalize_xof (ha_blake3_context *ctx, ha_blake3_xof_reader *reader)
+{
+  uint32_t f, *cv = ctx->cv;
 
-  cv = ctx->cv;
   memset (ctx->input + ctx->bytes, 0, 64 - ctx->bytes);
-  blake3_load (m, ctx->input);
-  f = BLAKE3_FLAG_CHUNK_END;
+  ha_imp_blake3_load (reader->block, ctx->input);
+  f = ctx->flags | BLAKE3_FLAG_CHUNK_END;
   if (ctx->block == 0)
     f |= BLAKE3_FLAG_CHUNK_START;
   if (cv == ctx->cv_buf)
     {
-      b = ctx->bytes;
-      in = m;
+      /* a single chunk: its last block is the root */
+      reader->length = ctx->bytes;
+      memcpy (reader->cv, cv, sizeof (reader->cv));
     }
   else
     {
-      blake3_compress (cv, m, cv, ctx->chunk, ctx->bytes, f);
-      f = BLAKE3_FLAG_PARENT;
+      /* merge the stack down to the two children of the root */
+      ha_imp_blake3_compress (cv, reader->block, cv, ctx->chunk, ctx->bytes,
+                              f);
+      f = ctx->flags | BLAKE3_FLAG_PARENT;
       while ((cv -= 8) != ctx->cv_buf)
-        blake3_compress (cv, cv, HA_BLAKE3_H0, 0, 64, f);
-      b = 64;
-      in = cv;
-      cv = (uint32_t *)HA_BLAKE3_H0;
+        ha_imp_blake3_compress (cv, cv, ctx->key, 0, 64, f);
+      reader->length = 64;
+      memcpy (reader->block, cv, sizeof (reader->block));
+      memcpy (reader->cv, ctx->key, sizeof (reader->cv));
+    }
+  reader->flags = f | BLAKE3_FLAG_ROOT;
+  reader->offset = 0;
+}
+
+HA_PUBFUN void
+ha_blake3_xof_read (ha_blake3_xof_reader *reader, ha_digest_t out,
+                    size_t length)
+{
+  size_t n, pos = (size_t)(reader->offset & 63);
+
+  if (pos)
+    {
+      n = 64 - pos;
+      if (n > length)
+        n = length;
+      memcpy (out, reader->buf + pos, n);
+      out += n, length -= n;
+      reader->offset += n;
+    }
+  if ((n = length / 64))
+    {
+      ha_imp_blake3_xof_many (reader->cv, reader->block, reader->length,
+                              reader->flags, reader->offset >> 6, n, out);
+      out += 64 * n, length -= 64 * n;
+      reader->offset += 64 * n;
     }
-  f |= BLAKE3_FLAG_ROOT;
-  for (i = 0; i < length; ++i, ++digest, x >>= 8)
+  if (length)
     {
-      if ((i & 63) == 0)
-        blake3_compress (root, in, cv, i >> 6, b, f);
-      if ((i & 3) == 0)
-        x = root[i >> 2 & 15];
-      *digest = x & 0xff;
+      ha_imp_blake3_xof_many (reader->cv, reader->block, reader->length,
+                              reader->flags, reader->offset >> 6, 1,
+                              reader->buf);
+      memcpy (out, reader->buf, length);
+      reader->offset += length;
     }
 }
 
+HA_PUBFUN void
+ha_blake3_xof_seek (ha_blake3_xof_reader *reader, uint64_t offset)
+{
+  reader->offset = offset;
+  if (offset & 63)
+    ha_imp_blake3_xof_many (reader->cv, reader->block, reader->length,
+                            reader->flags, offset >> 6, 1, reader->buf);
+}
+
+HA_PUBFUN void
+ha_blake3_set_input_offset (ha_blake3_context *ctx, uint64_t offset)
+{
+  ctx->chunk = ctx->chunk_offset = offset / BLAKE3_CHUNK_LEN;
+}
+
+HA_PUBFUN void
+ha_blake3_finalize_subtree (ha_blake3_context *ctx,
+                            uint8_t cv[HA_BLAKE3_CV_SIZE])
+{
+  ha_blake3_xof_reader reader;
+  uint64_t counter = ctx->cv == ctx->cv_buf ? ctx->chunk : 0;
+  uint32_t out[16];
+  size_t i;
+
+  /* the node that would have been the root, compressed as an inner one:
+     a lone chunk keeps its own counter */
+  ha_blake3_finalize_xof (ctx, &reader);
+  ha_imp_blake3_compress (out, reader.block, reader.cv, counter,
+                          reader.length, reader.flags & ~BLAKE3_FLAG_ROOT);
+  for (i = 0; i < 8; ++i)
+    store_le32 (cv + 4 * i, out[i]);
+}
+
+/* the message block of the parent of the n >= 2 subtrees whose chaining
+   values are at cvs: the left child takes the largest power of two of
+   them below n, as the chunks are split */
+static void
+blake3_merge_block (const ha_blake3_context *ctx, const uint8_t *cvs,
+                    size_t n, uint32_t block[16])
+{
+  uint32_t m[16];
+  size_t left = 1, i;
+
+  while (left * 2 < n)
+    left *= 2;
+  for (i = 0; i < 2; ++i)
+    {
+      size_t first = i ? left : 0, count = i ? n - left : left;
+
+      if (count == 1)
+        ha_imp_blake3_load_cv (block + 8 * i, cvs + 32 * first);
+      else
+        {
+          blake3_merge_block (ctx, cvs + 32 * first, count, m);
+          ha_imp_blake3_compress (block + 8 * i, m, ctx->key, 0, 64,
+                                  ctx->flags | BLAKE3_FLAG_PARENT);
+        }
+    }
+}
+
+HA_PUBFUN void
+ha_blake3_merge_subtrees (const ha_blake3_context *ctx, const uint8_t *cvs,
+                          size_t n, uint8_t cv[HA_BLAKE3_CV_SIZE])
+{
+  uint32_t block[16];
+  size_t i;
+
+  blake3_merge_block (ctx, cvs, n, block);
+  ha_imp_blake3_compress (block, block, ctx->key, 0, 64,
+                          ctx->flags | BLAKE3_FLAG_PARENT);
+  for (i = 0; i < 8; ++i)
+    store_le32 (cv + 4 * i, block[i]);
+}
+
+HA_PUBFUN void
+ha_blake3_merge_root (const ha_blake3_context *ctx, const uint8_t *cvs,
+                      size_t n, ha_blake3_xof_reader *reader)
+{
+  blake3_merge_block (ctx, cvs, n, reader->block);
+  memcpy (reader->cv, ctx->key, sizeof (reader->cv));
+  reader->length = 64;
+  reader->flags = ctx->flags | BLAKE3_FLAG_PARENT | BLAKE3_FLAG_ROOT;
+  reader->offset = 0;
+}
+
+HA_PUBFUN void
+ha_blake3_final (ha_blake3_context *ctx, ha_digest_t digest, size_t length)
+{
+  ha_blake3_xof_reader reader;
+
+  ha_blake3_finalize_xof (ctx, &reader);
+  ha_blake3_xof_read (&reader, digest, length);
+}
+
 HA_PUBFUN void
 ha_blake3_hash (ha_inbuf_t data, size_t length, ha_digest_t digest,
                 size_t digest_length)
@@ -169,4 +432,14 @@ ha_blake3_hash (ha_inbuf_t data, size_t length, ha_digest_t digest,
   ha_blake3_init (&ctx);
   ha_blake3_update (&ctx, data, length);
   ha_blake3_final (&ctx, digest, digest_length);
+}
+
+HA_PUBFUN void
+ha_blake3_keyed_hash (const uint8_t key[HA_BLAKE3_KEY_SIZE], ha_inbuf_t data,
+                      size_t length, ha_digest_t digest, size_t digest_length)
+{
+  ha_blake3_context ctx;
+  ha_blake3_init_keyed (&ctx, key);
+  ha_blake3_update (&ctx, data, length);
+  ha_blake3_final (&ctx, digest, digest_length);
 }
\ No newline at end of file
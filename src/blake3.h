@@ -0,0 +1,99 @@
+#ifndef __hasha_imp_blake3_h
+#define __hasha_imp_blake3_h
+
+#include "../include/hasha/blake3.h"
+#include "../include/hasha/blake3_k.h"
+
+#include "./endian.h"
+
+#define BLAKE3_FLAG_CHUNK_START (1u << 0)
+#define BLAKE3_FLAG_CHUNK_END (1u << 1)
+#define BLAKE3_FLAG_PARENT (1u << 2)
+#define BLAKE3_FLAG_ROOT (1u << 3)
+#define BLAKE3_FLAG_KEYED_HASH (1u << 4)
+#define BLAKE3_FLAG_DERIVE_KEY_CONTEXT (1u << 5)
+#define BLAKE3_FLAG_DERIVE_KEY_MATERIAL (1u << 6)
+
+#define BLAKE3_BLOCK_LEN 64
+#define BLAKE3_CHUNK_LEN HA_BLAKE3_CHUNK_SIZE
+
+HA_PRVFUN void
+ha_imp_blake3_compress (uint32_t *outbuf, const uint32_t m[static 16],
+                        const uint32_t h[static 8], uint64_t t, uint32_t b,
+                        uint32_t d)
+{
+  uint32_t v[16] = { h[0],
+                     h[1],
+                     h[2],
+                     h[3],
+                     h[4],
+                     h[5],
+                     h[6],
+                     h[7],
+                     HA_BLAKE3_H0[0],
+                     HA_BLAKE3_H0[1],
+                     HA_BLAKE3_H0[2],
+                     HA_BLAKE3_H0[3],
+                     t,
+                     t >> 32,
+                     b,
+                     d };
+  uint32_t i;
+
+  ha_primitive_blake32_round (HA_BLAKE3_SIMA, 0);
+  ha_primitive_blake32_round (HA_BLAKE3_SIMA, 1);
+  ha_primitive_blake32_round (HA_BLAKE3_SIMA, 2);
+  ha_primitive_blake32_round (HA_BLAKE3_SIMA, 3);
+  ha_primitive_blake32_round (HA_BLAKE3_SIMA, 4);
+  ha_primitive_blake32_round (HA_BLAKE3_SIMA, 5);
+  ha_primitive_blake32_round (HA_BLAKE3_SIMA, 6);
+
+  if (d & BLAKE3_FLAG_ROOT)
+    for (i = 8; i < 16; ++i)
+      outbuf[i] = v[i] ^ h[i - 8];
+  for (i = 0; i < 8; ++i)
+    outbuf[i] = v[i] ^ v[i + 8];
+}
+
+HA_PRVFUN void
+ha_imp_blake3_load (uint32_t d[static 16], const uint8_t s[static 64])
+{
+  uint32_t *end;
+
+  for (end = d + 16; d < end; ++d, s += 4)
+    {
+      *d = (uint32_t)s[0] | (uint32_t)s[1] << 8 | (uint32_t)s[2] << 16
+           | (uint32_t)s[3] << 24;
+    }
+}
+
+HA_PRVFUN void
+ha_imp_blake3_load_cv (uint32_t d[static 8], const uint8_t s[static 32])
+{
+  size_t i;
+
+  for (i = 0; i < 8; ++i)
+    d[i] = load_le32 (s + 4 * i);
+}
+
+/* Hashes n inputs of `blocks' whole blocks each from chaining value key,
+   input i with counter + i when increment is set (chunks) and counter
+   otherwise (parents), and writes their 32-byte chaining values to out
+   one after another. flags go on every block, flags_start on the first
+   and flags_end on the last. Runs of 16, 8 and 4 inputs share SIMD
+   lanes where the CPU allows. */
+void ha_imp_blake3_hash_many (const uint8_t *const *inputs, size_t n,
+                              size_t blocks, const uint32_t key[8],
+                              uint64_t counter, int increment,
+                              uint32_t flags, uint32_t flags_start,
+                              uint32_t flags_end, uint8_t *out);
+
+/* Writes the 64-byte root output blocks counter .. counter + n - 1 of
+   the root node with message block, chaining value cv, block length len
+   and flags (BLAKE3_FLAG_ROOT implied) to out, runs of 16, 8 and 4
+   blocks side by side in SIMD lanes. */
+void ha_imp_blake3_xof_many (const uint32_t cv[8], const uint32_t block[16],
+                             uint32_t len, uint32_t flags, uint64_t counter,
+                             size_t n, uint8_t *out);
+
+#endif
@@ -0,0 +1,318 @@
+#define HA_BUILD
+
+#include "./blake3.h"
+#include "./cpu.h"
+#include "./endian.h"
+
+/*
+ * BLAKE3 over several inputs at once, input l in lane l of 4 (SSE4.1),
+ * 8 (AVX2) or 16 (AVX-512) 32-bit lane vectors. As in the x4 keccak
+ * kernels the scalar round macro runs unchanged on the vector type.
+ *
+ * The message words arrive row-wise (one input per row), so each block
+ * is loaded as a square of `lanes' rows of `lanes' words and transposed
+ * by log2 (lanes) perfect shuffles: pairing row i with row i + lanes/2
+ * and interleaving them rotates the (row, column) bit index by one, and
+ * log2 (lanes) such rotations swap row and column.
+ *
+ * The G function is the primitive one with the rotations by 16 and 8
+ * left to the kernel: SSE4.1 and AVX2 have no 32-bit rotate, and moving
+ * bytes with one pshufb beats two shifts and an or, while AVX-512F
+ * rotates any amount with vprord.
+ */
+
+#if defined(HA_IMP_X86_SIMD)
+
+typedef uint32_t blake3_v4 __attribute__ ((vector_size (16)));
+typedef uint32_t blake3_v8 __attribute__ ((vector_size (32)));
+typedef uint32_t blake3_v16 __attribute__ ((vector_size (64)));
+
+#define BLAKE3_LO4 { 0, 4, 1, 5 }
+#define BLAKE3_HI4 { 2, 6, 3, 7 }
+#define BLAKE3_LO8 { 0, 8, 1, 9, 2, 10, 3, 11 }
+#define BLAKE3_HI8 { 4, 12, 5, 13, 6, 14, 7, 15 }
+#define BLAKE3_LO16                                                           \
+  { 0, 16, 1, 17, 2, 18, 3, 19, 4, 20, 5, 21, 6, 22, 7, 23 }
+#define BLAKE3_HI16                                                           \
+  { 8, 24, 9, 25, 10, 26, 11, 27, 12, 28, 13, 29, 14, 30, 15, 31 }
+
+#define BLAKE3_ROTR(x, n) (((x) >> (n)) | ((x) << (32 - (n))))
+
+#define BLAKE3_MANY_G(sigmatb, r, i, a, b, c, d)                              \
+  a += b + m[sigmatb[r][2 * i + 0]];                                          \
+  d = BLAKE3_ROTR16 (d ^ a);                                                  \
+  c += d;                                                                     \
+  b = BLAKE3_ROTR (b ^ c, 12);                                                \
+  a += b + m[sigmatb[r][2 * i + 1]];                                          \
+  d = BLAKE3_ROTR8 (d ^ a);                                                   \
+  c += d;                                                                     \
+  b = BLAKE3_ROTR (b ^ c, 7);
+
+#define BLAKE3_MANY_ROUND(i)                                                  \
+  ha_primitive_blake_round (HA_BLAKE3_SIMA, BLAKE3_MANY_G, i)
+
+typedef uint8_t blake3_b16 __attribute__ ((vector_size (16)));
+typedef uint8_t blake3_b32 __attribute__ ((vector_size (32)));
+
+#define BLAKE3_R16_B16                                                        \
+  { 2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13 }
+#define BLAKE3_R8_B16                                                         \
+  { 1, 2, 3, 0, 5, 6, 7, 4, 9, 10, 11, 8, 13, 14, 15, 12 }
+#define BLAKE3_R16_B32                                                        \
+  { 2,  3,  0,  1,  6,  7,  4,  5,  10, 11, 8,  9,  14, 15, 12, 13,           \
+    18, 19, 16, 17, 22, 23, 20, 21, 26, 27, 24, 25, 30, 31, 28, 29 }
+#define BLAKE3_R8_B32                                                         \
+  { 1,  2,  3,  0,  5,  6,  7,  4,  9,  10, 11, 8,  13, 14, 15, 12,           \
+    17, 18, 19, 16, 21, 22, 23, 20, 25, 26, 27, 24, 29, 30, 31, 28 }
+
+/* transposes the lanes x lanes square r, t is scratch; i and s are
+   counters and lomask and himask the shuffles of the kernel */
+#define BLAKE3_TRANSPOSE(r, t, lanes)                                         \
+  for (s = 1; s < (lanes); s <<= 1)                                           \
+    {                                                                         \
+      for (i = 0; i < (lanes) / 2; ++i)                                       \
+        {                                                                     \
+          t[2 * i] = __builtin_shuffle (r[i], r[i + (lanes) / 2], lomask);    \
+          t[2 * i + 1]                                                        \
+              = __builtin_shuffle (r[i], r[i + (lanes) / 2], himask);         \
+        }                                                                     \
+      memcpy (r, t, sizeof (r));                                              \
+    }
+
+#define BLAKE3_MANY_KERNEL(name, vec, lanes, isa, lo, hi)                     \
+  HA_IMP_TARGET (isa)                                                         \
+  static void name (const uint8_t *const *inputs, size_t blocks,              \
+                    const uint32_t key[8], uint64_t counter, int increment,   \
+                    uint32_t flags, uint32_t flags_start, uint32_t flags_end, \
+                    uint8_t *out)                                             \
+  {                                                                           \
+    const vec lomask = lo, himask = hi;                                       \
+    vec h[8], m[16], v[16], t_lo, t_hi;                                       \
+    size_t b, i, l, w, s;                                                     \
+                                                                              \
+    for (i = 0; i < 8; ++i)                                                   \
+      h[i] = (vec){ 0 } + key[i];                                             \
+    for (l = 0; l < lanes; ++l)                                               \
+      {                                                                       \
+        uint64_t c = counter + (increment ? l : 0);                           \
+        t_lo[l] = (uint32_t)c;                                                \
+        t_hi[l] = (uint32_t)(c >> 32);                                        \
+      }                                                                       \
+                                                                              \
+    for (b = 0; b < blocks; ++b)                                              \
+      {                                                                       \
+        uint32_t d = flags;                                                   \
+                                                                              \
+        if (b == 0)                                                           \
+          d |= flags_start;                                                   \
+        if (b + 1 == blocks)                                                  \
+          d |= flags_end;                                                     \
+                                                                              \
+        for (w = 0; w < 16; w += lanes)                                       \
+          {                                                                   \
+            vec r[lanes], t[lanes];                                           \
+                                                                              \
+            for (l = 0; l < lanes; ++l)                                       \
+              memcpy (&r[l], inputs[l] + BLAKE3_BLOCK_LEN * b + 4 * w,        \
+                      sizeof (vec));                                          \
+            BLAKE3_TRANSPOSE (r, t, lanes);                                   \
+            memcpy (m + w, r, sizeof (r));                                    \
+          }                                                                   \
+                                                                              \
+        for (i = 0; i < 8; ++i)                                               \
+          v[i] = h[i];                                                        \
+        for (i = 0; i < 4; ++i)                                               \
+          v[i + 8] = (vec){ 0 } + HA_BLAKE3_H0[i];                            \
+        v[12] = t_lo;                                                         \
+        v[13] = t_hi;                                                         \
+        v[14] = (vec){ 0 } + BLAKE3_BLOCK_LEN;                                \
+        v[15] = (vec){ 0 } + d;                                               \
+                                                                              \
+        BLAKE3_MANY_ROUND (0);                                                \
+        BLAKE3_MANY_ROUND (1);                                                \
+        BLAKE3_MANY_ROUND (2);                                                \
+        BLAKE3_MANY_ROUND (3);                                                \
+        BLAKE3_MANY_ROUND (4);                                                \
+        BLAKE3_MANY_ROUND (5);                                                \
+        BLAKE3_MANY_ROUND (6);                                                \
+                                                                              \
+        for (i = 0; i < 8; ++i)                                               \
+          h[i] = v[i] ^ v[i + 8];                                             \
+      }                                                                       \
+                                                                              \
+    for (l = 0; l < lanes; ++l)                                               \
+      for (i = 0; i < 8; ++i)                                                 \
+        store_le32 (out + 32 * l + 4 * i, h[i][l]);                           \
+  }
+
+/* root output blocks counter .. counter + lanes - 1: the same message
+   and chaining value in every lane, the counter differing */
+#define BLAKE3_XOF_KERNEL(name, vec, lanes, isa, lo, hi)                      \
+  HA_IMP_TARGET (isa)                                                         \
+  static void name (const uint32_t cv[8], const uint32_t block[16],           \
+                    uint32_t len, uint32_t flags, uint64_t counter,           \
+                    uint8_t *out)                                             \
+  {                                                                           \
+    const vec lomask = lo, himask = hi;                                       \
+    vec m[16], v[16], r[lanes], t[lanes];                                     \
+    size_t i, l, w, s;                                                        \
+                                                                              \
+    for (i = 0; i < 16; ++i)                                                  \
+      m[i] = (vec){ 0 } + block[i];                                           \
+    for (i = 0; i < 8; ++i)                                                   \
+      v[i] = (vec){ 0 } + cv[i];                                              \
+    for (i = 0; i < 4; ++i)                                                   \
+      v[i + 8] = (vec){ 0 } + HA_BLAKE3_H0[i];                                \
+    for (l = 0; l < lanes; ++l)                                               \
+      {                                                                       \
+        v[12][l] = (uint32_t)(counter + l);                                   \
+        v[13][l] = (uint32_t)((counter + l) >> 32);                           \
+      }                                                                       \
+    v[14] = (vec){ 0 } + len;                                                 \
+    v[15] = (vec){ 0 } + flags;                                               \
+                                                                              \
+    BLAKE3_MANY_ROUND (0);                                                    \
+    BLAKE3_MANY_ROUND (1);                                                    \
+    BLAKE3_MANY_ROUND (2);                                                    \
+    BLAKE3_MANY_ROUND (3);                                                    \
+    BLAKE3_MANY_ROUND (4);                                                    \
+    BLAKE3_MANY_ROUND (5);                                                    \
+    BLAKE3_MANY_ROUND (6);                                                    \
+                                                                              \
+    for (i = 0; i < 8; ++i)                                                   \
+      {                                                                       \
+        v[i] ^= v[i + 8];                                                     \
+        v[i + 8] ^= (vec){ 0 } + cv[i];                                       \
+      }                                                                       \
+    for (w = 0; w < 16; w += lanes)                                           \
+      {                                                                       \
+        memcpy (r, v + w, sizeof (r));                                        \
+        BLAKE3_TRANSPOSE (r, t, lanes);                                       \
+        for (l = 0; l < lanes; ++l)                                           \
+          memcpy (out + 64 * l + 4 * w, &r[l], sizeof (vec));                 \
+      }                                                                       \
+  }
+
+#define BLAKE3_ROTR16(x)                                                      \
+  ((blake3_v4)__builtin_shuffle ((blake3_b16)(x),                             \
+                                 (blake3_b16)BLAKE3_R16_B16))
+#define BLAKE3_ROTR8(x)                                                       \
+  ((blake3_v4)__builtin_shuffle ((blake3_b16)(x), (blake3_b16)BLAKE3_R8_B16))
+BLAKE3_MANY_KERNEL (blake3_many_sse41, blake3_v4, 4, "sse4.1", BLAKE3_LO4,
+                    BLAKE3_HI4)
+BLAKE3_XOF_KERNEL (blake3_xof_sse41, blake3_v4, 4, "sse4.1", BLAKE3_LO4,
+                   BLAKE3_HI4)
+#undef BLAKE3_ROTR16
+#undef BLAKE3_ROTR8
+
+#define BLAKE3_ROTR16(x)                                                      \
+  ((blake3_v8)__builtin_shuffle ((blake3_b32)(x),                             \
+                                 (blake3_b32)BLAKE3_R16_B32))
+#define BLAKE3_ROTR8(x)                                                       \
+  ((blake3_v8)__builtin_shuffle ((blake3_b32)(x), (blake3_b32)BLAKE3_R8_B32))
+BLAKE3_MANY_KERNEL (blake3_many_avx2, blake3_v8, 8, "avx2", BLAKE3_LO8,
+                    BLAKE3_HI8)
+BLAKE3_XOF_KERNEL (blake3_xof_avx2, blake3_v8, 8, "avx2", BLAKE3_LO8,
+                   BLAKE3_HI8)
+#undef BLAKE3_ROTR16
+#undef BLAKE3_ROTR8
+
+#define BLAKE3_ROTR16(x) BLAKE3_ROTR (x, 16)
+#define BLAKE3_ROTR8(x)  BLAKE3_ROTR (x, 8)
+BLAKE3_MANY_KERNEL (blake3_many_avx512, blake3_v16, 16, "avx512f",
+                    BLAKE3_LO16, BLAKE3_HI16)
+BLAKE3_XOF_KERNEL (blake3_xof_avx512, blake3_v16, 16, "avx512f",
+                   BLAKE3_LO16, BLAKE3_HI16)
+#undef BLAKE3_ROTR16
+#undef BLAKE3_ROTR8
+
+#endif
+
+HA_PRVFUN void
+blake3_hash_one (const uint8_t *input, size_t blocks, const uint32_t key[8],
+                 uint64_t counter, uint32_t flags, uint32_t flags_start,
+                 uint32_t flags_end, uint8_t *out)
+{
+  uint32_t cv[16], m[16], d; /* 16: a ROOT block writes 16 words */
+  size_t b;
+
+  memcpy (cv, key, 8 * sizeof (*cv));
+  for (b = 0; b < blocks; ++b, input += BLAKE3_BLOCK_LEN)
+    {
+      d = flags;
+      if (b == 0)
+        d |= flags_start;
+      if (b + 1 == blocks)
+        d |= flags_end;
+      ha_imp_blake3_load (m, input);
+      ha_imp_blake3_compress (cv, m, cv, counter, BLAKE3_BLOCK_LEN, d);
+    }
+  for (b = 0; b < 8; ++b)
+    store_le32 (out + 4 * b, cv[b]);
+}
+
+void
+ha_imp_blake3_hash_many (const uint8_t *const *inputs, size_t n,
+                         size_t blocks, const uint32_t key[8],
+                         uint64_t counter, int increment, uint32_t flags,
+                         uint32_t flags_start, uint32_t flags_end,
+                         uint8_t *out)
+{
+#if defined(HA_IMP_X86_SIMD)
+#define BLAKE3_MANY_RUN(kernel, lanes)                                        \
+  for (; n >= (lanes); n -= (lanes), inputs += (lanes), out += 32 * (lanes))  \
+    {                                                                         \
+      kernel (inputs, blocks, key, counter, increment, flags, flags_start,    \
+              flags_end, out);                                                \
+      if (increment)                                                          \
+        counter += (lanes);                                                   \
+    }
+
+  if (ha_imp_cpu_has (HA_CPU_AVX512F))
+    BLAKE3_MANY_RUN (blake3_many_avx512, 16);
+  if (ha_imp_cpu_has (HA_CPU_AVX2))
+    BLAKE3_MANY_RUN (blake3_many_avx2, 8);
+  if (ha_imp_cpu_has (HA_CPU_SSE41))
+    BLAKE3_MANY_RUN (blake3_many_sse41, 4);
+#undef BLAKE3_MANY_RUN
+#endif
+
+  for (; n; --n, ++inputs, out += 32)
+    {
+      blake3_hash_one (*inputs, blocks, key, counter, flags, flags_start,
+                       flags_end, out);
+      if (increment)
+        ++counter;
+    }
+}
+
+void
+ha_imp_blake3_xof_many (const uint32_t cv[8], const uint32_t block[16],
+                        uint32_t len, uint32_t flags, uint64_t counter,
+                        size_t n, uint8_t *out)
+{
+  uint32_t words[16];
+  size_t i;
+
+  flags |= BLAKE3_FLAG_ROOT;
+#if defined(HA_IMP_X86_SIMD)
+#define BLAKE3_XOF_RUN(kernel, lanes)                                         \
+  for (; n >= (lanes); n -= (lanes), counter += (lanes), out += 64 * (lanes)) \
+    kernel (cv, block, len, flags, counter, out);
+
+  if (ha_imp_cpu_has (HA_CPU_AVX512F))
+    BLAKE3_XOF_RUN (blake3_xof_avx512, 16);
+  if (ha_imp_cpu_has (HA_CPU_AVX2))
+    BLAKE3_XOF_RUN (blake3_xof_avx2, 8);
+  if (ha_imp_cpu_has (HA_CPU_SSE41))
+    BLAKE3_XOF_RUN (blake3_xof_sse41, 4);
+#undef BLAKE3_XOF_RUN
+#endif
+
+  for (; n; --n, ++counter, out += 64)
+    {
+      ha_imp_blake3_compress (words, block, cv, counter, len, flags);
+      for (i = 0; i < 16; ++i)
+        store_le32 (out + 4 * i, words[i]);
+    }
+}
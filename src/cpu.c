@@ -0,0 +1,83 @@
+#define HA_BUILD
+
+#include "./cpu.h"
+
+#if defined(HA_IMP_X86_SIMD)
+#include <cpuid.h>
+
+static uint64_t
+cpu_xgetbv (void)
+{
+  uint32_t lo, hi;
+  __asm__ volatile ("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+  return ((uint64_t)hi << 32) | lo;
+}
+
+static unsigned
+cpu_detect (void)
+{
+  unsigned a, b, c, d, features = 0;
+  uint64_t xcr0 = 0;
+
+  if (!__get_cpuid (1, &a, &b, &c, &d))
+    return 0;
+
+  if (c & bit_SSSE3)
+    features |= HA_CPU_SSSE3;
+  if (c & bit_SSE4_1)
+    features |= HA_CPU_SSE41;
+
+  /* the OS must save the ymm/zmm registers before AVX may be used */
+  if ((c & bit_OSXSAVE) && (c & bit_AVX))
+    {
+      xcr0 = cpu_xgetbv ();
+      if ((xcr0 & 0x6) == 0x6)
+        features |= HA_CPU_AVX;
+    }
+
+  if (!__get_cpuid_count (7, 0, &a, &b, &c, &d))
+    return features;
+
+  if (b & bit_SHA)
+    features |= HA_CPU_SHA;
+  if (b & bit_BMI)
+    features |= HA_CPU_BMI1;
+  if (b & bit_BMI2)
+    features |= HA_CPU_BMI2;
+  if ((features & HA_CPU_AVX) && (b & bit_AVX2))
+    features |= HA_CPU_AVX2;
+  if ((features & HA_CPU_AVX) && (xcr0 & 0xe0) == 0xe0)
+    {
+      if (b & bit_AVX512F)
+        features |= HA_CPU_AVX512F;
+      if ((b & bit_AVX512F) && (b & bit_AVX512VL))
+        features |= HA_CPU_AVX512VL;
+    }
+
+  return features;
+}
+
+#else
+
+static unsigned
+cpu_detect (void)
+{
+  return 0;
+}
+
+#endif
+
+unsigned
+ha_imp_cpu_features (void)
+{
+  /* racing first calls store the same value */
+  static volatile int detected = 0;
+  static volatile unsigned features = 0;
+
+  if (!detected)
+    {
+      features = cpu_detect ();
+      detected = 1;
+    }
+  return features;
+}
@@ -0,0 +1,42 @@
+#ifndef __hasha_imp_cpu_h
+#define __hasha_imp_cpu_h
+
+#include "../include/hasha/internal/internal.h"
+
+/* x86 SIMD kernels are built with per-function target attributes, so they
+   do not depend on -march; compilers without intrinsics support (tcc,
+   chibicc) only get the scalar code. */
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)          \
+    && !defined(__TINYC__) && !defined(HA_NO_SIMD)
+#define HA_IMP_X86_SIMD 1
+#endif
+
+#if defined(HA_IMP_X86_SIMD)
+#define HA_IMP_TARGET(isa) __attribute__ ((target (isa)))
+#else
+#define HA_IMP_TARGET(isa)
+#endif
+
+enum ha_imp_cpu_feature
+{
+  HA_CPU_SSSE3 = 1u << 0,
+  HA_CPU_SSE41 = 1u << 1,
+  HA_CPU_AVX = 1u << 2,
+  HA_CPU_AVX2 = 1u << 3,
+  HA_CPU_BMI2 = 1u << 4,
+  HA_CPU_SHA = 1u << 5,
+  HA_CPU_AVX512F = 1u << 6,
+  HA_CPU_AVX512VL = 1u << 7,
+  HA_CPU_BMI1 = 1u << 8,
+};
+
+/* Detected once, cached; 0 on non-x86 targets. */
+unsigned ha_imp_cpu_features (void);
+
+HA_PRVFUN int
+ha_imp_cpu_has (unsigned features)
+{
+  return (ha_imp_cpu_features () & features) == features;
+}
+
+#endif
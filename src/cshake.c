@@ -0,0 +1,281 @@
+#define HA_BUILD
+
+#include "../include/hasha/cshake.h"
+
+#include "./cshake.h"
+
+HA_PRVFUN void
+kmac_init (ha_kmac128_context *ctx, size_t rate, const uint8_t *key,
+           size_t keylen, const uint8_t *custom, size_t customlen)
+{
+  ha_imp_cshake_init (ctx, rate, (const uint8_t *)"KMAC", 4, custom,
+                      customlen);
+  ha_imp_cshake_bytepad_begin (&ctx->sponge);
+  ha_imp_cshake_absorb_string (&ctx->sponge, key, keylen);
+  ha_imp_cshake_bytepad_end (&ctx->sponge);
+  ctx->prefix = ctx->sponge;
+}
+
+HA_PRVFUN void
+tuplehash_init (ha_tuplehash128_context *ctx, size_t rate,
+                const uint8_t *custom, size_t customlen)
+{
+  ha_imp_cshake_init (ctx, rate, (const uint8_t *)"TupleHash", 9, custom,
+                      customlen);
+}
+
+HA_PUBFUN void
+ha_cshake128_init (ha_cshake128_context *ctx, const uint8_t *name,
+                   size_t namelen, const uint8_t *custom, size_t customlen)
+{
+  ha_imp_cshake_init (ctx, HA_SHAKE128_RATE, name, namelen, custom,
+                      customlen);
+}
+
+HA_PUBFUN void
+ha_cshake128_reset (ha_cshake128_context *ctx)
+{
+  ha_imp_cshake_reset (ctx);
+}
+
+HA_PUBFUN void
+ha_cshake128_update (ha_cshake128_context *ctx, ha_inbuf_t data,
+                     size_t length)
+{
+  ha_imp_keccak_update (&ctx->sponge, data, length);
+}
+
+HA_PUBFUN void
+ha_cshake128_final (ha_cshake128_context *ctx, ha_digest_t digest,
+                    size_t digestlen)
+{
+  ha_imp_cshake_final (ctx, digest, digestlen);
+}
+
+HA_PUBFUN void
+ha_cshake128_squeeze (ha_cshake128_context *ctx, ha_digest_t out,
+                      size_t length)
+{
+  ha_imp_keccak_squeeze (&ctx->sponge, out, length);
+}
+
+HA_PUBFUN void
+ha_cshake128_hash (ha_inbuf_t data, size_t length, const uint8_t *name,
+                   size_t namelen, const uint8_t *custom, size_t customlen,
+                   ha_digest_t digest, size_t digestlen)
+{
+  ha_cshake128_context ctx;
+  ha_imp_cshake_init (&ctx, HA_SHAKE128_RATE, name, namelen, custom,
+                      customlen);
+  ha_imp_keccak_update (&ctx.sponge, data, length);
+  ha_imp_cshake_final (&ctx, digest, digestlen);
+}
+
+HA_PUBFUN void
+ha_cshake256_init (ha_cshake256_context *ctx, const uint8_t *name,
+                   size_t namelen, const uint8_t *custom, size_t customlen)
+{
+  ha_imp_cshake_init (ctx, HA_SHAKE256_RATE, name, namelen, custom,
+                      customlen);
+}
+
+HA_PUBFUN void
+ha_cshake256_reset (ha_cshake256_context *ctx)
+{
+  ha_imp_cshake_reset (ctx);
+}
+
+HA_PUBFUN void
+ha_cshake256_update (ha_cshake256_context *ctx, ha_inbuf_t data,
+                     size_t length)
+{
+  ha_imp_keccak_update (&ctx->sponge, data, length);
+}
+
+HA_PUBFUN void
+ha_cshake256_final (ha_cshake256_context *ctx, ha_digest_t digest,
+                    size_t digestlen)
+{
+  ha_imp_cshake_final (ctx, digest, digestlen);
+}
+
+HA_PUBFUN void
+ha_cshake256_squeeze (ha_cshake256_context *ctx, ha_digest_t out,
+                      size_t length)
+{
+  ha_imp_keccak_squeeze (&ctx->sponge, out, length);
+}
+
+HA_PUBFUN void
+ha_cshake256_hash (ha_inbuf_t data, size_t length, const uint8_t *name,
+                   size_t namelen, const uint8_t *custom, size_t customlen,
+                   ha_digest_t digest, size_t digestlen)
+{
+  ha_cshake256_context ctx;
+  ha_imp_cshake_init (&ctx, HA_SHAKE256_RATE, name, namelen, custom,
+                      customlen);
+  ha_imp_keccak_update (&ctx.sponge, data, length);
+  ha_imp_cshake_final (&ctx, digest, digestlen);
+}
+
+HA_PUBFUN void
+ha_kmac128_init (ha_kmac128_context *ctx, const uint8_t *key, size_t keylen,
+                 const uint8_t *custom, size_t customlen)
+{
+  kmac_init (ctx, HA_SHAKE128_RATE, key, keylen, custom, customlen);
+}
+
+HA_PUBFUN void
+ha_kmac128_update (ha_kmac128_context *ctx, ha_inbuf_t data, size_t length)
+{
+  ha_imp_keccak_update (&ctx->sponge, data, length);
+}
+
+HA_PUBFUN void
+ha_kmac128_final (ha_kmac128_context *ctx, ha_digest_t mac, size_t maclen)
+{
+  ha_imp_cshake_final_with_length (ctx, (uint64_t)maclen * 8, mac,
+                                   maclen);
+}
+
+HA_PUBFUN void
+ha_kmac128_final_xof (ha_kmac128_context *ctx, ha_digest_t out,
+                      size_t outlen)
+{
+  ha_imp_cshake_final_with_length (ctx, 0, out, outlen);
+}
+
+HA_PUBFUN void
+ha_kmac128_hash (const uint8_t *key, size_t keylen, const uint8_t *custom,
+                 size_t customlen, ha_inbuf_t data, size_t length,
+                 ha_digest_t mac, size_t maclen)
+{
+  ha_kmac128_context ctx;
+  kmac_init (&ctx, HA_SHAKE128_RATE, key, keylen, custom, customlen);
+  ha_imp_keccak_update (&ctx.sponge, data, length);
+  ha_imp_cshake_final_with_length (&ctx, (uint64_t)maclen * 8, mac,
+                                   maclen);
+}
+
+HA_PUBFUN void
+ha_kmac256_init (ha_kmac256_context *ctx, const uint8_t *key, size_t keylen,
+                 const uint8_t *custom, size_t customlen)
+{
+  kmac_init (ctx, HA_SHAKE256_RATE, key, keylen, custom, customlen);
+}
+
+HA_PUBFUN void
+ha_kmac256_update (ha_kmac256_context *ctx, ha_inbuf_t data, size_t length)
+{
+  ha_imp_keccak_update (&ctx->sponge, data, length);
+}
+
+HA_PUBFUN void
+ha_kmac256_final (ha_kmac256_context *ctx, ha_digest_t mac, size_t maclen)
+{
+  ha_imp_cshake_final_with_length (ctx, (uint64_t)maclen * 8, mac,
+                                   maclen);
+}
+
+HA_PUBFUN void
+ha_kmac256_final_xof (ha_kmac256_context *ctx, ha_digest_t out,
+                      size_t outlen)
+{
+  ha_imp_cshake_final_with_length (ctx, 0, out, outlen);
+}
+
+HA_PUBFUN void
+ha_kmac256_hash (const uint8_t *key, size_t keylen, const uint8_t *custom,
+                 size_t customlen, ha_inbuf_t data, size_t length,
+                 ha_digest_t mac, size_t maclen)
+{
+  ha_kmac256_context ctx;
+  kmac_init (&ctx, HA_SHAKE256_RATE, key, keylen, custom, customlen);
+  ha_imp_keccak_update (&ctx.sponge, data, length);
+  ha_imp_cshake_final_with_length (&ctx, (uint64_t)maclen * 8, mac,
+                                   maclen);
+}
+
+HA_PUBFUN void
+ha_tuplehash128_init (ha_tuplehash128_context *ctx, const uint8_t *custom,
+                      size_t customlen)
+{
+  tuplehash_init (ctx, HA_SHAKE128_RATE, custom, customlen);
+}
+
+HA_PUBFUN void
+ha_tuplehash128_update (ha_tuplehash128_context *ctx, ha_inbuf_t item,
+                        size_t length)
+{
+  ha_imp_cshake_absorb_string (&ctx->sponge, item, length);
+}
+
+HA_PUBFUN void
+ha_tuplehash128_final (ha_tuplehash128_context *ctx, ha_digest_t digest,
+                       size_t digestlen)
+{
+  ha_imp_cshake_final_with_length (ctx, (uint64_t)digestlen * 8, digest,
+                                   digestlen);
+}
+
+HA_PUBFUN void
+ha_tuplehash128_final_xof (ha_tuplehash128_context *ctx, ha_digest_t out,
+                           size_t outlen)
+{
+  ha_imp_cshake_final_with_length (ctx, 0, out, outlen);
+}
+
+HA_PUBFUN void
+ha_tuplehash128_hash (const uint8_t *const *items, const size_t *lens,
+                      size_t n, const uint8_t *custom, size_t customlen,
+                      ha_digest_t digest, size_t digestlen)
+{
+  ha_tuplehash128_context ctx;
+  tuplehash_init (&ctx, HA_SHAKE128_RATE, custom, customlen);
+  for (size_t i = 0; i < n; ++i)
+    ha_imp_cshake_absorb_string (&ctx.sponge, items[i], lens[i]);
+  ha_imp_cshake_final_with_length (&ctx, (uint64_t)digestlen * 8, digest,
+                                   digestlen);
+}
+
+HA_PUBFUN void
+ha_tuplehash256_init (ha_tuplehash256_context *ctx, const uint8_t *custom,
+                      size_t customlen)
+{
+  tuplehash_init (ctx, HA_SHAKE256_RATE, custom, customlen);
+}
+
+HA_PUBFUN void
+ha_tuplehash256_update (ha_tuplehash256_context *ctx, ha_inbuf_t item,
+                        size_t length)
+{
+  ha_imp_cshake_absorb_string (&ctx->sponge, item, length);
+}
+
+HA_PUBFUN void
+ha_tuplehash256_final (ha_tuplehash256_context *ctx, ha_digest_t digest,
+                       size_t digestlen)
+{
+  ha_imp_cshake_final_with_length (ctx, (uint64_t)digestlen * 8, digest,
+                                   digestlen);
+}
+
+HA_PUBFUN void
+ha_tuplehash256_final_xof (ha_tuplehash256_context *ctx, ha_digest_t out,
+                           size_t outlen)
+{
+  ha_imp_cshake_final_with_length (ctx, 0, out, outlen);
+}
+
+HA_PUBFUN void
+ha_tuplehash256_hash (const uint8_t *const *items, const size_t *lens,
+                      size_t n, const uint8_t *custom, size_t customlen,
+                      ha_digest_t digest, size_t digestlen)
+{
+  ha_tuplehash256_context ctx;
+  tuplehash_init (&ctx, HA_SHAKE256_RATE, custom, customlen);
+  for (size_t i = 0; i < n; ++i)
+    ha_imp_cshake_absorb_string (&ctx.sponge, items[i], lens[i]);
+  ha_imp_cshake_final_with_length (&ctx, (uint64_t)digestlen * 8, digest,
+                                   digestlen);
+}
@@ -0,0 +1,123 @@
+#ifndef __hasha_imp_cshake_h
+#define __hasha_imp_cshake_h
+
+#include "../include/hasha/cshake.h"
+#include "./keccak.h"
+
+/*
+ * SP 800-185 on the keccak sponge. Every function absorbs
+ * bytepad (encode_string (N) || encode_string (S), rate) first, and KMAC
+ * then bytepad (encode_string (K), rate); both end on a block boundary,
+ * so the sponge right after them is copied to ctx->prefix and each reset
+ * starts from that copy.
+ */
+
+#define HA_IMP_CSHAKE_ENCODE_MAX 9
+
+/* left_encode (x): the byte count n of x, then x in n big-endian bytes */
+HA_PRVFUN size_t
+ha_imp_cshake_left_encode (uint8_t *buf, uint64_t x)
+{
+  uint8_t be[8];
+  size_t n = 1;
+
+  while (n < 8 && (x >> (8 * n)))
+    ++n;
+  store_be64 (be, x);
+  buf[0] = (uint8_t)n;
+  memcpy (buf + 1, be + 8 - n, n);
+  return n + 1;
+}
+
+/* right_encode (x): x in n big-endian bytes, then n */
+HA_PRVFUN size_t
+ha_imp_cshake_right_encode (uint8_t *buf, uint64_t x)
+{
+  uint8_t be[8];
+  size_t n = 1;
+
+  while (n < 8 && (x >> (8 * n)))
+    ++n;
+  store_be64 (be, x);
+  memcpy (buf, be + 8 - n, n);
+  buf[n] = (uint8_t)n;
+  return n + 1;
+}
+
+/* encode_string (str): left_encode of its length in bits, then str */
+HA_PRVFUN void
+ha_imp_cshake_absorb_string (ha_keccak_context *s, const uint8_t *str,
+                             size_t len)
+{
+  uint8_t enc[HA_IMP_CSHAKE_ENCODE_MAX];
+
+  ha_imp_keccak_update (
+      s, enc, ha_imp_cshake_left_encode (enc, (uint64_t)len * 8));
+  if (len)
+    ha_imp_keccak_update (s, str, len);
+}
+
+HA_PRVFUN void
+ha_imp_cshake_bytepad_begin (ha_keccak_context *s)
+{
+  uint8_t enc[HA_IMP_CSHAKE_ENCODE_MAX];
+
+  ha_imp_keccak_update (s, enc, ha_imp_cshake_left_encode (enc, s->rate));
+}
+
+/* the zero fill up to the block boundary leaves the lanes as they are */
+HA_PRVFUN void
+ha_imp_cshake_bytepad_end (ha_keccak_context *s)
+{
+  if (s->absorb_index)
+    {
+      ha_imp_keccakp1600 (s->state, s->rounds);
+      s->absorb_index = 0;
+    }
+}
+
+HA_PRVFUN void
+ha_imp_cshake_init (ha_cshake_context *ctx, size_t rate,
+                    const uint8_t *name, size_t namelen,
+                    const uint8_t *custom, size_t customlen)
+{
+  ha_imp_keccak_init (&ctx->sponge, rate);
+  ctx->pad = HA_PB_SHAKE;
+  if (namelen || customlen)
+    {
+      ctx->pad = HA_PB_CSHAKE;
+      ha_imp_cshake_bytepad_begin (&ctx->sponge);
+      ha_imp_cshake_absorb_string (&ctx->sponge, name, namelen);
+      ha_imp_cshake_absorb_string (&ctx->sponge, custom, customlen);
+      ha_imp_cshake_bytepad_end (&ctx->sponge);
+    }
+  ctx->prefix = ctx->sponge;
+}
+
+HA_PRVFUN void
+ha_imp_cshake_reset (ha_cshake_context *ctx)
+{
+  ctx->sponge = ctx->prefix;
+}
+
+HA_PRVFUN void
+ha_imp_cshake_final (ha_cshake_context *ctx, ha_digest_t digest,
+                     size_t digestlen)
+{
+  ha_imp_keccak_final (&ctx->sponge, ctx->pad, digest, digestlen);
+}
+
+/* KMAC and TupleHash end their input with right_encode (L), L = 0 for
+   the XOF variants */
+HA_PRVFUN void
+ha_imp_cshake_final_with_length (ha_cshake_context *ctx, uint64_t bits,
+                                 ha_digest_t digest, size_t digestlen)
+{
+  uint8_t enc[HA_IMP_CSHAKE_ENCODE_MAX];
+
+  ha_imp_keccak_update (&ctx->sponge, enc,
+                        ha_imp_cshake_right_encode (enc, bits));
+  ha_imp_cshake_final (ctx, digest, digestlen);
+}
+
+#endif
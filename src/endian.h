@@ -52,17 +52,17 @@ le64_to_cpu (uint64_t x)
 static inline uint32_t
 load_le32 (const uint8_t *p)
 {
-  return le32_to_cpu (((uint32_t)p[0]) | ((uint32_t)p[1] << 8)
-                      | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24));
+  return ((uint32_t)p[0]) | ((uint32_t)p[1] << 8)
+         | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
 }
 
 static inline uint64_t
 load_le64 (const uint8_t *p)
 {
-  return le64_to_cpu (((uint64_t)p[0]) | ((uint64_t)p[1] << 8)
-                      | ((uint64_t)p[2] << 16) | ((uint64_t)p[3] << 24)
-                      | ((uint64_t)p[4] << 32) | ((uint64_t)p[5] << 40)
-                      | ((uint64_t)p[6] << 48) | ((uint64_t)p[7] << 56));
+  return ((uint64_t)p[0]) | ((uint64_t)p[1] << 8)
+         | ((uint64_t)p[2] << 16) | ((uint64_t)p[3] << 24)
+         | ((uint64_t)p[4] << 32) | ((uint64_t)p[5] << 40)
+         | ((uint64_t)p[6] << 48) | ((uint64_t)p[7] << 56);
 }
 
 static inline void
@@ -171,17 +171,17 @@ be64_to_cpu (uint64_t x)
 static inline uint32_t
 load_be32 (const uint8_t *p)
 {
-  return be32_to_cpu (((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16)
-                      | ((uint32_t)p[2] << 8) | ((uint32_t)p[3]));
+  return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16)
+         | ((uint32_t)p[2] << 8) | ((uint32_t)p[3]);
 }
 
 static inline uint64_t
 load_be64 (const uint8_t *p)
 {
-  return be64_to_cpu (((uint64_t)p[0] << 56) | ((uint64_t)p[1] << 48)
-                      | ((uint64_t)p[2] << 40) | ((uint64_t)p[3] << 32)
-                      | ((uint64_t)p[4] << 24) | ((uint64_t)p[5] << 16)
-                      | ((uint64_t)p[6] << 8) | ((uint64_t)p[7]));
+  return ((uint64_t)p[0] << 56) | ((uint64_t)p[1] << 48)
+         | ((uint64_t)p[2] << 40) | ((uint64_t)p[3] << 32)
+         | ((uint64_t)p[4] << 24) | ((uint64_t)p[5] << 16)
+         | ((uint64_t)p[6] << 8) | ((uint64_t)p[7]);
 }
 
 static inline void
@@ -26,8 +26,9 @@ static char *g_ha_evp_error_strings[] = {
 };
 
 typedef void (*ha_evp_generic_init_fn) (void *);
-typedef void (*ha_evp_keyed_init_fn) (void *, ha_inbuf_t, size_t);
+typedef void (*ha_evp_keyed_init_fn) (void *, ha_inbuf_t, size_t, size_t);
 typedef void (*ha_evp_keccak_init_fn) (void *, size_t);
+typedef void (*ha_evp_flexible_init_fn) (void *, size_t);
 
 typedef void (*ha_evp_update_fn) (void *, ha_inbuf_t, size_t);
 
@@ -41,11 +42,14 @@ typedef void (*ha_evp_flexible_hash_fn) (ha_inbuf_t, size_t, ha_digest_t,
                                          size_t);
 typedef void (*ha_evp_keccak_hash_fn) (size_t, enum ha_pb, ha_inbuf_t, size_t,
                                        ha_digest_t, size_t);
+typedef void (*ha_evp_keyed_hash_fn) (ha_inbuf_t, size_t, ha_inbuf_t, size_t,
+                                      ha_digest_t, size_t);
+
+typedef void (*ha_evp_squeeze_fn) (void *, ha_digest_t, size_t);
 
 enum ha_evp_hasher_fun_mod ha_enum_base (uint8_t)
 {
-  /* unused */
-  HA_EVPHR_MOD_KEYED = 0, /* 0-2 for init */
+  HA_EVPHR_MOD_KEYED = 0, /* 0-3 for init and hash */
   HA_EVPHR_MOD_KECCAK = 1,
   HA_EVPHR_MOD_GENERIC = 2,
   HA_EVPHR_MOD_FLEXIBLE = 3, /* 2-3 for final */
@@ -61,6 +65,10 @@ struct ha_evp_hasher
   enum ha_pb k_pad_byte; /* keccak pad byte, may be unused */
   bool k_custom;         /* keccak custom */
 
+  /* key of keyed types, may be unused */
+  uint8_t key[HA_EVP_KEY_MAX_SIZE];
+  size_t keylen;
+
   void *ctx;
   size_t ctx_size;
   bool ctx_allocated;
@@ -70,6 +78,7 @@ struct ha_evp_hasher
     ha_evp_generic_init_fn generic;
     ha_evp_keyed_init_fn keyed;
     ha_evp_keccak_init_fn keccak;
+    ha_evp_flexible_init_fn flexible;
   } init_fn;
   enum ha_evp_hasher_fun_mod init_fn_mod;
 
@@ -88,13 +97,19 @@ struct ha_evp_hasher
     ha_evp_generic_hash_fn generic;
     ha_evp_flexible_hash_fn flexible;
     ha_evp_keccak_hash_fn keccak;
+    ha_evp_keyed_hash_fn keyed;
   } hash_fn;
   enum ha_evp_hasher_fun_mod hash_fn_mod;
+
+  ha_evp_squeeze_fn squeeze_fn; /* NULL unless hashty is an XOF */
 };
 const size_t g_ha_evp_hasher_size = sizeof (struct ha_evp_hasher);
 
-static const char *g_ha_evp_hashty_strings[8] = {
-  "blake2b", "blake2s", "blake3", "keccak", "md5", "sha1", "sha2", "sha3"
+/* indexed by hashty - 1 (HA_EVPTY_UNDEFINED has no name) */
+static const char *g_ha_evp_hashty_strings[13] = {
+  "blake2b", "blake2s",  "blake3",   "keccak",   "md5",
+  "sha1",    "sha2",     "sha3",     "shake",    "blake2bp",
+  "blake2sp", "blake2xb", "blake2xs",
 };
 
 HA_PUBFUN
@@ -104,14 +119,14 @@ ha_evp_hashty_tostr (enum ha_evp_hashty hashty)
   size_t hashty_n
       = sizeof (g_ha_evp_hashty_strings) / sizeof (g_ha_evp_hashty_strings[0]);
 
-  if (hashty >= hashty_n)
+  if (hashty == HA_EVPTY_UNDEFINED || hashty > hashty_n)
     {
       ha_throw_warn (0, ha_curpos, g_ha_evp_error_strings[ARG_ERROR], 0,
                      "hashty", g_ha_evp_error_strings[OUT_OF_BOUNDS_ERROR]);
       return "unknown";
     }
 
-  return g_ha_evp_hashty_strings[hashty];
+  return g_ha_evp_hashty_strings[hashty - 1];
 }
 
 HA_PUBFUN
@@ -156,6 +171,31 @@ ha_evp_hasher_keccak_rate (struct ha_evp_hasher *hasher)
   return hasher->k_rate;
 }
 
+HA_PUBFUN
+void
+ha_evp_hasher_set_key (struct ha_evp_hasher *hasher, ha_inbuf_t key,
+                       size_t keylen)
+{
+  size_t max = hasher->hashty == HA_EVPTY_BLAKE2S ? HA_BLAKE2S_KEY_SIZE
+                                                  : HA_EVP_KEY_MAX_SIZE;
+
+  if (keylen > max)
+    return ha_throw_error (0, ha_curpos, g_ha_evp_error_strings[ARG_ERROR], 2,
+                           "keylen",
+                           g_ha_evp_error_strings[OUT_OF_BOUNDS_ERROR]);
+  memset (hasher->key, 0, sizeof (hasher->key));
+  if (keylen)
+    memcpy (hasher->key, key, keylen);
+  hasher->keylen = keylen;
+}
+
+HA_PUBFUN
+size_t
+ha_evp_hasher_keylen (struct ha_evp_hasher *hasher)
+{
+  return hasher->keylen;
+}
+
 HA_PUBFUN
 size_t
 ha_evp_hasher_ctxsize (struct ha_evp_hasher *hasher)
@@ -196,6 +236,8 @@ HA_PRVFUN
 void
 ha_evp_setup_hasher (struct ha_evp_hasher *hasher)
 {
+  hasher->squeeze_fn = NULL;
+
   switch (hasher->hashty)
     {
     case HA_EVPTY_SHA1:
@@ -315,10 +357,15 @@ ha_evp_setup_hasher (struct ha_evp_hasher *hasher)
       }
     case HA_EVPTY_BLAKE2B:
       {
+        if (hasher->keylen > HA_BLAKE2B_KEY_SIZE)
+          return ha_throw_error (0, ha_curpos,
+                                 g_ha_evp_error_strings[UNEXPECTED_ERROR],
+                                 "key length");
+
         hasher->ctx_size = sizeof (ha_ctx (blake2b));
-        hasher->init_fn.generic
-            = (ha_evp_generic_init_fn)ha_init_fun (blake2b);
-        hasher->init_fn_mod = HA_EVPHR_MOD_GENERIC;
+        hasher->init_fn.keyed
+            = (ha_evp_keyed_init_fn)ha_blake2b_init_keyed;
+        hasher->init_fn_mod = HA_EVPHR_MOD_KEYED;
 
         hasher->update_fn = (ha_evp_update_fn)ha_update_fun (blake2b);
 
@@ -326,17 +373,21 @@ ha_evp_setup_hasher (struct ha_evp_hasher *hasher)
             = (ha_evp_flexible_final_fn)ha_final_fun (blake2b);
         hasher->final_fn_mod = HA_EVPHR_MOD_FLEXIBLE;
 
-        hasher->hash_fn.flexible
-            = (ha_evp_flexible_hash_fn)ha_hash_fun (blake2b);
-        hasher->hash_fn_mod = HA_EVPHR_MOD_FLEXIBLE;
+        hasher->hash_fn.keyed = (ha_evp_keyed_hash_fn)ha_blake2b_keyed_hash;
+        hasher->hash_fn_mod = HA_EVPHR_MOD_KEYED;
         break;
       }
     case HA_EVPTY_BLAKE2S:
       {
+        if (hasher->keylen > HA_BLAKE2S_KEY_SIZE)
+          return ha_throw_error (0, ha_curpos,
+                                 g_ha_evp_error_strings[UNEXPECTED_ERROR],
+                                 "key length");
+
         hasher->ctx_size = sizeof (ha_ctx (blake2s));
-        hasher->init_fn.generic
-            = (ha_evp_generic_init_fn)ha_init_fun (blake2s);
-        hasher->init_fn_mod = HA_EVPHR_MOD_GENERIC;
+        hasher->init_fn.keyed
+            = (ha_evp_keyed_init_fn)ha_blake2s_init_keyed;
+        hasher->init_fn_mod = HA_EVPHR_MOD_KEYED;
 
         hasher->update_fn = (ha_evp_update_fn)ha_update_fun (blake2s);
 
@@ -344,8 +395,79 @@ ha_evp_setup_hasher (struct ha_evp_hasher *hasher)
             = (ha_evp_flexible_final_fn)ha_final_fun (blake2s);
         hasher->final_fn_mod = HA_EVPHR_MOD_FLEXIBLE;
 
+        hasher->hash_fn.keyed = (ha_evp_keyed_hash_fn)ha_blake2s_keyed_hash;
+        hasher->hash_fn_mod = HA_EVPHR_MOD_KEYED;
+        break;
+      }
+    case HA_EVPTY_BLAKE2BP:
+      {
+        hasher->ctx_size = sizeof (ha_ctx (blake2bp));
+        hasher->init_fn.flexible
+            = (ha_evp_flexible_init_fn)ha_init_fun (blake2bp);
+        hasher->init_fn_mod = HA_EVPHR_MOD_FLEXIBLE;
+
+        hasher->update_fn = (ha_evp_update_fn)ha_update_fun (blake2bp);
+
+        hasher->final_fn.generic
+            = (ha_evp_generic_final_fn)ha_final_fun (blake2bp);
+        hasher->final_fn_mod = HA_EVPHR_MOD_GENERIC;
+
+        hasher->hash_fn.flexible
+            = (ha_evp_flexible_hash_fn)ha_hash_fun (blake2bp);
+        hasher->hash_fn_mod = HA_EVPHR_MOD_FLEXIBLE;
+        break;
+      }
+    case HA_EVPTY_BLAKE2SP:
+      {
+        hasher->ctx_size = sizeof (ha_ctx (blake2sp));
+        hasher->init_fn.flexible
+            = (ha_evp_flexible_init_fn)ha_init_fun (blake2sp);
+        hasher->init_fn_mod = HA_EVPHR_MOD_FLEXIBLE;
+
+        hasher->update_fn = (ha_evp_update_fn)ha_update_fun (blake2sp);
+
+        hasher->final_fn.generic
+            = (ha_evp_generic_final_fn)ha_final_fun (blake2sp);
+        hasher->final_fn_mod = HA_EVPHR_MOD_GENERIC;
+
+        hasher->hash_fn.flexible
+            = (ha_evp_flexible_hash_fn)ha_hash_fun (blake2sp);
+        hasher->hash_fn_mod = HA_EVPHR_MOD_FLEXIBLE;
+        break;
+      }
+    case HA_EVPTY_BLAKE2XB:
+      {
+        hasher->ctx_size = sizeof (ha_ctx (blake2xb));
+        hasher->init_fn.flexible
+            = (ha_evp_flexible_init_fn)ha_init_fun (blake2xb);
+        hasher->init_fn_mod = HA_EVPHR_MOD_FLEXIBLE;
+
+        hasher->update_fn = (ha_evp_update_fn)ha_update_fun (blake2xb);
+
+        hasher->final_fn.flexible
+            = (ha_evp_flexible_final_fn)ha_final_fun (blake2xb);
+        hasher->final_fn_mod = HA_EVPHR_MOD_FLEXIBLE;
+
+        hasher->hash_fn.flexible
+            = (ha_evp_flexible_hash_fn)ha_hash_fun (blake2xb);
+        hasher->hash_fn_mod = HA_EVPHR_MOD_FLEXIBLE;
+        break;
+      }
+    case HA_EVPTY_BLAKE2XS:
+      {
+        hasher->ctx_size = sizeof (ha_ctx (blake2xs));
+        hasher->init_fn.flexible
+            = (ha_evp_flexible_init_fn)ha_init_fun (blake2xs);
+        hasher->init_fn_mod = HA_EVPHR_MOD_FLEXIBLE;
+
+        hasher->update_fn = (ha_evp_update_fn)ha_update_fun (blake2xs);
+
+        hasher->final_fn.flexible
+            = (ha_evp_flexible_final_fn)ha_final_fun (blake2xs);
+        hasher->final_fn_mod = HA_EVPHR_MOD_FLEXIBLE;
+
         hasher->hash_fn.flexible
-            = (ha_evp_flexible_hash_fn)ha_hash_fun (blake2s);
+            = (ha_evp_flexible_hash_fn)ha_hash_fun (blake2xs);
         hasher->hash_fn_mod = HA_EVPHR_MOD_FLEXIBLE;
         break;
       }
@@ -566,6 +688,39 @@ ha_evp_setup_hasher (struct ha_evp_hasher *hasher)
           }
         break;
       }
+    case HA_EVPTY_SHAKE:
+      {
+        hasher->ctx_size = sizeof (ha_ctx (shake));
+
+        /* the keccak rate picks the variant: SHAKE128 when it is set to
+           HA_SHAKE128_RATE, SHAKE256 otherwise */
+        if (hasher->k_rate == HA_SHAKE128_RATE)
+          {
+            hasher->init_fn.generic
+                = (ha_evp_generic_init_fn)ha_init_fun (shake128);
+            hasher->update_fn = (ha_evp_update_fn)ha_update_fun (shake128);
+            hasher->final_fn.flexible
+                = (ha_evp_flexible_final_fn)ha_final_fun (shake128);
+            hasher->hash_fn.flexible
+                = (ha_evp_flexible_hash_fn)ha_hash_fun (shake128);
+            hasher->squeeze_fn = (ha_evp_squeeze_fn)ha_shake128_squeeze;
+          }
+        else
+          {
+            hasher->init_fn.generic
+                = (ha_evp_generic_init_fn)ha_init_fun (shake256);
+            hasher->update_fn = (ha_evp_update_fn)ha_update_fun (shake256);
+            hasher->final_fn.flexible
+                = (ha_evp_flexible_final_fn)ha_final_fun (shake256);
+            hasher->hash_fn.flexible
+                = (ha_evp_flexible_hash_fn)ha_hash_fun (shake256);
+            hasher->squeeze_fn = (ha_evp_squeeze_fn)ha_shake256_squeeze;
+          }
+        hasher->init_fn_mod = HA_EVPHR_MOD_GENERIC;
+        hasher->final_fn_mod = HA_EVPHR_MOD_FLEXIBLE;
+        hasher->hash_fn_mod = HA_EVPHR_MOD_FLEXIBLE;
+        break;
+      }
     default:
       return ha_throw_error (0, ha_curpos,
                              g_ha_evp_error_strings[UNEXPECTED_ERROR],
@@ -675,6 +830,13 @@ ha_evp_init (struct ha_evp_hasher *hasher)
     case HA_EVPHR_MOD_KECCAK:
       hasher->init_fn.keccak (hasher->ctx, hasher->k_rate);
       break;
+    case HA_EVPHR_MOD_FLEXIBLE:
+      hasher->init_fn.flexible (hasher->ctx, hasher->digestlen);
+      break;
+    case HA_EVPHR_MOD_KEYED:
+      hasher->init_fn.keyed (hasher->ctx, hasher->key, hasher->keylen,
+                             hasher->digestlen);
+      break;
     default:
       return ha_throw_error (0, ha_curpos,
                              g_ha_evp_error_strings[UNEXPECTED_FUN_MOD_ERROR],
@@ -771,6 +933,10 @@ ha_evp_hash (struct ha_evp_hasher *hasher, ha_inbuf_t buf, size_t len,
       hasher->hash_fn.keccak (hasher->k_rate, hasher->k_pad_byte, buf, len,
                               digest, hasher->digestlen);
       break;
+    case HA_EVPHR_MOD_KEYED:
+      hasher->hash_fn.keyed (hasher->key, hasher->keylen, buf, len, digest,
+                             hasher->digestlen);
+      break;
     default:
       return ha_throw_error (0, ha_curpos,
                              g_ha_evp_error_strings[UNEXPECTED_FUN_MOD_ERROR],
@@ -778,6 +944,32 @@ ha_evp_hash (struct ha_evp_hasher *hasher, ha_inbuf_t buf, size_t len,
     }
 }
 
+HA_PUBFUN
+void
+ha_evp_squeeze (struct ha_evp_hasher *hasher, ha_digest_t out, size_t len)
+{
+  if (!(hasher))
+    return ha_throw_error (0, ha_curpos,
+                           g_ha_evp_error_strings[ARG_VALUE_ERROR], "*hasher",
+                           "(null)");
+
+  if (!(hasher->ctx))
+    return ha_throw_error (0, ha_curpos, g_ha_evp_error_strings[IS_NULL_ERROR],
+                           "hasher->ctx");
+
+  if (!(out))
+    return ha_throw_error (0, ha_curpos,
+                           g_ha_evp_error_strings[ARG_VALUE_ERROR], "out",
+                           "(null)");
+
+  if (!(hasher->squeeze_fn))
+    return ha_throw_error (0, ha_curpos,
+                           g_ha_evp_error_strings[UNEXPECTED_FUN_MOD_ERROR],
+                           "squeeze");
+
+  hasher->squeeze_fn (hasher->ctx, out, len);
+}
+
 HA_PUBFUN
 void
 ha_evp_digest (struct ha_evp_hasher *hasher, ha_inbuf_t buf, size_t len,
@@ -0,0 +1,178 @@
+#define HA_BUILD
+
+#include "../include/hasha/k12.h"
+
+#include "./keccak_tree.h"
+#include "./turboshake.h"
+
+/*
+ * KangarooTwelve over S = M || C || length_encode (|C|). Up to one chunk,
+ * the output is TurboSHAKE128 (S, 0x07). Beyond that the final node is
+ *   S_0 || 03 00 00 00 00 00 00 00 || CV_1 || ... || CV_{n-1}
+ *       || length_encode (n - 1) || ff ff
+ * hashed with TurboSHAKE128 (., 0x06), where CV_i = TurboSHAKE128 (S_i,
+ * 0x0b, 32) for the later chunks S_i.
+ *
+ * The first chunk goes straight into ctx->node; the marker is absorbed
+ * once input beyond it arrives. Later chunks that arrive in pieces go
+ * through ctx->leaf, and runs of whole chunks are hashed on the pool by
+ * ha_imp_keccak_tree_absorb_leaves (), as in ParallelHash but with 12
+ * rounds.
+ */
+
+#define K12_CV_SIZE 32
+
+#define K12_DOMAIN_SINGLE 0x07
+#define K12_DOMAIN_FINAL  0x06
+#define K12_DOMAIN_LEAF   0x0b
+
+static const struct ha_imp_keccak_leaf k12_leaf
+    = { K12_DOMAIN_LEAF, HA_IMP_TURBOSHAKE_ROUNDS, HA_SHAKE128_RATE,
+        HA_K12_CHUNK_SIZE, K12_CV_SIZE };
+
+/* length_encode (x): x in the fewest big-endian bytes (none for 0), then
+   their count */
+HA_PRVFUN size_t
+k12_length_encode (uint8_t *buf, uint64_t x)
+{
+  size_t n = 0;
+
+  while (n < 8 && (x >> (8 * n)))
+    ++n;
+  for (size_t i = 0; i < n; ++i)
+    buf[i] = (uint8_t)(x >> (8 * (n - 1 - i)));
+  buf[n] = (uint8_t)n;
+  return n + 1;
+}
+
+/* bytes in the chunk that ctx->leaf is filling, 0 if none */
+HA_PRVFUN size_t
+k12_leaf_length (const ha_k12_context *ctx)
+{
+  if (ctx->length <= HA_K12_CHUNK_SIZE)
+    return 0;
+  return (size_t)((ctx->length - HA_K12_CHUNK_SIZE) % HA_K12_CHUNK_SIZE);
+}
+
+HA_PRVFUN void
+k12_end_leaf (ha_k12_context *ctx)
+{
+  uint8_t cv[K12_CV_SIZE];
+
+  ha_imp_keccak_final (&ctx->leaf, K12_DOMAIN_LEAF, cv, sizeof (cv));
+  ha_imp_keccak_update (&ctx->node, cv, sizeof (cv));
+  ha_imp_turboshake_init (&ctx->leaf, HA_SHAKE128_RATE);
+}
+
+HA_PRVFUN void
+k12_absorb (ha_k12_context *ctx, const uint8_t *data, size_t length)
+{
+  static const uint8_t marker[8] = { 0x03 };
+  size_t fill, n;
+
+  if (ctx->length < HA_K12_CHUNK_SIZE)
+    {
+      size_t take = HA_K12_CHUNK_SIZE - (size_t)ctx->length;
+
+      if (take > length)
+        take = length;
+      ha_imp_keccak_update (&ctx->node, data, take);
+      ctx->length += take;
+      data += take;
+      length -= take;
+    }
+  if (!length)
+    return;
+  if (ctx->length == HA_K12_CHUNK_SIZE)
+    ha_imp_keccak_update (&ctx->node, marker, sizeof (marker));
+
+  fill = k12_leaf_length (ctx);
+  if (fill)
+    {
+      size_t take = HA_K12_CHUNK_SIZE - fill;
+
+      if (take > length)
+        take = length;
+      ha_imp_keccak_update (&ctx->leaf, data, take);
+      ctx->length += take;
+      data += take;
+      length -= take;
+      if (fill + take < HA_K12_CHUNK_SIZE)
+        return;
+      k12_end_leaf (ctx);
+    }
+
+  n = length / HA_K12_CHUNK_SIZE;
+  if (n)
+    {
+      ha_imp_keccak_tree_absorb_leaves (ctx->pool, &k12_leaf, &ctx->node,
+                                        data, n);
+      ctx->length += n * HA_K12_CHUNK_SIZE;
+      data += n * HA_K12_CHUNK_SIZE;
+      length -= n * HA_K12_CHUNK_SIZE;
+    }
+
+  if (length)
+    {
+      ha_imp_keccak_update (&ctx->leaf, data, length);
+      ctx->length += length;
+    }
+}
+
+HA_PUBFUN void
+ha_k12_init (ha_k12_context *ctx, ha_pool *pool)
+{
+  ha_imp_turboshake_init (&ctx->node, HA_SHAKE128_RATE);
+  ha_imp_turboshake_init (&ctx->leaf, HA_SHAKE128_RATE);
+  ctx->length = 0;
+  ctx->pool = pool;
+}
+
+HA_PUBFUN void
+ha_k12_update (ha_k12_context *ctx, ha_inbuf_t data, size_t length)
+{
+  k12_absorb (ctx, data, length);
+}
+
+HA_PUBFUN void
+ha_k12_final (ha_k12_context *ctx, const uint8_t *custom, size_t customlen,
+              ha_digest_t digest, size_t digestlen)
+{
+  uint8_t enc[10];
+  uint64_t nleaves;
+
+  if (customlen)
+    k12_absorb (ctx, custom, customlen);
+  k12_absorb (ctx, enc, k12_length_encode (enc, customlen));
+
+  if (ctx->length <= HA_K12_CHUNK_SIZE)
+    {
+      ha_imp_keccak_final (&ctx->node, K12_DOMAIN_SINGLE, digest,
+                           digestlen);
+      return;
+    }
+
+  if (k12_leaf_length (ctx))
+    k12_end_leaf (ctx);
+  nleaves = (ctx->length - 1) / HA_K12_CHUNK_SIZE;
+  ha_imp_keccak_update (&ctx->node, enc, k12_length_encode (enc, nleaves));
+  ha_imp_keccak_update (&ctx->node, (const uint8_t *)"\xff\xff", 2);
+  ha_imp_keccak_final (&ctx->node, K12_DOMAIN_FINAL, digest, digestlen);
+}
+
+HA_PUBFUN void
+ha_k12_squeeze (ha_k12_context *ctx, ha_digest_t out, size_t length)
+{
+  ha_imp_keccak_squeeze (&ctx->node, out, length);
+}
+
+HA_PUBFUN void
+ha_k12_hash (ha_inbuf_t data, size_t length, const uint8_t *custom,
+             size_t customlen, ha_pool *pool, ha_digest_t digest,
+             size_t digestlen)
+{
+  ha_k12_context ctx;
+  ha_k12_init (&ctx, pool);
+  k12_absorb (&ctx, data, length);
+  ha_k12_final (&ctx, custom, customlen, digest, digestlen);
+}
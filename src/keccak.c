@@ -94,6 +94,19 @@ ha_keccak_256_hash (ha_inbuf_t data, size_t length, ha_digest_t digest)
 #endif
 }
 
+HA_PUBFUN void
+ha_keccak_256_hash_many (const uint8_t *const *bufs, const size_t *lens,
+                         size_t n, uint8_t *digests)
+{
+  if (ha_imp_keccak_hash_many (HA_PB_KECCAK, 24, HA_KECCAK_256_RATE,
+                               HA_KECCAK_256_DIGEST_SIZE, bufs, lens, n,
+                               digests))
+    return;
+  for (size_t i = 0; i < n; ++i)
+    ha_keccak_256_hash (bufs[i], lens[i],
+                        digests + i * HA_KECCAK_256_DIGEST_SIZE);
+}
+
 HA_PUBFUN void
 ha_keccak_384_init (ha_keccak_context *ctx)
 {
@@ -4,8 +4,48 @@
 
 #include "../include/hasha/keccak.h"
 #include "../include/hasha/keccak_k.h"
-#include "../include/hasha/keccakf1600.h"
 #include "./endian.h"
+#include "./keccakf1600.h"
+
+/* XORs len bytes into the lanes starting at byte pos of the state */
+HA_PRVFUN void
+ha_imp_keccak_xor_bytes (uint64_t *state, size_t pos, const uint8_t *buf,
+                         size_t len)
+{
+  for (size_t j = 0; j < len; ++j, ++pos)
+    state[pos / 8] ^= (uint64_t)buf[j] << (8 * (pos % 8));
+}
+
+/* copies len bytes of the state starting at byte pos, whole lanes at a
+   time where pos is lane aligned */
+HA_PRVFUN void
+ha_imp_keccak_extract_bytes (const uint64_t *state, size_t pos, uint8_t *out,
+                             size_t len)
+{
+  for (; len && pos % 8; --len, ++pos)
+    *out++ = (uint8_t)(state[pos / 8] >> (8 * (pos % 8)));
+  for (; len >= 8; len -= 8, pos += 8, out += 8)
+    store_le64 (out, state[pos / 8]);
+  for (; len; --len, ++pos)
+    *out++ = (uint8_t)(state[pos / 8] >> (8 * (pos % 8)));
+}
+
+/* absorbs nblocks whole blocks of rate bytes straight from buf */
+HA_PRVFUN void
+ha_imp_keccak_absorb_blocks (uint64_t *state, size_t rate, unsigned rounds,
+                             const uint8_t *buf, size_t nblocks)
+{
+  size_t lanes = rate / 8;
+
+  for (; nblocks; --nblocks, buf += rate)
+    {
+      for (size_t i = 0; i < lanes; ++i)
+        state[i] ^= load_le64 (buf + 8 * i);
+      if (rate % 8)
+        ha_imp_keccak_xor_bytes (state, 8 * lanes, buf + 8 * lanes, rate % 8);
+      ha_imp_keccakp1600 (state, rounds);
+    }
+}
 
 HA_PRVFUN void
 ha_imp_keccak_init (ha_keccak_context *ctx, size_t rate)
@@ -15,106 +55,90 @@ ha_imp_keccak_init (ha_keccak_context *ctx, size_t rate)
   ctx->capacity = 200 - rate;
   ctx->absorb_index = 0;
   ctx->squeeze_index = rate;
+  ctx->rounds = 24;
 }
 
 HA_PRVFUN
 void
 ha_imp_keccak_update (ha_keccak_context *ctx, ha_inbuf_t buf, size_t len)
 {
-  size_t i = 0;
-  while (i < len)
+  size_t rate = ctx->rate;
+
+  if (ctx->absorb_index)
     {
-      size_t absorb_bytes = ctx->rate - ctx->absorb_index;
-      if (absorb_bytes > len - i)
-        absorb_bytes = len - i;
-      for (size_t j = 0; j < absorb_bytes; ++j)
-        ctx->state[ctx->absorb_index + j] ^= buf[i + j];
-      ctx->absorb_index += absorb_bytes;
-      i += absorb_bytes;
-
-      if (ctx->absorb_index == ctx->rate)
-        {
-#ifdef HA_ONLY_LE
-          ha_keccakf1600 ((uint64_t *)ctx->state);
-#else
-          uint64_t state_words[25];
-          for (size_t k = 0; k < 25; k++)
-            {
-              uint64_t word;
-              memcpy (&word, ctx->state + k * 8, 8);
-              state_words[k] = le64_to_cpu (word);
-            }
-          ha_keccakf1600 (state_words);
-          for (size_t k = 0; k < 25; k++)
-            store_le64 (ctx->state + k * 8, state_words[k]);
-#endif
-          ctx->absorb_index = 0;
-        }
+      size_t fill = rate - ctx->absorb_index;
+      if (fill > len)
+        fill = len;
+      ha_imp_keccak_xor_bytes (ctx->state, ctx->absorb_index, buf, fill);
+      ctx->absorb_index += fill;
+      buf += fill;
+      len -= fill;
+      if (ctx->absorb_index < rate)
+        return;
+      ha_imp_keccakp1600 (ctx->state, ctx->rounds);
+      ctx->absorb_index = 0;
     }
-}
 
-HA_PRVFUN
-void
-ha_imp_keccak_final (ha_keccak_context *ctx, uint8_t padbyte,
-                     ha_digest_t digest, size_t digestlen)
-{
-#ifndef HA_ONLY_LE
-  uint64_t state_words[25];
-  for (size_t k = 0; k < 25; k++)
+  if (len >= rate)
     {
-      uint64_t word;
-      memcpy (&word, ctx->state + k * 8, 8);
-      state_words[k] = le64_to_cpu (word);
+      ha_imp_keccak_absorb_blocks (ctx->state, rate, ctx->rounds, buf,
+                                   len / rate);
+      buf += len / rate * rate;
+      len %= rate;
     }
-#endif
-
-#ifdef HA_ONLY_LE
-  ctx->state[ctx->absorb_index] ^= padbyte;
-  ctx->state[ctx->rate - 1] ^= 0x80;
-#else
-  size_t pad_word_idx = ctx->absorb_index / 8;
-  size_t pad_byte_idx = ctx->absorb_index % 8;
-  state_words[pad_word_idx] ^= ((uint64_t)padbyte << (8 * pad_byte_idx));
-  size_t rate_word_idx = (ctx->rate - 1) / 8;
-  size_t rate_byte_idx = (ctx->rate - 1) % 8;
-  state_words[rate_word_idx] ^= ((uint64_t)0x80 << (8 * rate_byte_idx));
-#endif
-
-#ifdef HA_ONLY_LE
-  ha_keccakf1600 ((uint64_t *)ctx->state);
-#else
-  ha_keccakf1600 (state_words);
-#endif
-  ctx->squeeze_index = 0;
 
-  size_t i = 0;
-  while (i < digestlen)
+  ha_imp_keccak_xor_bytes (ctx->state, 0, buf, len);
+  ctx->absorb_index = len;
+}
+
+/* squeezes len more bytes of output, permuting whenever the rate part of
+   the state has been used up */
+HA_PRVFUN void
+ha_imp_keccak_squeeze (ha_keccak_context *ctx, uint8_t *out, size_t len)
+{
+  while (len)
     {
+      size_t n;
+
       if (ctx->squeeze_index == ctx->rate)
         {
-#ifdef HA_ONLY_LE
-          ha_keccakf1600 ((uint64_t *)ctx->state);
-#else
-          ha_keccakf1600 (state_words);
-#endif
+          ha_imp_keccakp1600 (ctx->state, ctx->rounds);
           ctx->squeeze_index = 0;
         }
-#ifdef HA_ONLY_LE
-      digest[i++] = ctx->state[ctx->squeeze_index++];
-#else
-      size_t word_idx = ctx->squeeze_index / 8;
-      size_t byte_idx = ctx->squeeze_index % 8;
-      digest[i++] = (state_words[word_idx] >> (8 * byte_idx)) & 0xFF;
-      ctx->squeeze_index++;
-#endif
+      n = ctx->rate - ctx->squeeze_index;
+      if (n > len)
+        n = len;
+      ha_imp_keccak_extract_bytes (ctx->state, ctx->squeeze_index, out, n);
+      ctx->squeeze_index += n;
+      out += n;
+      len -= n;
     }
+}
+
+HA_PRVFUN
+void
+ha_imp_keccak_final (ha_keccak_context *ctx, uint8_t padbyte,
+                     ha_digest_t digest, size_t digestlen)
+{
+  size_t last = ctx->rate - 1;
 
-#ifndef HA_ONLY_LE
-  for (size_t k = 0; k < 25; k++)
-    store_le64 (ctx->state + k * 8, state_words[k]);
-#endif
+  ctx->state[ctx->absorb_index / 8]
+      ^= (uint64_t)padbyte << (8 * (ctx->absorb_index % 8));
+  ctx->state[last / 8] ^= (uint64_t)0x80 << (8 * (last % 8));
+  ha_imp_keccakp1600 (ctx->state, ctx->rounds);
+  ctx->squeeze_index = 0;
+
+  ha_imp_keccak_squeeze (ctx, digest, digestlen);
 }
 
+/* hashes n messages (outlen <= rate) side by side in the lanes of the
+   x4 permutation, with `rounds' rounds of keccak-p; returns 0 without
+   doing anything when hashing them one at a time is faster */
+int ha_imp_keccak_hash_many (uint8_t padbyte, unsigned rounds, size_t rate,
+                             size_t outlen, const uint8_t *const *bufs,
+                             const size_t *lens, size_t n,
+                             uint8_t *digests);
+
 HA_PRVFUN
 void
 ha_imp_keccak_hash (uint8_t padbyte, ha_inbuf_t buf, size_t len, size_t rate,
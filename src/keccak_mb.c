@@ -0,0 +1,110 @@
+#define HA_BUILD
+
+#include "./keccak.h"
+#include "./keccakf1600.h"
+
+/*
+ * Multi-buffer keccak sponge: four messages are absorbed at once, one
+ * per lane of the x4 permutation (state[4 * word + lane]). A lane whose
+ * message has been padded and permuted is squeezed, cleared and loaded
+ * with the next message, so unequal lengths keep the lanes busy.
+ */
+
+#define KECCAK_MB_LANES 4
+
+struct keccak_mb_lane
+{
+  const uint8_t *data; /* unread bytes of the message */
+  size_t left;         /* bytes left in data */
+  size_t msg;          /* message index, (size_t)-1 when idle */
+  uint8_t tail[200];   /* padded last block */
+};
+
+int
+ha_imp_keccak_hash_many (uint8_t padbyte, unsigned rounds, size_t rate,
+                         size_t outlen, const uint8_t *const *bufs,
+                         const size_t *lens, size_t n, uint8_t *digests)
+{
+  ha_imp_keccakp1600_x4_fn x4 = ha_imp_keccakp1600_x4_kernel ();
+  struct keccak_mb_lane lane[KECCAK_MB_LANES];
+  uint64_t state[25 * KECCAK_MB_LANES];
+  int last[KECCAK_MB_LANES];
+  size_t next = 0, active = 0, i;
+  int l;
+
+  if (!x4 || n < 2)
+    return 0;
+
+  memset (state, 0, sizeof (state));
+  for (l = 0; l < KECCAK_MB_LANES; ++l)
+    {
+      lane[l].msg = (size_t)-1;
+      if (next < n)
+        {
+          lane[l].data = bufs[next];
+          lane[l].left = lens[next];
+          lane[l].msg = next++;
+          ++active;
+        }
+    }
+
+  while (active)
+    {
+      for (l = 0; l < KECCAK_MB_LANES; ++l)
+        {
+          const uint8_t *block;
+
+          last[l] = 0;
+          if (lane[l].msg == (size_t)-1)
+            continue;
+
+          if (lane[l].left >= rate)
+            {
+              block = lane[l].data;
+              lane[l].data += rate;
+              lane[l].left -= rate;
+            }
+          else
+            {
+              memset (lane[l].tail, 0, rate);
+              memcpy (lane[l].tail, lane[l].data, lane[l].left);
+              lane[l].tail[lane[l].left] ^= padbyte;
+              lane[l].tail[rate - 1] ^= 0x80;
+              block = lane[l].tail;
+              last[l] = 1;
+            }
+
+          for (i = 0; i < rate / 8; ++i)
+            state[KECCAK_MB_LANES * i + l] ^= load_le64 (block + 8 * i);
+        }
+
+      x4 (state, rounds);
+
+      for (l = 0; l < KECCAK_MB_LANES; ++l)
+        {
+          uint8_t full[200];
+
+          if (!last[l])
+            continue;
+
+          for (i = 0; 8 * i < outlen; ++i)
+            store_le64 (full + 8 * i, state[KECCAK_MB_LANES * i + l]);
+          memcpy (digests + lane[l].msg * outlen, full, outlen);
+
+          for (i = 0; i < 25; ++i)
+            state[KECCAK_MB_LANES * i + l] = 0;
+          if (next < n)
+            {
+              lane[l].data = bufs[next];
+              lane[l].left = lens[next];
+              lane[l].msg = next++;
+            }
+          else
+            {
+              lane[l].msg = (size_t)-1;
+              --active;
+            }
+        }
+    }
+  return 1;
+}
@@ -0,0 +1,81 @@
+#define HA_BUILD
+
+#include "./keccak_tree.h"
+
+/*
+ * The leaves of a batch are cut into tasks for the pool; each task hashes
+ * its leaves with the multi-buffer sponge (four leaves per x4
+ * permutation), or one at a time where that is faster, and the batch's
+ * chaining values are then absorbed in leaf order.
+ */
+
+#define KECCAK_TREE_TASK   8   /* leaves per pool task */
+#define KECCAK_TREE_BATCH  256 /* leaves per pool job */
+#define KECCAK_TREE_CV_MAX 64
+
+struct keccak_tree_job
+{
+  const struct ha_imp_keccak_leaf *leaf;
+  const uint8_t *data;
+  size_t nleaves;
+  uint8_t *cvs;
+};
+
+static void
+keccak_tree_task (void *arg, size_t task)
+{
+  const struct keccak_tree_job *job = arg;
+  const struct ha_imp_keccak_leaf *leaf = job->leaf;
+  const uint8_t *bufs[KECCAK_TREE_TASK] = { 0 };
+  size_t lens[KECCAK_TREE_TASK] = { 0 };
+  size_t first = task * KECCAK_TREE_TASK, n = job->nleaves - first, i;
+  uint8_t *cvs = job->cvs + first * leaf->cvlen;
+
+  if (n > KECCAK_TREE_TASK)
+    n = KECCAK_TREE_TASK;
+  for (i = 0; i < n; ++i)
+    {
+      bufs[i] = job->data + (first + i) * leaf->leaflen;
+      lens[i] = leaf->leaflen;
+    }
+
+  if (ha_imp_keccak_hash_many (leaf->padbyte, leaf->rounds, leaf->rate,
+                               leaf->cvlen, bufs, lens, n, cvs))
+    return;
+  for (i = 0; i < n; ++i)
+    {
+      ha_keccak_context sponge;
+
+      ha_imp_keccak_init (&sponge, leaf->rate);
+      sponge.rounds = leaf->rounds;
+      ha_imp_keccak_update (&sponge, bufs[i], lens[i]);
+      ha_imp_keccak_final (&sponge, leaf->padbyte, cvs + i * leaf->cvlen,
+                           leaf->cvlen);
+    }
+}
+
+void
+ha_imp_keccak_tree_absorb_leaves (ha_pool *pool,
+                                  const struct ha_imp_keccak_leaf *leaf,
+                                  ha_keccak_context *node,
+                                  const uint8_t *data, size_t n)
+{
+  uint8_t cvs[KECCAK_TREE_BATCH * KECCAK_TREE_CV_MAX];
+  struct keccak_tree_job job;
+
+  job.leaf = leaf;
+  job.cvs = cvs;
+  while (n)
+    {
+      job.data = data;
+      job.nleaves = n < KECCAK_TREE_BATCH ? n : KECCAK_TREE_BATCH;
+
+      ha_imp_pool_run (pool, keccak_tree_task, &job,
+                       (job.nleaves + KECCAK_TREE_TASK - 1)
+                           / KECCAK_TREE_TASK);
+      ha_imp_keccak_update (node, cvs, job.nleaves * leaf->cvlen);
+
+      data += job.nleaves * leaf->leaflen;
+      n -= job.nleaves;
+    }
+}
@@ -0,0 +1,26 @@
+#ifndef __hasha_imp_keccak_tree_h
+#define __hasha_imp_keccak_tree_h
+
+#include "./keccak.h"
+#include "./pool.h"
+
+/* the sponge that turns a leaf of a keccak tree hash (ParallelHash,
+   KangarooTwelve) into its chaining value */
+struct ha_imp_keccak_leaf
+{
+  uint8_t padbyte;
+  unsigned rounds;
+  size_t rate;
+  size_t leaflen; /* bytes per leaf */
+  size_t cvlen;   /* bytes per chaining value, at most 64 */
+};
+
+/* Hashes the n whole leaves at data, in batches of pool tasks of a few
+   leaves each, and absorbs their chaining values into node in leaf
+   order. */
+void ha_imp_keccak_tree_absorb_leaves (ha_pool *pool,
+                                       const struct ha_imp_keccak_leaf *leaf,
+                                       ha_keccak_context *node,
+                                       const uint8_t *data, size_t n);
+
+#endif
@@ -0,0 +1,217 @@
+#ifndef __hasha_imp_keccakf1600_h
+#define __hasha_imp_keccakf1600_h
+
+#include "../include/hasha/keccakf1600.h"
+#include "./cpu.h"
+
+/* lane_t is uint64_t for one state, or a vector of uint64_t carrying one
+   state per element */
+#define HASHA_KECCAKF1600_THETA_STEP(state)                                   \
+  HASHA_KECCAKF1600_THETA_STEP_T (uint64_t, state)
+
+#define HASHA_KECCAKF1600_THETA_STEP_T(lane_t, state)                         \
+  /* Theta step */                                                            \
+  lane_t C0 = state[0] ^ state[5] ^ state[10] ^ state[15] ^ state[20];        \
+  lane_t C1 = state[1] ^ state[6] ^ state[11] ^ state[16] ^ state[21];        \
+  lane_t C2 = state[2] ^ state[7] ^ state[12] ^ state[17] ^ state[22];        \
+  lane_t C3 = state[3] ^ state[8] ^ state[13] ^ state[18] ^ state[23];        \
+  lane_t C4 = state[4] ^ state[9] ^ state[14] ^ state[19] ^ state[24];        \
+  lane_t D0 = ha_primitive_rotl64 (C1, 1) ^ C4;                               \
+  lane_t D1 = ha_primitive_rotl64 (C2, 1) ^ C0;                               \
+  lane_t D2 = ha_primitive_rotl64 (C3, 1) ^ C1;                               \
+  lane_t D3 = ha_primitive_rotl64 (C4, 1) ^ C2;                               \
+  lane_t D4 = ha_primitive_rotl64 (C0, 1) ^ C3;                               \
+  state[0] ^= D0;                                                             \
+  state[1] ^= D1;                                                             \
+  state[2] ^= D2;                                                             \
+  state[3] ^= D3;                                                             \
+  state[4] ^= D4;                                                             \
+  state[5] ^= D0;                                                             \
+  state[6] ^= D1;                                                             \
+  state[7] ^= D2;                                                             \
+  state[8] ^= D3;                                                             \
+  state[9] ^= D4;                                                             \
+  state[10] ^= D0;                                                            \
+  state[11] ^= D1;                                                            \
+  state[12] ^= D2;                                                            \
+  state[13] ^= D3;                                                            \
+  state[14] ^= D4;                                                            \
+  state[15] ^= D0;                                                            \
+  state[16] ^= D1;                                                            \
+  state[17] ^= D2;                                                            \
+  state[18] ^= D3;                                                            \
+  state[19] ^= D4;                                                            \
+  state[20] ^= D0;                                                            \
+  state[21] ^= D1;                                                            \
+  state[22] ^= D2;                                                            \
+  state[23] ^= D3;                                                            \
+  state[24] ^= D4;
+
+#define HASHA_KECCAKF1600_RHO_PI_STEP(state)                                  \
+  HASHA_KECCAKF1600_RHO_PI_STEP_T (uint64_t, state)
+
+#define HASHA_KECCAKF1600_RHO_PI_STEP_T(lane_t, state)                        \
+  /* Rho and Pi steps */                                                      \
+  lane_t B0 = state[0];                                                       \
+  lane_t B1 = ha_primitive_rotl64 (state[6], 44);                             \
+  lane_t B2 = ha_primitive_rotl64 (state[12], 43);                            \
+  lane_t B3 = ha_primitive_rotl64 (state[18], 21);                            \
+  lane_t B4 = ha_primitive_rotl64 (state[24], 14);                            \
+  lane_t B5 = ha_primitive_rotl64 (state[3], 28);                             \
+  lane_t B6 = ha_primitive_rotl64 (state[9], 20);                             \
+  lane_t B7 = ha_primitive_rotl64 (state[10], 3);                             \
+  lane_t B8 = ha_primitive_rotl64 (state[16], 45);                            \
+  lane_t B9 = ha_primitive_rotl64 (state[22], 61);                            \
+  lane_t B10 = ha_primitive_rotl64 (state[1], 1);                             \
+  lane_t B11 = ha_primitive_rotl64 (state[7], 6);                             \
+  lane_t B12 = ha_primitive_rotl64 (state[13], 25);                           \
+  lane_t B13 = ha_primitive_rotl64 (state[19], 8);                            \
+  lane_t B14 = ha_primitive_rotl64 (state[20], 18);                           \
+  lane_t B15 = ha_primitive_rotl64 (state[4], 27);                            \
+  lane_t B16 = ha_primitive_rotl64 (state[5], 36);                            \
+  lane_t B17 = ha_primitive_rotl64 (state[11], 10);                           \
+  lane_t B18 = ha_primitive_rotl64 (state[17], 15);                           \
+  lane_t B19 = ha_primitive_rotl64 (state[23], 56);                           \
+  lane_t B20 = ha_primitive_rotl64 (state[2], 62);                            \
+  lane_t B21 = ha_primitive_rotl64 (state[8], 55);                            \
+  lane_t B22 = ha_primitive_rotl64 (state[14], 39);                           \
+  lane_t B23 = ha_primitive_rotl64 (state[15], 41);                           \
+  lane_t B24 = ha_primitive_rotl64 (state[21], 2);
+
+#define HASHA_KECCAKF1600_CHI_STEP(state)                                     \
+  /* Chi step */                                                              \
+  state[0] = B0 ^ ((~B1) & B2);                                               \
+  state[1] = B1 ^ ((~B2) & B3);                                               \
+  state[2] = B2 ^ ((~B3) & B4);                                               \
+  state[3] = B3 ^ ((~B4) & B0);                                               \
+  state[4] = B4 ^ ((~B0) & B1);                                               \
+  state[5] = B5 ^ ((~B6) & B7);                                               \
+  state[6] = B6 ^ ((~B7) & B8);                                               \
+  state[7] = B7 ^ ((~B8) & B9);                                               \
+  state[8] = B8 ^ ((~B9) & B5);                                               \
+  state[9] = B9 ^ ((~B5) & B6);                                               \
+  state[10] = B10 ^ ((~B11) & B12);                                           \
+  state[11] = B11 ^ ((~B12) & B13);                                           \
+  state[12] = B12 ^ ((~B13) & B14);                                           \
+  state[13] = B13 ^ ((~B14) & B10);                                           \
+  state[14] = B14 ^ ((~B10) & B11);                                           \
+  state[15] = B15 ^ ((~B16) & B17);                                           \
+  state[16] = B16 ^ ((~B17) & B18);                                           \
+  state[17] = B17 ^ ((~B18) & B19);                                           \
+  state[18] = B18 ^ ((~B19) & B15);                                           \
+  state[19] = B19 ^ ((~B15) & B16);                                           \
+  state[20] = B20 ^ ((~B21) & B22);                                           \
+  state[21] = B21 ^ ((~B22) & B23);                                           \
+  state[22] = B22 ^ ((~B23) & B24);                                           \
+  state[23] = B23 ^ ((~B24) & B20);                                           \
+  state[24] = B24 ^ ((~B20) & B21);
+
+#define HASHA_KECCAKF1600_IOTA_STEP(state, rc) state[0] ^= rc;
+
+// Macro that unrolls one round of Keccak-f[1600]
+// with all steps inlined.
+#define HASHA_KECCAKF1600_ROUND(state, rc)                                    \
+  HASHA_KECCAKF1600_ROUND_T (uint64_t, state, rc)
+
+#define HASHA_KECCAKF1600_ROUND_T(lane_t, state, rc)                          \
+  do                                                                          \
+    {                                                                         \
+      HASHA_KECCAKF1600_THETA_STEP_T (lane_t, state)                          \
+      HASHA_KECCAKF1600_RHO_PI_STEP_T (lane_t, state)                         \
+      HASHA_KECCAKF1600_CHI_STEP (state)                                      \
+      HASHA_KECCAKF1600_IOTA_STEP (state, rc)                                 \
+    }                                                                         \
+  while (0)
+
+/* the last `rounds' rounds of keccak-f[1600] (24: the full permutation,
+   12: keccak-p[1600,12]), fully unrolled */
+#define HASHA_KECCAKP1600_ROUNDS(ROUND, state, rounds)                        \
+  do                                                                          \
+    {                                                                         \
+      if ((rounds) > 23)                                                      \
+        ROUND (state, 0x0000000000000001ULL);                                 \
+      if ((rounds) > 22)                                                      \
+        ROUND (state, 0x0000000000008082ULL);                                 \
+      if ((rounds) > 21)                                                      \
+        ROUND (state, 0x800000000000808aULL);                                 \
+      if ((rounds) > 20)                                                      \
+        ROUND (state, 0x8000000080008000ULL);                                 \
+      if ((rounds) > 19)                                                      \
+        ROUND (state, 0x000000000000808bULL);                                 \
+      if ((rounds) > 18)                                                      \
+        ROUND (state, 0x0000000080000001ULL);                                 \
+      if ((rounds) > 17)                                                      \
+        ROUND (state, 0x8000000080008081ULL);                                 \
+      if ((rounds) > 16)                                                      \
+        ROUND (state, 0x8000000000008009ULL);                                 \
+      if ((rounds) > 15)                                                      \
+        ROUND (state, 0x000000000000008aULL);                                 \
+      if ((rounds) > 14)                                                      \
+        ROUND (state, 0x0000000000000088ULL);                                 \
+      if ((rounds) > 13)                                                      \
+        ROUND (state, 0x0000000080008009ULL);                                 \
+      if ((rounds) > 12)                                                      \
+        ROUND (state, 0x000000008000000aULL);                                 \
+      if ((rounds) > 11)                                                      \
+        ROUND (state, 0x000000008000808bULL);                                 \
+      if ((rounds) > 10)                                                      \
+        ROUND (state, 0x800000000000008bULL);                                 \
+      if ((rounds) > 9)                                                       \
+        ROUND (state, 0x8000000000008089ULL);                                 \
+      if ((rounds) > 8)                                                       \
+        ROUND (state, 0x8000000000008003ULL);                                 \
+      if ((rounds) > 7)                                                       \
+        ROUND (state, 0x8000000000008002ULL);                                 \
+      if ((rounds) > 6)                                                       \
+        ROUND (state, 0x8000000000000080ULL);                                 \
+      if ((rounds) > 5)                                                       \
+        ROUND (state, 0x000000000000800aULL);                                 \
+      if ((rounds) > 4)                                                       \
+        ROUND (state, 0x800000008000000aULL);                                 \
+      if ((rounds) > 3)                                                       \
+        ROUND (state, 0x8000000080008081ULL);                                 \
+      if ((rounds) > 2)                                                       \
+        ROUND (state, 0x8000000000008080ULL);                                 \
+      if ((rounds) > 1)                                                       \
+        ROUND (state, 0x0000000080000001ULL);                                 \
+      if ((rounds) > 0)                                                       \
+        ROUND (state, 0x8000000080008008ULL);                                 \
+    }                                                                         \
+  while (0)
+
+/* permutes state in place with the last `rounds' (<= 24) rounds */
+typedef void (*ha_imp_keccakp1600_fn) (uint64_t *state, unsigned rounds);
+
+struct ha_imp_keccakf1600_kernel
+{
+  int implid;        /* reported by ha_keccakf1600_implid () */
+  const char *name;  /* accepted by the HASHA_KECCAKF1600_IMPL variable */
+  unsigned features; /* ha_imp_cpu_feature bits it needs */
+  ha_imp_keccakp1600_fn permute;
+};
+
+extern const struct ha_imp_keccakf1600_kernel ha_imp_keccakf1600_scalar;
+extern const struct ha_imp_keccakf1600_kernel ha_imp_keccakf1600_lanecomp;
+#if defined(HA_IMP_X86_SIMD)
+extern const struct ha_imp_keccakf1600_kernel ha_imp_keccakf1600_bmi2;
+extern const struct ha_imp_keccakf1600_kernel ha_imp_keccakf1600_avx512;
+#endif
+
+/* the kernel picked for this process */
+const struct ha_imp_keccakf1600_kernel *ha_imp_keccakf1600_kernel (void);
+
+HA_PRVFUN void
+ha_imp_keccakp1600 (uint64_t *state, unsigned rounds)
+{
+  ha_imp_keccakf1600_kernel ()->permute (state, rounds);
+}
+
+/* four independent states interleaved lane by lane, lane i of state l at
+   states[4 * i + l], permuted side by side in SIMD lanes */
+typedef void (*ha_imp_keccakp1600_x4_fn) (uint64_t *states, unsigned rounds);
+
+/* the x4 kernel for this CPU, NULL when it has none (four states are
+   then best permuted one after another) */
+ha_imp_keccakp1600_x4_fn ha_imp_keccakp1600_x4_kernel (void);
+
+#endif
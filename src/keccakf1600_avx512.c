@@ -0,0 +1,124 @@
+#define HA_BUILD
+
+#include "./keccakf1600.h"
+
+#if defined(HA_IMP_X86_SIMD)
+
+#include <immintrin.h>
+
+/*
+ * AVX-512 keccak-f[1600]: row y of the state lives in lanes 0..4 of one
+ * zmm register for the whole permutation. vpternlogq folds the 3-input
+ * XORs of theta and the whole of chi into single instructions, vprolvq
+ * does rho for a row at once, and each output row of pi is gathered
+ * with two two-source permutes, a blend and a masked permute.
+ */
+
+/* per-lane constants for lanes 0..4 of a row */
+#define ZMM_IDX(a, b, c, d, e) _mm512_set_epi64 (7, 6, 5, e, d, c, b, a)
+
+#define AVX512_KECCAK_ROUND(state, rc)                                        \
+  do                                                                          \
+    {                                                                         \
+      __m512i c, d, b0, b1, b2, b3, b4;                                       \
+                                                                              \
+      /* theta */                                                             \
+      c = _mm512_ternarylogic_epi64 (                                         \
+          _mm512_ternarylogic_epi64 (r0, r1, r2, 0x96), r3, r4, 0x96);        \
+      d = _mm512_rol_epi64 (_mm512_permutexvar_epi64 (xp1, c), 1);            \
+      c = _mm512_permutexvar_epi64 (xm1, c);                                  \
+      r0 = _mm512_ternarylogic_epi64 (r0, c, d, 0x96);                        \
+      r1 = _mm512_ternarylogic_epi64 (r1, c, d, 0x96);                        \
+      r2 = _mm512_ternarylogic_epi64 (r2, c, d, 0x96);                        \
+      r3 = _mm512_ternarylogic_epi64 (r3, c, d, 0x96);                        \
+      r4 = _mm512_ternarylogic_epi64 (r4, c, d, 0x96);                        \
+                                                                              \
+      /* rho */                                                               \
+      r0 = _mm512_rolv_epi64 (r0, rho0);                                      \
+      r1 = _mm512_rolv_epi64 (r1, rho1);                                      \
+      r2 = _mm512_rolv_epi64 (r2, rho2);                                      \
+      r3 = _mm512_rolv_epi64 (r3, rho3);                                      \
+      r4 = _mm512_rolv_epi64 (r4, rho4);                                      \
+                                                                              \
+      /* pi: lane y of output row Y is lane 3Y + y (mod 5) of row y */        \
+      b0 = AVX512_KECCAK_PI_ROW (0);                                          \
+      b1 = AVX512_KECCAK_PI_ROW (1);                                          \
+      b2 = AVX512_KECCAK_PI_ROW (2);                                          \
+      b3 = AVX512_KECCAK_PI_ROW (3);                                          \
+      b4 = AVX512_KECCAK_PI_ROW (4);                                          \
+                                                                              \
+      /* chi: b ^ (~b[x + 1] & b[x + 2]) */                                   \
+      r0 = AVX512_KECCAK_CHI_ROW (b0);                                        \
+      r1 = AVX512_KECCAK_CHI_ROW (b1);                                        \
+      r2 = AVX512_KECCAK_CHI_ROW (b2);                                        \
+      r3 = AVX512_KECCAK_CHI_ROW (b3);                                        \
+      r4 = AVX512_KECCAK_CHI_ROW (b4);                                        \
+                                                                              \
+      /* iota */                                                              \
+      r0 = _mm512_xor_si512 (                                                 \
+          r0, _mm512_set_epi64 (0, 0, 0, 0, 0, 0, 0, (long long)(rc)));       \
+    }                                                                         \
+  while (0)
+
+/* lanes 0, 1 from rows 0, 1 and lanes 2, 3 from rows 2, 3 land in place,
+   then lane 4 comes from row 4 */
+#define AVX512_KECCAK_PI_ROW(Y)                                               \
+  _mm512_mask_permutexvar_epi64 (                                             \
+      _mm512_mask_blend_epi64 (0x0c,                                          \
+                               _mm512_permutex2var_epi64 (r0, pi01_##Y, r1),  \
+                               _mm512_permutex2var_epi64 (r2, pi23_##Y, r3)), \
+      0x10, pi4_##Y, r4)
+
+#define AVX512_KECCAK_CHI_ROW(b)                                              \
+  _mm512_ternarylogic_epi64 (b, _mm512_permutexvar_epi64 (xp1, b),            \
+                             _mm512_permutexvar_epi64 (xp2, b), 0xd2)
+
+HA_IMP_TARGET ("avx512f")
+static void
+keccakp1600_avx512 (uint64_t *restrict state, unsigned rounds)
+{
+  const __m512i xp1 = ZMM_IDX (1, 2, 3, 4, 0);
+  const __m512i xp2 = ZMM_IDX (2, 3, 4, 0, 1);
+  const __m512i xm1 = ZMM_IDX (4, 0, 1, 2, 3);
+  const __m512i rho0 = ZMM_IDX (0, 1, 62, 28, 27);
+  const __m512i rho1 = ZMM_IDX (36, 44, 6, 55, 20);
+  const __m512i rho2 = ZMM_IDX (3, 10, 43, 25, 39);
+  const __m512i rho3 = ZMM_IDX (41, 45, 15, 21, 8);
+  const __m512i rho4 = ZMM_IDX (18, 2, 61, 56, 14);
+  /* output row Y of pi; two-source indices >= 8 pick the second row */
+  const __m512i pi01_0 = ZMM_IDX (0, 9, 0, 0, 0);
+  const __m512i pi23_0 = ZMM_IDX (0, 0, 2, 11, 0);
+  const __m512i pi4_0 = ZMM_IDX (0, 0, 0, 0, 4);
+  const __m512i pi01_1 = ZMM_IDX (3, 12, 0, 0, 0);
+  const __m512i pi23_1 = ZMM_IDX (0, 0, 0, 9, 0);
+  const __m512i pi4_1 = ZMM_IDX (0, 0, 0, 0, 2);
+  const __m512i pi01_2 = ZMM_IDX (1, 10, 0, 0, 0);
+  const __m512i pi23_2 = ZMM_IDX (0, 0, 3, 12, 0);
+  const __m512i pi4_2 = ZMM_IDX (0, 0, 0, 0, 0);
+  const __m512i pi01_3 = ZMM_IDX (4, 8, 0, 0, 0);
+  const __m512i pi23_3 = ZMM_IDX (0, 0, 1, 10, 0);
+  const __m512i pi4_3 = ZMM_IDX (0, 0, 0, 0, 3);
+  const __m512i pi01_4 = ZMM_IDX (2, 11, 0, 0, 0);
+  const __m512i pi23_4 = ZMM_IDX (0, 0, 4, 8, 0);
+  const __m512i pi4_4 = ZMM_IDX (0, 0, 0, 0, 1);
+  __m512i r0, r1, r2, r3, r4;
+
+  r0 = _mm512_maskz_loadu_epi64 (0x1f, state + 0);
+  r1 = _mm512_maskz_loadu_epi64 (0x1f, state + 5);
+  r2 = _mm512_maskz_loadu_epi64 (0x1f, state + 10);
+  r3 = _mm512_maskz_loadu_epi64 (0x1f, state + 15);
+  r4 = _mm512_maskz_loadu_epi64 (0x1f, state + 20);
+
+  HASHA_KECCAKP1600_ROUNDS (AVX512_KECCAK_ROUND, state, rounds);
+
+  _mm512_mask_storeu_epi64 (state + 0, 0x1f, r0);
+  _mm512_mask_storeu_epi64 (state + 5, 0x1f, r1);
+  _mm512_mask_storeu_epi64 (state + 10, 0x1f, r2);
+  _mm512_mask_storeu_epi64 (state + 15, 0x1f, r3);
+  _mm512_mask_storeu_epi64 (state + 20, 0x1f, r4);
+}
+
+const struct ha_imp_keccakf1600_kernel ha_imp_keccakf1600_avx512
+    = { 3, "avx512", HA_CPU_AVX512F, keccakp1600_avx512 };
+
+#endif
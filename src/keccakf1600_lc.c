@@ -0,0 +1,71 @@
+#define HA_BUILD
+
+#include "./keccakf1600.h"
+
+/*
+ * Lane-complementing keccak-f[1600] (the "bebigokimisa" transform from
+ * the Keccak team): lanes 1, 2, 8, 12, 17 and 20 are kept complemented
+ * across the rounds, which lets chi be written with AND/OR on the stored
+ * values and leaves 8 NOTs per round instead of 25. It pays off on
+ * cores without an and-not instruction.
+ */
+
+#define HASHA_KECCAKF1600_CHI_LC_STEP(state)                                  \
+  /* Chi step on the complemented lanes */                                    \
+  state[0] = B0 ^ (B1 | B2);                                                  \
+  state[1] = B1 ^ (~B2 | B3);                                                 \
+  state[2] = B2 ^ (B3 & B4);                                                  \
+  state[3] = B3 ^ (B4 | B0);                                                  \
+  state[4] = B4 ^ (B0 & B1);                                                  \
+  state[5] = B5 ^ (B6 | B7);                                                  \
+  state[6] = B6 ^ (B7 & B8);                                                  \
+  state[7] = B7 ^ (B8 | ~B9);                                                 \
+  state[8] = B8 ^ (B9 | B5);                                                  \
+  state[9] = B9 ^ (B5 & B6);                                                  \
+  state[10] = B10 ^ (B11 | B12);                                              \
+  state[11] = B11 ^ (B12 & B13);                                              \
+  state[12] = B12 ^ (~B13 & B14);                                             \
+  state[13] = ~(B13 ^ (B14 | B10));                                           \
+  state[14] = B14 ^ (B10 & B11);                                              \
+  state[15] = B15 ^ (B16 & B17);                                              \
+  state[16] = B16 ^ (B17 | B18);                                              \
+  state[17] = B17 ^ (~B18 | B19);                                             \
+  state[18] = ~(B18 ^ (B19 & B15));                                           \
+  state[19] = B19 ^ (B15 | B16);                                              \
+  state[20] = B20 ^ (~B21 & B22);                                             \
+  state[21] = ~(B21 ^ (B22 | B23));                                           \
+  state[22] = B22 ^ (B23 & B24);                                              \
+  state[23] = B23 ^ (B24 | B20);                                              \
+  state[24] = B24 ^ (B20 & B21);
+
+#define HASHA_KECCAKF1600_LC_ROUND(state, rc)                                 \
+  do                                                                          \
+    {                                                                         \
+      HASHA_KECCAKF1600_THETA_STEP (state)                                    \
+      HASHA_KECCAKF1600_RHO_PI_STEP (state)                                   \
+      HASHA_KECCAKF1600_CHI_LC_STEP (state)                                   \
+      HASHA_KECCAKF1600_IOTA_STEP (state, rc)                                 \
+    }                                                                         \
+  while (0)
+
+HA_PRVFUN void
+keccakf1600_complement (uint64_t *state)
+{
+  state[1] = ~state[1];
+  state[2] = ~state[2];
+  state[8] = ~state[8];
+  state[12] = ~state[12];
+  state[17] = ~state[17];
+  state[20] = ~state[20];
+}
+
+static void
+keccakp1600_lanecomp (uint64_t *restrict state, unsigned rounds)
+{
+  keccakf1600_complement (state);
+  HASHA_KECCAKP1600_ROUNDS (HASHA_KECCAKF1600_LC_ROUND, state, rounds);
+  keccakf1600_complement (state);
+}
+
+const struct ha_imp_keccakf1600_kernel ha_imp_keccakf1600_lanecomp
+    = { 1, "lanecomp", 0, keccakp1600_lanecomp };
@@ -0,0 +1,70 @@
+#define HA_BUILD
+
+#include "./keccakf1600.h"
+
+#include <string.h>
+
+/*
+ * Four keccak-p[1600] states side by side, one per 64-bit lane of a ymm
+ * register. The scalar round macros run unchanged on the vector type, so
+ * every step is done for all four states with the instructions one state
+ * needs; AVX-512VL turns the shift/or rotates into vprolq.
+ */
+
+#if defined(HA_IMP_X86_SIMD)
+
+typedef uint64_t keccak_v4 __attribute__ ((vector_size (32)));
+
+#define KECCAK_X4_ROUND(state, rc)                                            \
+  HASHA_KECCAKF1600_ROUND_T (keccak_v4, state, rc)
+
+#define KECCAK_X4_KERNEL(name, isa)                                           \
+  HA_IMP_TARGET (isa)                                                         \
+  static void name (uint64_t *states, unsigned rounds)                        \
+  {                                                                           \
+    keccak_v4 s[25];                                                          \
+                                                                              \
+    memcpy (s, states, sizeof (s));                                           \
+    HASHA_KECCAKP1600_ROUNDS (KECCAK_X4_ROUND, s, rounds);                    \
+    memcpy (states, s, sizeof (s));                                           \
+  }
+
+KECCAK_X4_KERNEL (keccakp1600_x4_avx2, "avx2")
+KECCAK_X4_KERNEL (keccakp1600_x4_avx512vl, "avx2,avx512f,avx512vl")
+
+#endif
+
+ha_imp_keccakp1600_x4_fn
+ha_imp_keccakp1600_x4_kernel (void)
+{
+#if defined(HA_IMP_X86_SIMD)
+  if (ha_imp_cpu_has (HA_CPU_AVX512F | HA_CPU_AVX512VL))
+    return keccakp1600_x4_avx512vl;
+  if (ha_imp_cpu_has (HA_CPU_AVX2))
+    return keccakp1600_x4_avx2;
+#endif
+  return NULL;
+}
+
+HA_PUBFUN void
+ha_keccakf1600_x4 (uint64_t *states[4])
+{
+  ha_imp_keccakp1600_x4_fn x4 = ha_imp_keccakp1600_x4_kernel ();
+  uint64_t lanes[25 * 4];
+  int i, l;
+
+  if (!x4)
+    {
+      for (l = 0; l < 4; ++l)
+        ha_imp_keccakp1600 (states[l], 24);
+      return;
+    }
+
+  for (i = 0; i < 25; ++i)
+    for (l = 0; l < 4; ++l)
+      lanes[4 * i + l] = states[l][i];
+  x4 (lanes, 24);
+  for (i = 0; i < 25; ++i)
+    for (l = 0; l < 4; ++l)
+      states[l][i] = lanes[4 * i + l];
+}
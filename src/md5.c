@@ -1,14 +1,13 @@
 #define HA_BUILD
 
-#include "../include/hasha/md5.h"
-#include "../include/hasha/md5_k.h"
+#include "./md5.h"
 
 #include "./endian.h"
 
 HA_PRVFUN void
 md5_transform (ha_md5_context *ctx, const uint8_t *block)
 {
-  uint32_t a, b, c, d, f, g, temp;
+  uint32_t a, b, c, d;
   uint32_t m[16];
 
 #ifdef HA_ONLY_LE
@@ -29,37 +28,7 @@ md5_transform (ha_md5_context *ctx, const uint8_t *block)
   c = ctx->state[2];
   d = ctx->state[3];
 
-  for (int i = 0; i < 64; ++i)
-    {
-      if (i < 16)
-        {
-          f = ha_primitive_md5_f (b, c, d);
-          g = i;
-        }
-      else if (i < 32)
-        {
-          f = ha_primitive_md5_g (b, c, d);
-          g = (5 * i + 1) % 16;
-        }
-      else if (i < 48)
-        {
-          f = ha_primitive_md5_h (b, c, d);
-          g = (3 * i + 5) % 16;
-        }
-      else
-        {
-          f = ha_primitive_md5_i (b, c, d);
-          g = (7 * i) % 16;
-        }
-
-      temp = d;
-      d = c;
-      c = b;
-      b = b
-          + ha_primitive_rotl32 ((a + f + HA_MD5_K[i] + m[g]),
-                                 HA_MD5_SHIFT[i]);
-      a = temp;
-    }
+  MD5_STEPS ()
 
   ctx->state[0] += a;
   ctx->state[1] += b;
@@ -82,14 +51,13 @@ ha_md5_init (ha_md5_context *ctx)
 HA_PUBFUN void
 ha_md5_update (ha_md5_context *ctx, ha_inbuf_t data, size_t len)
 {
-  size_t buffer_space
-      = HA_MD5_BLOCK_SIZE - (ctx->bit_count / 8) % HA_MD5_BLOCK_SIZE;
+  size_t fill = (ctx->bit_count / 8) % HA_MD5_BLOCK_SIZE;
+  size_t buffer_space = HA_MD5_BLOCK_SIZE - fill;
   ctx->bit_count += len * 8;
 
   if (len >= buffer_space)
     {
-      memcpy (ctx->buffer + (HA_MD5_BLOCK_SIZE - buffer_space), data,
-              buffer_space);
+      memcpy (ctx->buffer + fill, data, buffer_space);
       md5_transform (ctx, ctx->buffer);
       data += buffer_space;
       len -= buffer_space;
@@ -100,9 +68,10 @@ ha_md5_update (ha_md5_context *ctx, ha_inbuf_t data, size_t len)
           data += HA_MD5_BLOCK_SIZE;
           len -= HA_MD5_BLOCK_SIZE;
         }
+      fill = 0;
     }
 
-  memcpy (ctx->buffer, data, len);
+  memcpy (ctx->buffer + fill, data, len);
 }
 
 HA_PUBFUN void
@@ -151,3 +120,15 @@ ha_md5_hash (ha_inbuf_t data, size_t len, ha_digest_t digest)
   ha_md5_update (&ctx, data, len);
   ha_md5_final (&ctx, digest);
 }
+
+HA_PUBFUN void
+ha_md5_hash_many (const uint8_t *const *bufs, const size_t *lens, size_t n,
+                  uint8_t *digests)
+{
+#if defined(HA_IMP_X86_SIMD)
+  if (ha_imp_md5_hash_many (bufs, lens, n, digests))
+    return;
+#endif
+  for (size_t i = 0; i < n; ++i)
+    ha_md5_hash (bufs[i], lens[i], digests + i * HA_MD5_DIGEST_SIZE);
+}
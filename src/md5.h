@@ -0,0 +1,52 @@
+#ifndef __hasha_imp_md5_h
+#define __hasha_imp_md5_h
+
+#include "../include/hasha/md5.h"
+#include "../include/hasha/md5_k.h"
+#include "./cpu.h"
+
+/* one MD5 step: round function fn, message word m[k], shift s and round
+   constant K[t]; written for scalars and GCC vectors alike */
+#define MD5_STEP(fn, a, b, c, d, k, s, t)                                     \
+  do                                                                          \
+    {                                                                         \
+      a += fn (b, c, d) + m[k] + HA_MD5_K[t];                                 \
+      a = ha_primitive_rotl32 (a, s) + b;                                     \
+    }                                                                         \
+  while (0)
+
+#define MD5_STEP4(fn, k0, k1, k2, k3, s0, s1, s2, s3, t)                      \
+  MD5_STEP (fn, a, b, c, d, k0, s0, (t) + 0);                                 \
+  MD5_STEP (fn, d, a, b, c, k1, s1, (t) + 1);                                 \
+  MD5_STEP (fn, c, d, a, b, k2, s2, (t) + 2);                                 \
+  MD5_STEP (fn, b, c, d, a, k3, s3, (t) + 3);
+
+/* the 64 steps on a, b, c, d from the message words m[16], with the
+   message indices of each round spelled out */
+#define MD5_STEPS()                                                           \
+  MD5_STEP4 (ha_primitive_md5_f, 0, 1, 2, 3, 7, 12, 17, 22, 0)                \
+  MD5_STEP4 (ha_primitive_md5_f, 4, 5, 6, 7, 7, 12, 17, 22, 4)                \
+  MD5_STEP4 (ha_primitive_md5_f, 8, 9, 10, 11, 7, 12, 17, 22, 8)              \
+  MD5_STEP4 (ha_primitive_md5_f, 12, 13, 14, 15, 7, 12, 17, 22, 12)          \
+  MD5_STEP4 (ha_primitive_md5_g, 1, 6, 11, 0, 5, 9, 14, 20, 16)               \
+  MD5_STEP4 (ha_primitive_md5_g, 5, 10, 15, 4, 5, 9, 14, 20, 20)              \
+  MD5_STEP4 (ha_primitive_md5_g, 9, 14, 3, 8, 5, 9, 14, 20, 24)               \
+  MD5_STEP4 (ha_primitive_md5_g, 13, 2, 7, 12, 5, 9, 14, 20, 28)              \
+  MD5_STEP4 (ha_primitive_md5_h, 5, 8, 11, 14, 4, 11, 16, 23, 32)             \
+  MD5_STEP4 (ha_primitive_md5_h, 1, 4, 7, 10, 4, 11, 16, 23, 36)              \
+  MD5_STEP4 (ha_primitive_md5_h, 13, 0, 3, 6, 4, 11, 16, 23, 40)              \
+  MD5_STEP4 (ha_primitive_md5_h, 9, 12, 15, 2, 4, 11, 16, 23, 44)             \
+  MD5_STEP4 (ha_primitive_md5_i, 0, 7, 14, 5, 6, 10, 15, 21, 48)              \
+  MD5_STEP4 (ha_primitive_md5_i, 12, 3, 10, 1, 6, 10, 15, 21, 52)            \
+  MD5_STEP4 (ha_primitive_md5_i, 8, 15, 6, 13, 6, 10, 15, 21, 56)            \
+  MD5_STEP4 (ha_primitive_md5_i, 4, 11, 2, 9, 6, 10, 15, 21, 60)
+
+#if defined(HA_IMP_X86_SIMD)
+/* hash n independent messages on the widest multi-buffer kernel; returns
+   0 (doing nothing) when hashing them one by one is expected to be
+   faster */
+int ha_imp_md5_hash_many (const uint8_t *const *bufs, const size_t *lens,
+                          size_t n, uint8_t *digests);
+#endif
+
+#endif
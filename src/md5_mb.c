@@ -0,0 +1,186 @@
+#define HA_BUILD
+
+#include "./md5.h"
+
+#include "./endian.h"
+
+/*
+ * Multi-buffer MD5: MD5 is serial within a message, so every SIMD lane
+ * carries an independent one. The kernels run one block per lane on a
+ * transposed state (state[word * lanes + lane]) with the same unrolled
+ * steps as the scalar transform; the driver below feeds blocks, pads the
+ * tails and retires finished lanes by loading the next message.
+ */
+
+#if defined(HA_IMP_X86_SIMD)
+
+/* md5_mb_x<lanes>: one block per lane on the transposed state */
+#define MD5_MB_KERNEL(lanes, isa)                                             \
+  typedef uint32_t md5_v##lanes                                               \
+      __attribute__ ((vector_size (4 * (lanes))));                            \
+                                                                              \
+  HA_IMP_TARGET (isa)                                                         \
+  static void md5_mb_x##lanes (uint32_t *state, const uint8_t *const *blocks) \
+  {                                                                           \
+    md5_v##lanes s[4], m[16], a, b, c, d;                                     \
+    uint32_t w[lanes];                                                        \
+    int t, l;                                                                 \
+                                                                              \
+    for (t = 0; t < 16; ++t)                                                  \
+      {                                                                       \
+        for (l = 0; l < (lanes); ++l)                                         \
+          w[l] = load_le32 (blocks[l] + 4 * t);                               \
+        memcpy (&m[t], w, sizeof (w));                                        \
+      }                                                                       \
+    memcpy (s, state, sizeof (s));                                            \
+    a = s[0], b = s[1], c = s[2], d = s[3];                                   \
+                                                                              \
+    MD5_STEPS ()                                                              \
+                                                                              \
+    s[0] += a, s[1] += b, s[2] += c, s[3] += d;                               \
+    memcpy (state, s, sizeof (s));                                            \
+  }
+
+MD5_MB_KERNEL (8, "avx2")
+MD5_MB_KERNEL (16, "avx512f")
+
+#define MD5_MB_MAX_LANES 16
+
+typedef void (*md5_mb_fn) (uint32_t *state, const uint8_t *const *blocks);
+
+struct md5_mb_lane
+{
+  const uint8_t *data; /* unread full blocks of the message */
+  size_t left;         /* bytes left in data */
+  size_t msg;          /* message index, (size_t)-1 when idle */
+  size_t ntail;        /* padded tail blocks left (set once data < 1 block) */
+  uint64_t bitlen;
+  uint8_t tail[2 * HA_MD5_BLOCK_SIZE];
+};
+
+HA_PRVFUN void
+md5_mb_lane_load (struct md5_mb_lane *lane, size_t msg, const uint8_t *data,
+                  size_t len)
+{
+  lane->data = data;
+  lane->left = len;
+  lane->msg = msg;
+  lane->ntail = 0;
+  lane->bitlen = (uint64_t)len * 8;
+}
+
+/* returns the next block of the lane and whether it is its last one */
+HA_PRVFUN const uint8_t *
+md5_mb_lane_next (struct md5_mb_lane *lane, int *last)
+{
+  const uint8_t *block;
+
+  *last = 0;
+  if (lane->left >= HA_MD5_BLOCK_SIZE)
+    {
+      block = lane->data;
+      lane->data += HA_MD5_BLOCK_SIZE;
+      lane->left -= HA_MD5_BLOCK_SIZE;
+      return block;
+    }
+
+  if (!lane->ntail)
+    {
+      size_t fill = lane->left;
+      lane->ntail = fill + 1 + 8 > HA_MD5_BLOCK_SIZE ? 2 : 1;
+      memset (lane->tail, 0, sizeof (lane->tail));
+      memcpy (lane->tail, lane->data, fill);
+      lane->tail[fill] = 0x80;
+      store_le64 (lane->tail + lane->ntail * HA_MD5_BLOCK_SIZE - 8,
+                  lane->bitlen);
+      lane->left = 0;
+      lane->data = lane->tail;
+    }
+
+  block = lane->data;
+  lane->data += HA_MD5_BLOCK_SIZE;
+  *last = --lane->ntail == 0;
+  return block;
+}
+
+/* feeds n messages through a lanes-wide kernel, refilling each lane with
+   the next message when it finishes */
+static void
+md5_mb_drive (md5_mb_fn kernel, int lanes, const uint8_t *const *bufs,
+              const size_t *lens, size_t n, uint8_t *digests)
+{
+  static const uint8_t idle_block[HA_MD5_BLOCK_SIZE] = { 0 };
+  struct md5_mb_lane lane[MD5_MB_MAX_LANES];
+  const uint8_t *blocks[MD5_MB_MAX_LANES];
+  uint32_t state[4 * MD5_MB_MAX_LANES];
+  int last[MD5_MB_MAX_LANES];
+  size_t next = 0, active = 0;
+  int l, i;
+
+  for (l = 0; l < lanes; ++l)
+    {
+      lane[l].msg = (size_t)-1;
+      if (next < n)
+        {
+          md5_mb_lane_load (&lane[l], next, bufs[next], lens[next]);
+          ++next, ++active;
+        }
+      for (i = 0; i < 4; ++i)
+        state[i * lanes + l] = HA_MD5_H0[i];
+    }
+
+  while (active)
+    {
+      for (l = 0; l < lanes; ++l)
+        {
+          last[l] = 0;
+          blocks[l] = lane[l].msg == (size_t)-1
+                          ? idle_block
+                          : md5_mb_lane_next (&lane[l], &last[l]);
+        }
+
+      kernel (state, blocks);
+
+      for (l = 0; l < lanes; ++l)
+        {
+          if (!last[l])
+            continue;
+
+          for (i = 0; i < 4; ++i)
+            {
+              store_le32 (digests + lane[l].msg * HA_MD5_DIGEST_SIZE + 4 * i,
+                          state[i * lanes + l]);
+              state[i * lanes + l] = HA_MD5_H0[i];
+            }
+          if (next < n)
+            {
+              md5_mb_lane_load (&lane[l], next, bufs[next], lens[next]);
+              ++next;
+            }
+          else
+            {
+              lane[l].msg = (size_t)-1;
+              --active;
+            }
+        }
+    }
+}
+
+int
+ha_imp_md5_hash_many (const uint8_t *const *bufs, const size_t *lens,
+                      size_t n, uint8_t *digests)
+{
+  /* a single message gains nothing from idle lanes */
+  if (n < 2)
+    return 0;
+
+  if (ha_imp_cpu_has (HA_CPU_AVX512F))
+    md5_mb_drive (md5_mb_x16, 16, bufs, lens, n, digests);
+  else if (ha_imp_cpu_has (HA_CPU_AVX2))
+    md5_mb_drive (md5_mb_x8, 8, bufs, lens, n, digests);
+  else
+    return 0;
+  return 1;
+}
+
+#endif
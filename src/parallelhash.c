@@ -0,0 +1,217 @@
+#define HA_BUILD
+
+#include "../include/hasha/parallelhash.h"
+
+#include "./cshake.h"
+#include "./keccak_tree.h"
+
+/*
+ * ParallelHash (X, B, L, S) = cSHAKE (left_encode (B) || z_0 || ... ||
+ * z_{n-1} || right_encode (n) || right_encode (L), L, "ParallelHash", S)
+ * with z_i = SHAKE (X_i, 2c) for the B-byte blocks X_i. The chaining
+ * value length 2c is 200 - rate bytes: 32 for the 128-bit variant and 64
+ * for the 256-bit one.
+ *
+ * A block that arrives in pieces is absorbed into ctx->leaf as it comes.
+ * Runs of whole blocks go to ha_imp_keccak_tree_absorb_leaves (), which
+ * hashes them on the pool and absorbs the chaining values in block order.
+ */
+
+#define PARALLELHASH_CV_MAX 64
+
+HA_PRVFUN size_t
+parallelhash_cvlen (const ha_parallelhash_context *ctx)
+{
+  return 200 - ctx->outer.sponge.rate;
+}
+
+/* absorbs the chaining value of the block in ctx->leaf */
+HA_PRVFUN void
+parallelhash_end_leaf (ha_parallelhash_context *ctx)
+{
+  uint8_t cv[PARALLELHASH_CV_MAX];
+  size_t cvlen = parallelhash_cvlen (ctx);
+
+  ha_imp_keccak_final (&ctx->leaf, HA_PB_SHAKE, cv, cvlen);
+  ha_imp_keccak_update (&ctx->outer.sponge, cv, cvlen);
+  ha_imp_keccak_init (&ctx->leaf, ctx->outer.sponge.rate);
+  ctx->leaf_length = 0;
+  ++ctx->nblocks;
+}
+
+HA_PRVFUN void
+parallelhash_init (ha_parallelhash_context *ctx, size_t rate,
+                   size_t blocksize, const uint8_t *custom,
+                   size_t customlen, ha_pool *pool)
+{
+  uint8_t enc[HA_IMP_CSHAKE_ENCODE_MAX];
+
+  if (!blocksize)
+    blocksize = HA_PARALLELHASH_BLOCKSIZE;
+  ha_imp_cshake_init (&ctx->outer, rate, (const uint8_t *)"ParallelHash",
+                      12, custom, customlen);
+  ha_imp_keccak_update (&ctx->outer.sponge, enc,
+                        ha_imp_cshake_left_encode (enc, blocksize));
+  ha_imp_keccak_init (&ctx->leaf, rate);
+  ctx->blocksize = blocksize;
+  ctx->leaf_length = 0;
+  ctx->nblocks = 0;
+  ctx->pool = pool;
+}
+
+HA_PRVFUN void
+parallelhash_update (ha_parallelhash_context *ctx, const uint8_t *data,
+                     size_t length)
+{
+  struct ha_imp_keccak_leaf leaf;
+  size_t n;
+
+  if (ctx->leaf_length)
+    {
+      size_t take = ctx->blocksize - ctx->leaf_length;
+
+      if (take > length)
+        take = length;
+      ha_imp_keccak_update (&ctx->leaf, data, take);
+      ctx->leaf_length += take;
+      data += take;
+      length -= take;
+      if (ctx->leaf_length < ctx->blocksize)
+        return;
+      parallelhash_end_leaf (ctx);
+    }
+
+  n = length / ctx->blocksize;
+  if (n)
+    {
+      leaf.padbyte = HA_PB_SHAKE;
+      leaf.rounds = 24;
+      leaf.rate = ctx->outer.sponge.rate;
+      leaf.leaflen = ctx->blocksize;
+      leaf.cvlen = parallelhash_cvlen (ctx);
+      ha_imp_keccak_tree_absorb_leaves (ctx->pool, &leaf, &ctx->outer.sponge,
+                                        data, n);
+      ctx->nblocks += n;
+      data += n * ctx->blocksize;
+      length -= n * ctx->blocksize;
+    }
+
+  if (length)
+    {
+      ha_imp_keccak_update (&ctx->leaf, data, length);
+      ctx->leaf_length = length;
+    }
+}
+
+HA_PRVFUN void
+parallelhash_final (ha_parallelhash_context *ctx, uint64_t bits,
+                    ha_digest_t digest, size_t digestlen)
+{
+  uint8_t enc[HA_IMP_CSHAKE_ENCODE_MAX];
+
+  if (ctx->leaf_length)
+    parallelhash_end_leaf (ctx);
+  ha_imp_keccak_update (&ctx->outer.sponge, enc,
+                        ha_imp_cshake_right_encode (enc, ctx->nblocks));
+  ha_imp_cshake_final_with_length (&ctx->outer, bits, digest, digestlen);
+}
+
+HA_PUBFUN void
+ha_parallelhash128_init (ha_parallelhash128_context *ctx, size_t blocksize,
+                         const uint8_t *custom, size_t customlen,
+                         ha_pool *pool)
+{
+  parallelhash_init (ctx, HA_SHAKE128_RATE, blocksize, custom, customlen,
+                     pool);
+}
+
+HA_PUBFUN void
+ha_parallelhash128_update (ha_parallelhash128_context *ctx, ha_inbuf_t data,
+                           size_t length)
+{
+  parallelhash_update (ctx, data, length);
+}
+
+HA_PUBFUN void
+ha_parallelhash128_final (ha_parallelhash128_context *ctx,
+                          ha_digest_t digest, size_t digestlen)
+{
+  parallelhash_final (ctx, (uint64_t)digestlen * 8, digest, digestlen);
+}
+
+HA_PUBFUN void
+ha_parallelhash128_final_xof (ha_parallelhash128_context *ctx,
+                              ha_digest_t out, size_t outlen)
+{
+  parallelhash_final (ctx, 0, out, outlen);
+}
+
+HA_PUBFUN void
+ha_parallelhash128_squeeze (ha_parallelhash128_context *ctx,
+                            ha_digest_t out, size_t length)
+{
+  ha_imp_keccak_squeeze (&ctx->outer.sponge, out, length);
+}
+
+HA_PUBFUN void
+ha_parallelhash128_hash (ha_inbuf_t data, size_t length, size_t blocksize,
+                         const uint8_t *custom, size_t customlen,
+                         ha_pool *pool, ha_digest_t digest,
+                         size_t digestlen)
+{
+  ha_parallelhash128_context ctx;
+  parallelhash_init (&ctx, HA_SHAKE128_RATE, blocksize, custom, customlen,
+                     pool);
+  parallelhash_update (&ctx, data, length);
+  parallelhash_final (&ctx, (uint64_t)digestlen * 8, digest, digestlen);
+}
+
+HA_PUBFUN void
+ha_parallelhash256_init (ha_parallelhash256_context *ctx, size_t blocksize,
+                         const uint8_t *custom, size_t customlen,
+                         ha_pool *pool)
+{
+  parallelhash_init (ctx, HA_SHAKE256_RATE, blocksize, custom, customlen,
+                     pool);
+}
+
+HA_PUBFUN void
+ha_parallelhash256_update (ha_parallelhash256_context *ctx, ha_inbuf_t data,
+                           size_t length)
+{
+  parallelhash_update (ctx, data, length);
+}
+
+HA_PUBFUN void
+ha_parallelhash256_final (ha_parallelhash256_context *ctx,
+                          ha_digest_t digest, size_t digestlen)
+{
+  parallelhash_final (ctx, (uint64_t)digestlen * 8, digest, digestlen);
+}
+
+HA_PUBFUN void
+ha_parallelhash256_final_xof (ha_parallelhash256_context *ctx,
+                              ha_digest_t out, size_t outlen)
+{
+  parallelhash_final (ctx, 0, out, outlen);
+}
+
+HA_PUBFUN void
+ha_parallelhash256_squeeze (ha_parallelhash256_context *ctx,
+                            ha_digest_t out, size_t length)
+{
+  ha_imp_keccak_squeeze (&ctx->outer.sponge, out, length);
+}
+
+HA_PUBFUN void
+ha_parallelhash256_hash (ha_inbuf_t data, size_t length, size_t blocksize,
+                         const uint8_t *custom, size_t customlen,
+                         ha_pool *pool, ha_digest_t digest,
+                         size_t digestlen)
+{
+  ha_parallelhash256_context ctx;
+  parallelhash_init (&ctx, HA_SHAKE256_RATE, blocksize, custom, customlen,
+                     pool);
+  parallelhash_update (&ctx, data, length);
+  parallelhash_final (&ctx, (uint64_t)digestlen * 8, digest, digestlen);
+}
@@ -0,0 +1,188 @@
+#define HA_BUILD
+
+#include "./pool.h"
+
+#include <stdlib.h>
+
+#if ha_has_feature(THREADS)
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+/*
+ * A fixed set of workers parked on a condition variable. A job is a range
+ * of task indices; the caller publishes it under the lock, bumps the job
+ * generation and then takes tasks itself. Every participant claims the
+ * next index with an atomic increment, so uneven tasks balance out, and
+ * the caller returns once each worker has checked out of the job.
+ */
+
+struct ha_pool
+{
+  size_t nthreads;
+#if ha_has_feature(THREADS)
+  pthread_t *workers;
+  pthread_mutex_t run;  /* held by the caller for a whole job */
+  pthread_mutex_t lock; /* guards the fields below */
+  pthread_cond_t wake;  /* a new job was published, or stop */
+  pthread_cond_t done;  /* the last worker left the job */
+  unsigned long job;    /* generation of the current job */
+  size_t pending;       /* workers still inside the job */
+  int stop;
+  ha_imp_pool_task_fn fn;
+  void *arg;
+  size_t ntasks;
+  size_t next; /* next unclaimed task, taken atomically */
+#endif
+};
+
+#if ha_has_feature(THREADS)
+
+static void
+pool_drain (ha_pool *pool)
+{
+  size_t i;
+
+  while ((i = __atomic_fetch_add (&pool->next, 1, __ATOMIC_RELAXED))
+         < pool->ntasks)
+    pool->fn (pool->arg, i);
+}
+
+static void *
+pool_worker (void *p)
+{
+  ha_pool *pool = p;
+  unsigned long seen = 0;
+
+  pthread_mutex_lock (&pool->lock);
+  for (;;)
+    {
+      while (!pool->stop && pool->job == seen)
+        pthread_cond_wait (&pool->wake, &pool->lock);
+      if (pool->stop)
+        break;
+      seen = pool->job;
+      pthread_mutex_unlock (&pool->lock);
+
+      pool_drain (pool);
+
+      pthread_mutex_lock (&pool->lock);
+      if (--pool->pending == 0)
+        pthread_cond_signal (&pool->done);
+    }
+  pthread_mutex_unlock (&pool->lock);
+  return NULL;
+}
+
+static size_t
+pool_online_cpus (void)
+{
+  long n = sysconf (_SC_NPROCESSORS_ONLN);
+  return n > 0 ? (size_t)n : 1;
+}
+
+#endif
+
+HA_PUBFUN ha_pool *
+ha_pool_create (size_t nthreads)
+{
+  ha_pool *pool = calloc (1, sizeof (*pool));
+
+  if (!pool)
+    return NULL;
+
+#if ha_has_feature(THREADS)
+  if (!nthreads)
+    nthreads = pool_online_cpus ();
+  pool->workers = calloc (nthreads, sizeof (*pool->workers));
+  if (!pool->workers)
+    {
+      free (pool);
+      return NULL;
+    }
+  pthread_mutex_init (&pool->run, NULL);
+  pthread_mutex_init (&pool->lock, NULL);
+  pthread_cond_init (&pool->wake, NULL);
+  pthread_cond_init (&pool->done, NULL);
+
+  /* a worker that fails to start only makes the pool smaller */
+  pool->nthreads = 1;
+  while (pool->nthreads < nthreads
+         && pthread_create (&pool->workers[pool->nthreads - 1], NULL,
+                            pool_worker, pool)
+                == 0)
+    ++pool->nthreads;
+#else
+  (void)nthreads;
+  pool->nthreads = 1;
+#endif
+  return pool;
+}
+
+HA_PUBFUN void
+ha_pool_destroy (ha_pool *pool)
+{
+  if (!pool)
+    return;
+
+#if ha_has_feature(THREADS)
+  pthread_mutex_lock (&pool->lock);
+  pool->stop = 1;
+  pthread_cond_broadcast (&pool->wake);
+  pthread_mutex_unlock (&pool->lock);
+  for (size_t i = 0; i + 1 < pool->nthreads; ++i)
+    pthread_join (pool->workers[i], NULL);
+
+  pthread_cond_destroy (&pool->done);
+  pthread_cond_destroy (&pool->wake);
+  pthread_mutex_destroy (&pool->lock);
+  pthread_mutex_destroy (&pool->run);
+  free (pool->workers);
+#endif
+  free (pool);
+}
+
+HA_PUBFUN size_t
+ha_pool_size (const ha_pool *pool)
+{
+  return pool ? pool->nthreads : 1;
+}
+
+void
+ha_imp_pool_run (ha_pool *pool, ha_imp_pool_task_fn fn, void *arg,
+                 size_t ntasks)
+{
+  size_t i;
+
+#if ha_has_feature(THREADS)
+  if (pool && pool->nthreads > 1 && ntasks > 1)
+    {
+      pthread_mutex_lock (&pool->run);
+
+      pthread_mutex_lock (&pool->lock);
+      pool->fn = fn;
+      pool->arg = arg;
+      pool->ntasks = ntasks;
+      pool->next = 0;
+      pool->pending = pool->nthreads - 1;
+      ++pool->job;
+      pthread_cond_broadcast (&pool->wake);
+      pthread_mutex_unlock (&pool->lock);
+
+      pool_drain (pool);
+
+      pthread_mutex_lock (&pool->lock);
+      while (pool->pending)
+        pthread_cond_wait (&pool->done, &pool->lock);
+      pthread_mutex_unlock (&pool->lock);
+
+      pthread_mutex_unlock (&pool->run);
+      return;
+    }
+#else
+  (void)pool;
+#endif
+
+  for (i = 0; i < ntasks; ++i)
+    fn (arg, i);
+}
@@ -0,0 +1,14 @@
+#ifndef __hasha_imp_pool_h
+#define __hasha_imp_pool_h
+
+#include "../include/hasha/pool.h"
+
+typedef void (*ha_imp_pool_task_fn) (void *arg, size_t index);
+
+/* Calls fn (arg, i) for every i < ntasks, spread over the pool's threads
+   and the caller, and returns once all calls have finished. A NULL pool
+   runs them in order on the caller. */
+void ha_imp_pool_run (ha_pool *pool, ha_imp_pool_task_fn fn, void *arg,
+                      size_t ntasks);
+
+#endif
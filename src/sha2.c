@@ -1,8 +1,7 @@
 #define HA_BUILD
 
-#include "../include/hasha/sha2.h"
+#include "./sha2.h"
 
-#include "../include/hasha/sha2_k.h"
 #include "./endian.h"
 
 HA_PUBFUN void
@@ -44,7 +43,21 @@ ha_sha2_224_hash (ha_inbuf_t data, size_t length, ha_digest_t digest)
 }
 
 HA_PUBFUN void
-ha_sha2_256_transform (ha_sha2_256_context *ctx, const uint8_t *block)
+ha_sha2_224_hash_many (const uint8_t *const *bufs, const size_t *lens,
+                       size_t n, uint8_t *digests)
+{
+#if defined(HA_IMP_X86_SIMD)
+  if (ha_imp_sha2_256_hash_many (HA_SHA2_224_H0, HA_SHA2_224_DIGEST_SIZE,
+                                 bufs, lens, n, digests))
+    return;
+#endif
+  for (size_t i = 0; i < n; ++i)
+    ha_sha2_224_hash (bufs[i], lens[i],
+                      digests + i * HA_SHA2_224_DIGEST_SIZE);
+}
+
+HA_PRVFUN void
+sha2_256_block_scalar (uint32_t *state, const uint8_t *block)
 {
   uint32_t W[64];
   uint32_t a, b, c, d, e, f, g, h;
@@ -70,14 +83,14 @@ ha_sha2_256_transform (ha_sha2_256_context *ctx, const uint8_t *block)
              + ha_primitive_sigma0_32 (W[t - 15]) + W[t - 16];
     }
 
-  a = ctx->state[0];
-  b = ctx->state[1];
-  c = ctx->state[2];
-  d = ctx->state[3];
-  e = ctx->state[4];
-  f = ctx->state[5];
-  g = ctx->state[6];
-  h = ctx->state[7];
+  a = state[0];
+  b = state[1];
+  c = state[2];
+  d = state[3];
+  e = state[4];
+  f = state[5];
+  g = state[6];
+  h = state[7];
 
   for (int t = 0; t < 64; ++t)
     {
@@ -94,14 +107,47 @@ ha_sha2_256_transform (ha_sha2_256_context *ctx, const uint8_t *block)
       a = T1 + T2;
     }
 
-  ctx->state[0] += a;
-  ctx->state[1] += b;
-  ctx->state[2] += c;
-  ctx->state[3] += d;
-  ctx->state[4] += e;
-  ctx->state[5] += f;
-  ctx->state[6] += g;
-  ctx->state[7] += h;
+  state[0] += a;
+  state[1] += b;
+  state[2] += c;
+  state[3] += d;
+  state[4] += e;
+  state[5] += f;
+  state[6] += g;
+  state[7] += h;
+}
+
+static void
+sha2_256_blocks_scalar (uint32_t *state, const uint8_t *blocks,
+                        size_t nblocks)
+{
+  for (; nblocks; --nblocks, blocks += HA_SHA2_256_BLOCK_SIZE)
+    sha2_256_block_scalar (state, blocks);
+}
+
+static ha_imp_sha2_256_blocks_fn
+sha2_256_blocks_select (void)
+{
+#if defined(HA_IMP_X86_SIMD)
+  if (ha_imp_cpu_has (HA_CPU_SHA | HA_CPU_SSE41))
+    return ha_imp_sha2_256_blocks_shani;
+#endif
+  return sha2_256_blocks_scalar;
+}
+
+HA_PRVFUN void
+sha2_256_blocks (uint32_t *state, const uint8_t *blocks, size_t nblocks)
+{
+  static ha_imp_sha2_256_blocks_fn fn = NULL;
+  if (!fn)
+    fn = sha2_256_blocks_select ();
+  fn (state, blocks, nblocks);
+}
+
+HA_PUBFUN void
+ha_sha2_256_transform (ha_sha2_256_context *ctx, const uint8_t *block)
+{
+  sha2_256_blocks (ctx->state, block, 1);
 }
 
 HA_PUBFUN void
@@ -120,29 +166,43 @@ ha_sha2_256_init (ha_sha2_256_context *ctx)
   memset (ctx->buffer, 0, HA_SHA2_256_BLOCK_SIZE);
 }
 
+HA_PUBFUN void
+ha_sha2_256_transform_blocks (ha_sha2_256_context *ctx, const uint8_t *data,
+                              size_t nblocks)
+{
+  sha2_256_blocks (ctx->state, data, nblocks);
+}
+
 HA_PUBFUN void
 ha_sha2_256_update (ha_sha2_256_context *ctx, ha_inbuf_t data, size_t length)
 {
   size_t buffer_fill = ctx->bit_count / 8 % HA_SHA2_256_BLOCK_SIZE;
   ctx->bit_count += (uint64_t)length * 8;
 
-  size_t offset = 0;
-  while (length > 0)
+  /* complete a block left over from the previous update */
+  if (buffer_fill)
     {
       size_t space = HA_SHA2_256_BLOCK_SIZE - buffer_fill;
       size_t copy_size = length < space ? length : space;
 
-      memcpy (ctx->buffer + buffer_fill, data + offset, copy_size);
-      buffer_fill += copy_size;
-      offset += copy_size;
+      memcpy (ctx->buffer + buffer_fill, data, copy_size);
+      data += copy_size;
       length -= copy_size;
+      if (buffer_fill + copy_size < HA_SHA2_256_BLOCK_SIZE)
+        return;
+      sha2_256_blocks (ctx->state, ctx->buffer, 1);
+    }
 
-      if (buffer_fill == HA_SHA2_256_BLOCK_SIZE)
-        {
-          ha_sha2_256_transform (ctx, ctx->buffer);
-          buffer_fill = 0;
-        }
+  /* whole blocks straight from the input */
+  if (length >= HA_SHA2_256_BLOCK_SIZE)
+    {
+      size_t nblocks = length / HA_SHA2_256_BLOCK_SIZE;
+      sha2_256_blocks (ctx->state, data, nblocks);
+      data += nblocks * HA_SHA2_256_BLOCK_SIZE;
+      length -= nblocks * HA_SHA2_256_BLOCK_SIZE;
     }
+
+  memcpy (ctx->buffer, data, length);
 }
 
 HA_PUBFUN void
@@ -191,6 +251,20 @@ ha_sha2_256_hash (ha_inbuf_t data, size_t length, ha_digest_t digest)
   ha_sha2_256_final (&ctx, digest);
 }
 
+HA_PUBFUN void
+ha_sha2_256_hash_many (const uint8_t *const *bufs, const size_t *lens,
+                       size_t n, uint8_t *digests)
+{
+#if defined(HA_IMP_X86_SIMD)
+  if (ha_imp_sha2_256_hash_many (HA_SHA2_256_H0, HA_SHA2_256_DIGEST_SIZE,
+                                 bufs, lens, n, digests))
+    return;
+#endif
+  for (size_t i = 0; i < n; ++i)
+    ha_sha2_256_hash (bufs[i], lens[i],
+                      digests + i * HA_SHA2_256_DIGEST_SIZE);
+}
+
 HA_PUBFUN void
 ha_sha2_384_transform (ha_sha2_384_context *ctx, const uint8_t *block)
 {
@@ -230,7 +304,21 @@ ha_sha2_384_hash (ha_inbuf_t data, size_t length, ha_digest_t digest)
 }
 
 HA_PUBFUN void
-ha_sha2_512_transform (ha_sha2_512_context *ctx, const uint8_t *block)
+ha_sha2_384_hash_many (const uint8_t *const *bufs, const size_t *lens,
+                       size_t n, uint8_t *digests)
+{
+#if defined(HA_IMP_X86_SIMD)
+  if (ha_imp_sha2_512_hash_many (HA_SHA2_384_H0, HA_SHA2_384_DIGEST_SIZE,
+                                 bufs, lens, n, digests))
+    return;
+#endif
+  for (size_t i = 0; i < n; ++i)
+    ha_sha2_384_hash (bufs[i], lens[i],
+                      digests + i * HA_SHA2_384_DIGEST_SIZE);
+}
+
+HA_PRVFUN void
+sha2_512_block_scalar (uint64_t *state, const uint8_t *block)
 {
   uint64_t m[80];
   uint64_t a, b, c, d, e, f, g, h;
@@ -262,14 +350,14 @@ ha_sha2_512_transform (ha_sha2_512_context *ctx, const uint8_t *block)
              + ha_primitive_sigma0_64 (m[i - 15]) + m[i - 16];
     }
 
-  a = ctx->state[0];
-  b = ctx->state[1];
-  c = ctx->state[2];
-  d = ctx->state[3];
-  e = ctx->state[4];
-  f = ctx->state[5];
-  g = ctx->state[6];
-  h = ctx->state[7];
+  a = state[0];
+  b = state[1];
+  c = state[2];
+  d = state[3];
+  e = state[4];
+  f = state[5];
+  g = state[6];
+  h = state[7];
 
   for (int i = 0; i < 80; ++i)
     {
@@ -287,14 +375,54 @@ ha_sha2_512_transform (ha_sha2_512_context *ctx, const uint8_t *block)
       a = T1 + T2;
     }
 
-  ctx->state[0] += a;
-  ctx->state[1] += b;
-  ctx->state[2] += c;
-  ctx->state[3] += d;
-  ctx->state[4] += e;
-  ctx->state[5] += f;
-  ctx->state[6] += g;
-  ctx->state[7] += h;
+  state[0] += a;
+  state[1] += b;
+  state[2] += c;
+  state[3] += d;
+  state[4] += e;
+  state[5] += f;
+  state[6] += g;
+  state[7] += h;
+}
+
+static void
+sha2_512_blocks_scalar (uint64_t *state, const uint8_t *blocks,
+                        size_t nblocks)
+{
+  for (; nblocks; --nblocks, blocks += HA_SHA2_512_BLOCK_SIZE)
+    sha2_512_block_scalar (state, blocks);
+}
+
+static ha_imp_sha2_512_blocks_fn
+sha2_512_blocks_select (void)
+{
+#if defined(HA_IMP_X86_SIMD)
+  if (ha_imp_cpu_has (HA_CPU_AVX2 | HA_CPU_BMI2))
+    return ha_imp_sha2_512_blocks_avx2;
+#endif
+  return sha2_512_blocks_scalar;
+}
+
+HA_PRVFUN void
+sha2_512_blocks (uint64_t *state, const uint8_t *blocks, size_t nblocks)
+{
+  static ha_imp_sha2_512_blocks_fn fn = NULL;
+  if (!fn)
+    fn = sha2_512_blocks_select ();
+  fn (state, blocks, nblocks);
+}
+
+HA_PUBFUN void
+ha_sha2_512_transform (ha_sha2_512_context *ctx, const uint8_t *block)
+{
+  sha2_512_blocks (ctx->state, block, 1);
+}
+
+HA_PUBFUN void
+ha_sha2_512_transform_blocks (ha_sha2_512_context *ctx, const uint8_t *data,
+                              size_t nblocks)
+{
+  sha2_512_blocks (ctx->state, data, nblocks);
 }
 
 HA_PUBFUN void
@@ -319,22 +447,30 @@ ha_sha2_512_update (ha_sha2_512_context *ctx, ha_inbuf_t data, size_t len)
   size_t buffer_fill = (ctx->bit_count / 8) % HA_SHA2_512_BLOCK_SIZE;
   ctx->bit_count += (uint64_t)len * 8;
 
-  size_t offset = 0;
-  while (len > 0)
+  /* complete a block left over from the previous update */
+  if (buffer_fill)
     {
       size_t space_in_buffer = HA_SHA2_512_BLOCK_SIZE - buffer_fill;
       size_t to_copy = (len < space_in_buffer) ? len : space_in_buffer;
-      memcpy (ctx->buffer + buffer_fill, data + offset, to_copy);
-      buffer_fill += to_copy;
-      offset += to_copy;
+
+      memcpy (ctx->buffer + buffer_fill, data, to_copy);
+      data += to_copy;
       len -= to_copy;
+      if (buffer_fill + to_copy < HA_SHA2_512_BLOCK_SIZE)
+        return;
+      sha2_512_blocks (ctx->state, ctx->buffer, 1);
+    }
 
-      if (buffer_fill == HA_SHA2_512_BLOCK_SIZE)
-        {
-          ha_sha2_512_transform (ctx, ctx->buffer);
-          buffer_fill = 0;
-        }
+  /* whole blocks straight from the input */
+  if (len >= HA_SHA2_512_BLOCK_SIZE)
+    {
+      size_t nblocks = len / HA_SHA2_512_BLOCK_SIZE;
+      sha2_512_blocks (ctx->state, data, nblocks);
+      data += nblocks * HA_SHA2_512_BLOCK_SIZE;
+      len -= nblocks * HA_SHA2_512_BLOCK_SIZE;
     }
+
+  memcpy (ctx->buffer, data, len);
 }
 
 HA_PUBFUN void
@@ -347,19 +483,20 @@ ha_sha2_512_final (ha_sha2_512_context *ctx, ha_digest_t digest)
     {
       memset (ctx->buffer + buffer_fill, 0,
               HA_SHA2_512_BLOCK_SIZE - buffer_fill);
-      ha_sha2_512_transform (ctx, ctx->buffer);
+      sha2_512_blocks (ctx->state, ctx->buffer, 1);
       buffer_fill = 0;
     }
 
+  /* the high 64 bits of the 128-bit length field stay zero */
   memset (ctx->buffer + buffer_fill, 0,
-          HA_SHA2_512_BLOCK_SIZE - buffer_fill - 16);
+          HA_SHA2_512_BLOCK_SIZE - buffer_fill - 8);
   for (int i = 0; i < 8; ++i)
     {
       ctx->buffer[HA_SHA2_512_BLOCK_SIZE - 1 - i]
           = (ctx->bit_count >> (8 * i)) & 0xff;
     }
 
-  ha_sha2_512_transform (ctx, ctx->buffer);
+  sha2_512_blocks (ctx->state, ctx->buffer, 1);
 
 #ifdef HA_ONLY_LE
   for (int i = 0; i < 8; ++i)
@@ -388,6 +525,20 @@ ha_sha2_512_hash (ha_inbuf_t data, size_t length, ha_digest_t digest)
   ha_sha2_512_final (&ctx, digest);
 }
 
+HA_PUBFUN void
+ha_sha2_512_hash_many (const uint8_t *const *bufs, const size_t *lens,
+                       size_t n, uint8_t *digests)
+{
+#if defined(HA_IMP_X86_SIMD)
+  if (ha_imp_sha2_512_hash_many (HA_SHA2_512_H0, HA_SHA2_512_DIGEST_SIZE,
+                                 bufs, lens, n, digests))
+    return;
+#endif
+  for (size_t i = 0; i < n; ++i)
+    ha_sha2_512_hash (bufs[i], lens[i],
+                      digests + i * HA_SHA2_512_DIGEST_SIZE);
+}
+
 HA_PUBFUN void
 ha_sha2_512_224_transform (ha_sha2_512_224_context *ctx, const uint8_t *block)
 {
@@ -427,6 +578,21 @@ ha_sha2_512_224_hash (ha_inbuf_t data, size_t length, ha_digest_t digest)
   ha_sha2_512_224_final (&ctx, digest);
 }
 
+HA_PUBFUN void
+ha_sha2_512_224_hash_many (const uint8_t *const *bufs, const size_t *lens,
+                           size_t n, uint8_t *digests)
+{
+#if defined(HA_IMP_X86_SIMD)
+  if (ha_imp_sha2_512_hash_many (HA_SHA2_512_224_H0,
+                                 HA_SHA2_512_224_DIGEST_SIZE, bufs, lens, n,
+                                 digests))
+    return;
+#endif
+  for (size_t i = 0; i < n; ++i)
+    ha_sha2_512_224_hash (bufs[i], lens[i],
+                          digests + i * HA_SHA2_512_224_DIGEST_SIZE);
+}
+
 HA_PUBFUN void
 ha_sha2_512_256_transform (ha_sha2_512_256_context *ctx, const uint8_t *block)
 {
@@ -464,4 +630,19 @@ ha_sha2_512_256_hash (ha_inbuf_t data, size_t length, ha_digest_t digest)
   ha_sha2_512_256_init (&ctx);
   ha_sha2_512_256_update (&ctx, data, length);
   ha_sha2_512_256_final (&ctx, digest);
-}
\ No newline at end of file
+}
+
+HA_PUBFUN void
+ha_sha2_512_256_hash_many (const uint8_t *const *bufs, const size_t *lens,
+                           size_t n, uint8_t *digests)
+{
+#if defined(HA_IMP_X86_SIMD)
+  if (ha_imp_sha2_512_hash_many (HA_SHA2_512_256_H0,
+                                 HA_SHA2_512_256_DIGEST_SIZE, bufs, lens, n,
+                                 digests))
+    return;
+#endif
+  for (size_t i = 0; i < n; ++i)
+    ha_sha2_512_256_hash (bufs[i], lens[i],
+                          digests + i * HA_SHA2_512_256_DIGEST_SIZE);
+}
@@ -0,0 +1,37 @@
+#ifndef __hasha_imp_sha2_h
+#define __hasha_imp_sha2_h
+
+#include "../include/hasha/sha2.h"
+#include "../include/hasha/sha2_k.h"
+#include "./cpu.h"
+
+/* compress nblocks consecutive 64-byte blocks into state */
+typedef void (*ha_imp_sha2_256_blocks_fn) (uint32_t *state,
+                                           const uint8_t *blocks,
+                                           size_t nblocks);
+
+/* compress nblocks consecutive 128-byte blocks into state */
+typedef void (*ha_imp_sha2_512_blocks_fn) (uint64_t *state,
+                                           const uint8_t *blocks,
+                                           size_t nblocks);
+
+#if defined(HA_IMP_X86_SIMD)
+void ha_imp_sha2_256_blocks_shani (uint32_t *state, const uint8_t *blocks,
+                                   size_t nblocks);
+void ha_imp_sha2_512_blocks_avx2 (uint64_t *state, const uint8_t *blocks,
+                                  size_t nblocks);
+
+/* hash n independent messages on the widest multi-buffer kernel and store
+   the first outlen bytes of each digest; returns 0 (doing nothing) when
+   hashing them one by one is expected to be faster */
+int ha_imp_sha2_256_hash_many (const uint32_t *iv, size_t outlen,
+                               const uint8_t *const *bufs,
+                               const size_t *lens, size_t n,
+                               uint8_t *digests);
+int ha_imp_sha2_512_hash_many (const uint64_t *iv, size_t outlen,
+                               const uint8_t *const *bufs,
+                               const size_t *lens, size_t n,
+                               uint8_t *digests);
+#endif
+
+#endif
@@ -0,0 +1,133 @@
+#define HA_BUILD
+
+#include "./sha2.h"
+
+#if defined(HA_IMP_X86_SIMD)
+
+#include <immintrin.h>
+
+/*
+ * SHA-512 with the message schedule of four consecutive blocks computed
+ * side by side, one block per 64-bit AVX2 lane. W[t] + K[t] lands in
+ * wk[t][lane], and the rounds of each block then run on scalar
+ * registers; the vector schedule of a group and the scalar rounds are
+ * independent, so the out-of-order core overlaps them.
+ */
+
+#define AVX2_ROTR64(x, n)                                                     \
+  _mm256_or_si256 (_mm256_srli_epi64 (x, n), _mm256_slli_epi64 (x, 64 - (n)))
+
+#define AVX2_SIGMA0_64(x)                                                     \
+  _mm256_xor_si256 (_mm256_xor_si256 (AVX2_ROTR64 (x, 1), AVX2_ROTR64 (x, 8)), \
+                    _mm256_srli_epi64 (x, 7))
+
+#define AVX2_SIGMA1_64(x)                                                     \
+  _mm256_xor_si256 (                                                          \
+      _mm256_xor_si256 (AVX2_ROTR64 (x, 19), AVX2_ROTR64 (x, 61)),            \
+      _mm256_srli_epi64 (x, 6))
+
+#define SHA2_512_ROUND(a, b, c, d, e, f, g, h, t)                             \
+  do                                                                          \
+    {                                                                         \
+      h += ha_primitive_Sigma1_64 (e) + ha_primitive_ch (e, f, g)             \
+           + wk[t][lane];                                                     \
+      d += h;                                                                 \
+      h += ha_primitive_Sigma0_64 (a) + ha_primitive_maj (a, b, c);           \
+    }                                                                         \
+  while (0)
+
+HA_IMP_TARGET ("avx2,bmi2")
+static void
+sha2_512_schedule_x4 (uint64_t wk[80][4], const uint8_t *const blocks[4])
+{
+  const __m256i bswap = _mm256_set_epi8 (
+      8, 9, 10, 11, 12, 13, 14, 15, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12,
+      13, 14, 15, 0, 1, 2, 3, 4, 5, 6, 7);
+  __m256i w[16];
+  int t;
+
+  /* load words 4i..4i+3 of each block and transpose them into lanes */
+  for (t = 0; t < 16; t += 4)
+    {
+      __m256i r0, r1, r2, r3, t0, t1, t2, t3;
+
+      r0 = _mm256_shuffle_epi8 (
+          _mm256_loadu_si256 ((const __m256i *)(blocks[0] + 8 * t)), bswap);
+      r1 = _mm256_shuffle_epi8 (
+          _mm256_loadu_si256 ((const __m256i *)(blocks[1] + 8 * t)), bswap);
+      r2 = _mm256_shuffle_epi8 (
+          _mm256_loadu_si256 ((const __m256i *)(blocks[2] + 8 * t)), bswap);
+      r3 = _mm256_shuffle_epi8 (
+          _mm256_loadu_si256 ((const __m256i *)(blocks[3] + 8 * t)), bswap);
+
+      t0 = _mm256_unpacklo_epi64 (r0, r1);
+      t1 = _mm256_unpackhi_epi64 (r0, r1);
+      t2 = _mm256_unpacklo_epi64 (r2, r3);
+      t3 = _mm256_unpackhi_epi64 (r2, r3);
+
+      w[t + 0] = _mm256_permute2x128_si256 (t0, t2, 0x20);
+      w[t + 1] = _mm256_permute2x128_si256 (t1, t3, 0x20);
+      w[t + 2] = _mm256_permute2x128_si256 (t0, t2, 0x31);
+      w[t + 3] = _mm256_permute2x128_si256 (t1, t3, 0x31);
+    }
+
+  for (t = 0; t < 80; ++t)
+    {
+      if (t >= 16)
+        w[t & 15] = _mm256_add_epi64 (
+            _mm256_add_epi64 (w[t & 15], AVX2_SIGMA1_64 (w[(t - 2) & 15])),
+            _mm256_add_epi64 (w[(t - 7) & 15],
+                              AVX2_SIGMA0_64 (w[(t - 15) & 15])));
+      _mm256_storeu_si256 (
+          (__m256i *)wk[t],
+          _mm256_add_epi64 (w[t & 15],
+                            _mm256_set1_epi64x ((long long)HA_SHA2_512_K[t])));
+    }
+}
+
+HA_IMP_TARGET ("avx2,bmi2")
+void
+ha_imp_sha2_512_blocks_avx2 (uint64_t *state, const uint8_t *blocks,
+                             size_t nblocks)
+{
+  uint64_t wk[80][4];
+  const uint8_t *group[4];
+  uint64_t a, b, c, d, e, f, g, h;
+  size_t i, n, lane;
+  int t;
+
+  while (nblocks)
+    {
+      /* a short group repeats its last block in the unused lanes */
+      n = nblocks < 4 ? nblocks : 4;
+      for (i = 0; i < 4; ++i)
+        group[i] = blocks + (i < n ? i : n - 1) * HA_SHA2_512_BLOCK_SIZE;
+      sha2_512_schedule_x4 (wk, group);
+
+      for (lane = 0; lane < n; ++lane)
+        {
+          a = state[0], b = state[1], c = state[2], d = state[3];
+          e = state[4], f = state[5], g = state[6], h = state[7];
+
+          for (t = 0; t < 80; t += 8)
+            {
+              SHA2_512_ROUND (a, b, c, d, e, f, g, h, t + 0);
+              SHA2_512_ROUND (h, a, b, c, d, e, f, g, t + 1);
+              SHA2_512_ROUND (g, h, a, b, c, d, e, f, t + 2);
+              SHA2_512_ROUND (f, g, h, a, b, c, d, e, t + 3);
+              SHA2_512_ROUND (e, f, g, h, a, b, c, d, t + 4);
+              SHA2_512_ROUND (d, e, f, g, h, a, b, c, t + 5);
+              SHA2_512_ROUND (c, d, e, f, g, h, a, b, t + 6);
+              SHA2_512_ROUND (b, c, d, e, f, g, h, a, t + 7);
+            }
+
+          state[0] += a, state[1] += b, state[2] += c, state[3] += d;
+          state[4] += e, state[5] += f, state[6] += g, state[7] += h;
+        }
+
+      blocks += n * HA_SHA2_512_BLOCK_SIZE;
+      nblocks -= n;
+    }
+}
+
+#endif
@@ -0,0 +1,256 @@
+#define HA_BUILD
+
+#include "./sha2.h"
+
+#include "./endian.h"
+
+/*
+ * Multi-buffer SHA-2: every SIMD lane carries an independent message.
+ * The kernels compress one block per lane on a transposed state
+ * (state[word * lanes + lane]); the driver below feeds blocks, pads
+ * the tails and retires finished lanes by loading the next message.
+ */
+
+#if defined(HA_IMP_X86_SIMD)
+
+/* one round on word size ws (32 or 64) with round constants K */
+#define SHA2_MB_ROUND(ws, K, a, b, c, d, e, f, g, h, t)                       \
+  do                                                                          \
+    {                                                                         \
+      if ((t) >= 16)                                                          \
+        w[(t) & 15] += ha_primitive_sigma1_##ws (w[((t) - 2) & 15])           \
+                       + w[((t) - 7) & 15]                                    \
+                       + ha_primitive_sigma0_##ws (w[((t) - 15) & 15]);       \
+      h += ha_primitive_Sigma1_##ws (e) + ha_primitive_ch (e, f, g) + K[t]    \
+           + w[(t) & 15];                                                     \
+      d += h;                                                                 \
+      h += ha_primitive_Sigma0_##ws (a) + ha_primitive_maj (a, b, c);         \
+    }                                                                         \
+  while (0)
+
+#define SHA2_MB_ROUND8(ws, K, t)                                              \
+  SHA2_MB_ROUND (ws, K, a, b, c, d, e, f, g, h, (t) + 0);                     \
+  SHA2_MB_ROUND (ws, K, h, a, b, c, d, e, f, g, (t) + 1);                     \
+  SHA2_MB_ROUND (ws, K, g, h, a, b, c, d, e, f, (t) + 2);                     \
+  SHA2_MB_ROUND (ws, K, f, g, h, a, b, c, d, e, (t) + 3);                     \
+  SHA2_MB_ROUND (ws, K, e, f, g, h, a, b, c, d, (t) + 4);                     \
+  SHA2_MB_ROUND (ws, K, d, e, f, g, h, a, b, c, (t) + 5);                     \
+  SHA2_MB_ROUND (ws, K, c, d, e, f, g, h, a, b, (t) + 6);                     \
+  SHA2_MB_ROUND (ws, K, b, c, d, e, f, g, h, a, (t) + 7);
+
+/* ha_imp_sha2_<bits>_mb_x<lanes>: one block per lane on the transposed
+   state, for the SHA-256 (ws 32) or SHA-512 (ws 64) compression */
+#define SHA2_MB_KERNEL(bits, ws, rounds, lanes, isa)                          \
+  typedef uint##ws##_t sha2_##bits##_v##lanes                                 \
+      __attribute__ ((vector_size (ws / 8 * (lanes))));                       \
+                                                                              \
+  HA_IMP_TARGET (isa)                                                         \
+  void ha_imp_sha2_##bits##_mb_x##lanes (uint##ws##_t *state,                 \
+                                         const uint8_t *const *blocks)        \
+  {                                                                           \
+    sha2_##bits##_v##lanes s[8], w[16], a, b, c, d, e, f, g, h;               \
+    uint##ws##_t m[lanes];                                                    \
+    int t, l;                                                                 \
+                                                                              \
+    for (t = 0; t < 16; ++t)                                                  \
+      {                                                                       \
+        for (l = 0; l < (lanes); ++l)                                         \
+          m[l] = load_be##ws (blocks[l] + ws / 8 * t);                        \
+        memcpy (&w[t], m, sizeof (m));                                        \
+      }                                                                       \
+    memcpy (s, state, sizeof (s));                                            \
+    a = s[0], b = s[1], c = s[2], d = s[3];                                   \
+    e = s[4], f = s[5], g = s[6], h = s[7];                                   \
+                                                                              \
+    for (t = 0; t < (rounds); t += 8)                                         \
+      {                                                                       \
+        SHA2_MB_ROUND8 (ws, HA_SHA2_##bits##_K, t)                            \
+      }                                                                       \
+                                                                              \
+    s[0] += a, s[1] += b, s[2] += c, s[3] += d;                               \
+    s[4] += e, s[5] += f, s[6] += g, s[7] += h;                               \
+    memcpy (state, s, sizeof (s));                                            \
+  }
+
+SHA2_MB_KERNEL (256, 32, 64, 4, "sse2")
+SHA2_MB_KERNEL (256, 32, 64, 8, "avx2")
+SHA2_MB_KERNEL (256, 32, 64, 16, "avx512f")
+SHA2_MB_KERNEL (512, 64, 80, 4, "avx2")
+SHA2_MB_KERNEL (512, 64, 80, 8, "avx512f")
+
+#define SHA2_MB_MAX_LANES 16
+
+struct sha2_mb_lane
+{
+  const uint8_t *data; /* unread full blocks of the message */
+  size_t left;         /* bytes left in data */
+  size_t msg;          /* message index, (size_t)-1 when idle */
+  size_t ntail;        /* padded tail blocks left (set once data < 1 block) */
+  uint64_t bitlen;
+  uint8_t tail[2 * HA_SHA2_512_BLOCK_SIZE];
+};
+
+HA_PRVFUN void
+sha2_mb_lane_load (struct sha2_mb_lane *lane, size_t msg,
+                   const uint8_t *data, size_t len)
+{
+  lane->data = data;
+  lane->left = len;
+  lane->msg = msg;
+  lane->ntail = 0;
+  lane->bitlen = (uint64_t)len * 8;
+}
+
+/* returns the next block of the lane and whether it is its last one; the
+   length field takes the last 1/8 of a block (64 or 128 bits) */
+HA_PRVFUN const uint8_t *
+sha2_mb_lane_next (struct sha2_mb_lane *lane, size_t block_size, int *last)
+{
+  const uint8_t *block;
+
+  *last = 0;
+  if (lane->left >= block_size)
+    {
+      block = lane->data;
+      lane->data += block_size;
+      lane->left -= block_size;
+      return block;
+    }
+
+  if (!lane->ntail)
+    {
+      size_t fill = lane->left;
+      lane->ntail = fill + 1 + block_size / 8 > block_size ? 2 : 1;
+      memset (lane->tail, 0, sizeof (lane->tail));
+      memcpy (lane->tail, lane->data, fill);
+      lane->tail[fill] = 0x80;
+      store_be64 (lane->tail + lane->ntail * block_size - 8, lane->bitlen);
+      lane->left = 0;
+      lane->data = lane->tail;
+    }
+
+  block = lane->data;
+  lane->data += block_size;
+  *last = --lane->ntail == 0;
+  return block;
+}
+
+/* sha2_<bits>_mb_drive: feed n messages through a lanes-wide kernel,
+   refilling each lane with the next message when it finishes */
+#define SHA2_MB_DRIVE(bits, ws)                                               \
+  typedef void (*sha2_##bits##_mb_fn) (uint##ws##_t *state,                   \
+                                       const uint8_t *const *blocks);         \
+                                                                              \
+  static void sha2_##bits##_mb_drive (                                        \
+      sha2_##bits##_mb_fn kernel, int lanes, const uint##ws##_t *iv,          \
+      size_t outlen, const uint8_t *const *bufs, const size_t *lens,          \
+      size_t n, uint8_t *digests)                                             \
+  {                                                                           \
+    static const uint8_t idle_block[HA_SHA2_##bits##_BLOCK_SIZE] = { 0 };     \
+    struct sha2_mb_lane lane[SHA2_MB_MAX_LANES];                              \
+    const uint8_t *blocks[SHA2_MB_MAX_LANES];                                 \
+    uint##ws##_t state[8 * SHA2_MB_MAX_LANES];                                \
+    int last[SHA2_MB_MAX_LANES];                                              \
+    size_t next = 0, active = 0;                                              \
+    int l, i;                                                                 \
+                                                                              \
+    for (l = 0; l < lanes; ++l)                                               \
+      {                                                                       \
+        lane[l].msg = (size_t)-1;                                             \
+        if (next < n)                                                         \
+          {                                                                   \
+            sha2_mb_lane_load (&lane[l], next, bufs[next], lens[next]);       \
+            ++next, ++active;                                                 \
+          }                                                                   \
+        for (i = 0; i < 8; ++i)                                               \
+          state[i * lanes + l] = iv[i];                                       \
+      }                                                                       \
+                                                                              \
+    while (active)                                                            \
+      {                                                                       \
+        for (l = 0; l < lanes; ++l)                                           \
+          {                                                                   \
+            last[l] = 0;                                                      \
+            blocks[l] = lane[l].msg == (size_t)-1                             \
+                            ? idle_block                                      \
+                            : sha2_mb_lane_next (                             \
+                                &lane[l], HA_SHA2_##bits##_BLOCK_SIZE,        \
+                                &last[l]);                                    \
+          }                                                                   \
+                                                                              \
+        kernel (state, blocks);                                               \
+                                                                              \
+        for (l = 0; l < lanes; ++l)                                           \
+          {                                                                   \
+            uint8_t full[8 * ws / 8];                                         \
+                                                                              \
+            if (!last[l])                                                     \
+              continue;                                                       \
+                                                                              \
+            for (i = 0; i < 8; ++i)                                           \
+              store_be##ws (full + ws / 8 * i, state[i * lanes + l]);         \
+            memcpy (digests + lane[l].msg * outlen, full, outlen);            \
+                                                                              \
+            for (i = 0; i < 8; ++i)                                           \
+              state[i * lanes + l] = iv[i];                                   \
+            if (next < n)                                                     \
+              {                                                               \
+                sha2_mb_lane_load (&lane[l], next, bufs[next], lens[next]);   \
+                ++next;                                                       \
+              }                                                               \
+            else                                                              \
+              {                                                               \
+                lane[l].msg = (size_t)-1;                                     \
+                --active;                                                     \
+              }                                                               \
+          }                                                                   \
+      }                                                                       \
+  }
+
+SHA2_MB_DRIVE (256, 32)
+SHA2_MB_DRIVE (512, 64)
+
+int
+ha_imp_sha2_256_hash_many (const uint32_t *iv, size_t outlen,
+                           const uint8_t *const *bufs, const size_t *lens,
+                           size_t n, uint8_t *digests)
+{
+  /* a single message gains nothing from idle lanes, and SHA-NI hashing
+     one message at a time outruns everything narrower than 16 lanes */
+  if (n < 2)
+    return 0;
+
+  if (ha_imp_cpu_has (HA_CPU_AVX512F))
+    sha2_256_mb_drive (ha_imp_sha2_256_mb_x16, 16, iv, outlen, bufs, lens, n,
+                       digests);
+  else if (ha_imp_cpu_has (HA_CPU_SHA | HA_CPU_SSE41))
+    return 0;
+  else if (ha_imp_cpu_has (HA_CPU_AVX2))
+    sha2_256_mb_drive (ha_imp_sha2_256_mb_x8, 8, iv, outlen, bufs, lens, n,
+                       digests);
+  else
+    sha2_256_mb_drive (ha_imp_sha2_256_mb_x4, 4, iv, outlen, bufs, lens, n,
+                       digests);
+  return 1;
+}
+
+int
+ha_imp_sha2_512_hash_many (const uint64_t *iv, size_t outlen,
+                           const uint8_t *const *bufs, const size_t *lens,
+                           size_t n, uint8_t *digests)
+{
+  if (n < 2)
+    return 0;
+
+  if (ha_imp_cpu_has (HA_CPU_AVX512F))
+    sha2_512_mb_drive (ha_imp_sha2_512_mb_x8, 8, iv, outlen, bufs, lens, n,
+                       digests);
+  else if (ha_imp_cpu_has (HA_CPU_AVX2))
+    sha2_512_mb_drive (ha_imp_sha2_512_mb_x4, 4, iv, outlen, bufs, lens, n,
+                       digests);
+  else
+    return 0;
+  return 1;
+}
+
+#endif
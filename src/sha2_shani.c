@@ -0,0 +1,82 @@
+#define HA_BUILD
+
+#include "./sha2.h"
+
+#if defined(HA_IMP_X86_SIMD)
+
+#include <immintrin.h>
+
+/* four rounds on the message quad X0; X0 is first replaced by the next
+   schedule quad when t >= 4 (X1..X3 are the three quads after X0) */
+#define SHANI_QROUND(t, X0, X1, X2, X3)                                       \
+  do                                                                          \
+    {                                                                         \
+      if ((t) < 4)                                                            \
+        X0 = _mm_shuffle_epi8 (                                               \
+            _mm_loadu_si128 ((const __m128i *)(blocks + 16 * (t))), bswap);   \
+      else                                                                    \
+        X0 = _mm_sha256msg2_epu32 (                                           \
+            _mm_add_epi32 (_mm_sha256msg1_epu32 (X0, X1),                     \
+                           _mm_alignr_epi8 (X3, X2, 4)),                      \
+            X3);                                                              \
+      msg = _mm_add_epi32 (                                                   \
+          X0, _mm_loadu_si128 ((const __m128i *)&HA_SHA2_256_K[4 * (t)]));    \
+      cdgh = _mm_sha256rnds2_epu32 (cdgh, abef, msg);                         \
+      msg = _mm_shuffle_epi32 (msg, 0x0e);                                    \
+      abef = _mm_sha256rnds2_epu32 (abef, cdgh, msg);                         \
+    }                                                                         \
+  while (0)
+
+HA_IMP_TARGET ("sha,sse4.1")
+void
+ha_imp_sha2_256_blocks_shani (uint32_t *state, const uint8_t *blocks,
+                              size_t nblocks)
+{
+  const __m128i bswap
+      = _mm_set_epi64x (0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+  __m128i abef, cdgh, abef_save, cdgh_save, tmp, msg;
+  __m128i m0, m1, m2, m3;
+
+  /* state is {a,b,c,d},{e,f,g,h}; the instructions want {a,b,e,f} and
+     {c,d,g,h} with the first word in the high lane */
+  tmp = _mm_shuffle_epi32 (_mm_loadu_si128 ((const __m128i *)&state[0]),
+                           0xb1);
+  cdgh = _mm_shuffle_epi32 (_mm_loadu_si128 ((const __m128i *)&state[4]),
+                            0x1b);
+  abef = _mm_alignr_epi8 (tmp, cdgh, 8);
+  cdgh = _mm_blend_epi16 (cdgh, tmp, 0xf0);
+  m0 = m1 = m2 = m3 = _mm_setzero_si128 ();
+
+  for (; nblocks; --nblocks, blocks += HA_SHA2_256_BLOCK_SIZE)
+    {
+      abef_save = abef;
+      cdgh_save = cdgh;
+
+      SHANI_QROUND (0, m0, m1, m2, m3);
+      SHANI_QROUND (1, m1, m2, m3, m0);
+      SHANI_QROUND (2, m2, m3, m0, m1);
+      SHANI_QROUND (3, m3, m0, m1, m2);
+      SHANI_QROUND (4, m0, m1, m2, m3);
+      SHANI_QROUND (5, m1, m2, m3, m0);
+      SHANI_QROUND (6, m2, m3, m0, m1);
+      SHANI_QROUND (7, m3, m0, m1, m2);
+      SHANI_QROUND (8, m0, m1, m2, m3);
+      SHANI_QROUND (9, m1, m2, m3, m0);
+      SHANI_QROUND (10, m2, m3, m0, m1);
+      SHANI_QROUND (11, m3, m0, m1, m2);
+      SHANI_QROUND (12, m0, m1, m2, m3);
+      SHANI_QROUND (13, m1, m2, m3, m0);
+      SHANI_QROUND (14, m2, m3, m0, m1);
+      SHANI_QROUND (15, m3, m0, m1, m2);
+
+      abef = _mm_add_epi32 (abef, abef_save);
+      cdgh = _mm_add_epi32 (cdgh, cdgh_save);
+    }
+
+  tmp = _mm_shuffle_epi32 (abef, 0x1b);
+  cdgh = _mm_shuffle_epi32 (cdgh, 0xb1);
+  _mm_storeu_si128 ((__m128i *)&state[0], _mm_blend_epi16 (tmp, cdgh, 0xf0));
+  _mm_storeu_si128 ((__m128i *)&state[4], _mm_alignr_epi8 (cdgh, tmp, 8));
+}
+
+#endif
@@ -58,6 +58,19 @@ ha_sha3_256_hash (ha_inbuf_t data, size_t length, ha_digest_t digest)
   ha_imp_keccak_final (&ctx, HA_PB_SHA3, digest, HA_SHA3_256_DIGEST_SIZE);
 }
 
+HA_PUBFUN void
+ha_sha3_256_hash_many (const uint8_t *const *bufs, const size_t *lens,
+                       size_t n, uint8_t *digests)
+{
+  if (ha_imp_keccak_hash_many (HA_PB_SHA3, 24, HA_KECCAK_256_RATE,
+                               HA_SHA3_256_DIGEST_SIZE, bufs, lens, n,
+                               digests))
+    return;
+  for (size_t i = 0; i < n; ++i)
+    ha_sha3_256_hash (bufs[i], lens[i],
+                      digests + i * HA_SHA3_256_DIGEST_SIZE);
+}
+
 HA_PUBFUN void
 ha_sha3_384_init (ha_sha3_context *ctx)
 {
@@ -0,0 +1,71 @@
+#define HA_BUILD
+
+#include "../include/hasha/shake.h"
+
+#include "./keccak.h"
+
+HA_PUBFUN void
+ha_shake128_init (ha_shake128_context *ctx)
+{
+  ha_imp_keccak_init (ctx, HA_SHAKE128_RATE);
+}
+
+HA_PUBFUN void
+ha_shake128_update (ha_shake128_context *ctx, ha_inbuf_t data, size_t length)
+{
+  ha_imp_keccak_update (ctx, data, length);
+}
+
+HA_PUBFUN void
+ha_shake128_final (ha_shake128_context *ctx, ha_digest_t digest,
+                   size_t digestlen)
+{
+  ha_imp_keccak_final (ctx, HA_PB_SHAKE, digest, digestlen);
+}
+
+HA_PUBFUN void
+ha_shake128_squeeze (ha_shake128_context *ctx, ha_digest_t out, size_t length)
+{
+  ha_imp_keccak_squeeze (ctx, out, length);
+}
+
+HA_PUBFUN void
+ha_shake128_hash (ha_inbuf_t data, size_t length, ha_digest_t digest,
+                  size_t digestlen)
+{
+  ha_imp_keccak_hash (HA_PB_SHAKE, data, length, HA_SHAKE128_RATE, digest,
+                      digestlen);
+}
+
+HA_PUBFUN void
+ha_shake256_init (ha_shake256_context *ctx)
+{
+  ha_imp_keccak_init (ctx, HA_SHAKE256_RATE);
+}
+
+HA_PUBFUN void
+ha_shake256_update (ha_shake256_context *ctx, ha_inbuf_t data, size_t length)
+{
+  ha_imp_keccak_update (ctx, data, length);
+}
+
+HA_PUBFUN void
+ha_shake256_final (ha_shake256_context *ctx, ha_digest_t digest,
+                   size_t digestlen)
+{
+  ha_imp_keccak_final (ctx, HA_PB_SHAKE, digest, digestlen);
+}
+
+HA_PUBFUN void
+ha_shake256_squeeze (ha_shake256_context *ctx, ha_digest_t out, size_t length)
+{
+  ha_imp_keccak_squeeze (ctx, out, length);
+}
+
+HA_PUBFUN void
+ha_shake256_hash (ha_inbuf_t data, size_t length, ha_digest_t digest,
+                  size_t digestlen)
+{
+  ha_imp_keccak_hash (HA_PB_SHAKE, data, length, HA_SHAKE256_RATE, digest,
+                      digestlen);
+}
@@ -0,0 +1,77 @@
+#define HA_BUILD
+
+#include "../include/hasha/turboshake.h"
+
+#include "./turboshake.h"
+
+HA_PUBFUN void
+ha_turboshake128_init (ha_turboshake128_context *ctx, uint8_t domain)
+{
+  ha_imp_turboshake_init (&ctx->sponge, HA_SHAKE128_RATE);
+  ctx->domain = domain;
+}
+
+HA_PUBFUN void
+ha_turboshake128_update (ha_turboshake128_context *ctx, ha_inbuf_t data,
+                         size_t length)
+{
+  ha_imp_keccak_update (&ctx->sponge, data, length);
+}
+
+HA_PUBFUN void
+ha_turboshake128_final (ha_turboshake128_context *ctx, ha_digest_t digest,
+                        size_t digestlen)
+{
+  ha_imp_keccak_final (&ctx->sponge, ctx->domain, digest, digestlen);
+}
+
+HA_PUBFUN void
+ha_turboshake128_squeeze (ha_turboshake128_context *ctx, ha_digest_t out,
+                          size_t length)
+{
+  ha_imp_keccak_squeeze (&ctx->sponge, out, length);
+}
+
+HA_PUBFUN void
+ha_turboshake128_hash (ha_inbuf_t data, size_t length, uint8_t domain,
+                       ha_digest_t digest, size_t digestlen)
+{
+  ha_imp_turboshake_hash (domain, data, length, HA_SHAKE128_RATE, digest,
+                          digestlen);
+}
+
+HA_PUBFUN void
+ha_turboshake256_init (ha_turboshake256_context *ctx, uint8_t domain)
+{
+  ha_imp_turboshake_init (&ctx->sponge, HA_SHAKE256_RATE);
+  ctx->domain = domain;
+}
+
+HA_PUBFUN void
+ha_turboshake256_update (ha_turboshake256_context *ctx, ha_inbuf_t data,
+                         size_t length)
+{
+  ha_imp_keccak_update (&ctx->sponge, data, length);
+}
+
+HA_PUBFUN void
+ha_turboshake256_final (ha_turboshake256_context *ctx, ha_digest_t digest,
+                        size_t digestlen)
+{
+  ha_imp_keccak_final (&ctx->sponge, ctx->domain, digest, digestlen);
+}
+
+HA_PUBFUN void
+ha_turboshake256_squeeze (ha_turboshake256_context *ctx, ha_digest_t out,
+                          size_t length)
+{
+  ha_imp_keccak_squeeze (&ctx->sponge, out, length);
+}
+
+HA_PUBFUN void
+ha_turboshake256_hash (ha_inbuf_t data, size_t length, uint8_t domain,
+                       ha_digest_t digest, size_t digestlen)
+{
+  ha_imp_turboshake_hash (domain, data, length, HA_SHAKE256_RATE, digest,
+                          digestlen);
+}
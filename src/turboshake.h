@@ -0,0 +1,28 @@
+#ifndef __hasha_imp_turboshake_h
+#define __hasha_imp_turboshake_h
+
+#include "../include/hasha/turboshake.h"
+#include "./keccak.h"
+
+/* TurboSHAKE is the keccak sponge on the last 12 rounds of keccak-f, with
+   the domain byte D as its padding byte */
+#define HA_IMP_TURBOSHAKE_ROUNDS 12
+
+HA_PRVFUN void
+ha_imp_turboshake_init (ha_keccak_context *sponge, size_t rate)
+{
+  ha_imp_keccak_init (sponge, rate);
+  sponge->rounds = HA_IMP_TURBOSHAKE_ROUNDS;
+}
+
+HA_PRVFUN void
+ha_imp_turboshake_hash (uint8_t domain, const uint8_t *buf, size_t len,
+                        size_t rate, uint8_t *digest, size_t digestlen)
+{
+  ha_keccak_context sponge;
+  ha_imp_turboshake_init (&sponge, rate);
+  ha_imp_keccak_update (&sponge, buf, len);
+  ha_imp_keccak_final (&sponge, domain, digest, digestlen);
+}
+
+#endif
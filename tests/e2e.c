@@ -7,6 +7,7 @@
 
 #include "../include/hasha/hasha.h"
 #include "../include/hasha/internal/error.h"
+#include "../include/hasha/internal/opts.h"
 
 static const char *input = "hello";
 static size_t      input_len;
@@ -37,6 +38,31 @@ void e2e_0()
 
     __fprintf(debug, stdout, "md5:          passed\n");
   }
+  {
+    /* input fed in pieces that straddle block boundaries gives the
+       one-shot digest */
+    static const size_t pieces[] = {1, 7, 63, 64, 65, 200, 600};
+    uint8_t             data[1000], output[HA_MD5_DIGEST_SIZE],
+        pieced[HA_MD5_DIGEST_SIZE];
+    ha_md5_context ctx;
+    size_t         off = 0;
+
+    for (size_t i = 0; i < sizeof(data); ++i) data[i] = (uint8_t)(i * 13);
+    ha_md5_hash(data, sizeof(data), output);
+    ha_md5_init(&ctx);
+    for (size_t i = 0; i < sizeof(pieces) / sizeof(pieces[0]); ++i)
+    {
+      ha_md5_update(&ctx, data + off, pieces[i]);
+      off += pieces[i];
+    }
+    ha_md5_final(&ctx, pieced);
+    assert(off == sizeof(data));
+    assert(memcmp(output, pieced, sizeof(output)) == 0);
+    assert(ha_cmphashstr(output, "2ac2225e3b72b40b6f5904b9c424c2bb",
+                         HA_MD5_DIGEST_SIZE) == 0);
+
+    __fprintf(debug, stdout, "md5-pieces:   passed\n");
+  }
   {
     uint8_t output[HA_SHA1_DIGEST_SIZE];
 
@@ -225,6 +251,146 @@ void e2e_0()
                          HA_KECCAK_512_DIGEST_SIZE) == 0);
     __fprintf(debug, stdout, "keccak-512:   passed\n");
   }
+  {
+    uint8_t output[ha_bB(256)];
+
+    ha_shake128_hash((const uint8_t *)input, input_len, output,
+                     ha_bB(256));
+
+    const char *expected_hash =
+        "8eb4b6a932f280335ee1a279f8c208a349e7bc65daf831d3021c213825292463";
+    assert(ha_cmphashstr(output, expected_hash, ha_bB(256)) == 0);
+    __fprintf(debug, stdout, "shake128-256: passed\n");
+  }
+  {
+    uint8_t output[ha_bB(512)];
+
+    ha_shake256_hash((const uint8_t *)input, input_len, output,
+                     ha_bB(512));
+
+    const char *expected_hash =
+        "1234075ae4a1e77316cf2d8000974581a343b9ebbca7e3d1db83394c30f22162"
+        "6f594e4f0de63902349a5ea5781213215813919f92a4d86d127466e3d07e8be3";
+    assert(ha_cmphashstr(output, expected_hash, ha_bB(512)) == 0);
+    __fprintf(debug, stdout, "shake256-512: passed\n");
+  }
+  {
+    uint8_t output[ha_bB(256)];
+
+    ha_cshake128_hash((const uint8_t *)input, input_len, NULL, 0,
+                      (const uint8_t *)"Email Signature", 15, output,
+                      ha_bB(256));
+
+    const char *expected_hash =
+        "bf4a42ef4e39ce0ae15bfef306434fa244d9fd4a888a21c465d8d18a23b0a7f1";
+    assert(ha_cmphashstr(output, expected_hash, ha_bB(256)) == 0);
+    __fprintf(debug, stdout, "cshake128:    passed\n");
+  }
+  {
+    uint8_t output[ha_bB(512)];
+
+    ha_cshake256_hash((const uint8_t *)input, input_len, NULL, 0,
+                      (const uint8_t *)"Email Signature", 15, output,
+                      ha_bB(512));
+
+    const char *expected_hash =
+        "cd0c55729f89a4c27d1dc4b3d72a3eebc6fd9ddf67f37ef7dddf7273ff2f3e0c"
+        "f5014984c9e689dc53995b8b36c6b6c4b5fdf260f6233dcfed3e16eec5990997";
+    assert(ha_cmphashstr(output, expected_hash, ha_bB(512)) == 0);
+    __fprintf(debug, stdout, "cshake256:    passed\n");
+  }
+  {
+    uint8_t output[ha_bB(256)], key[32];
+
+    for (int i = 0; i < 32; ++i) key[i] = (uint8_t)(0x40 + i);
+    ha_kmac128_hash(key, sizeof(key),
+                    (const uint8_t *)"My Tagged Application", 21,
+                    (const uint8_t *)input, input_len, output, ha_bB(256));
+
+    const char *expected_hash =
+        "a1ede8ef03b3752c68b194188d080f78117cda1a0903185b5dcdf4edbf80e485";
+    assert(ha_cmphashstr(output, expected_hash, ha_bB(256)) == 0);
+    __fprintf(debug, stdout, "kmac128:      passed\n");
+  }
+  {
+    uint8_t output[ha_bB(512)], key[32];
+
+    for (int i = 0; i < 32; ++i) key[i] = (uint8_t)(0x40 + i);
+    ha_kmac256_hash(key, sizeof(key), NULL, 0, (const uint8_t *)input,
+                    input_len, output, ha_bB(512));
+
+    const char *expected_hash =
+        "c85468901fdbd76c10486c54e47c5e9a7ec947b052d67e924b4d722ed218a4b3"
+        "f5587b0e12bb2b08d16120a118ed1b2db49447efb74c450412819b1c3e90e00a";
+    assert(ha_cmphashstr(output, expected_hash, ha_bB(512)) == 0);
+    __fprintf(debug, stdout, "kmac256:      passed\n");
+  }
+  {
+    uint8_t              output[ha_bB(256)];
+    static const uint8_t a[] = {0x00, 0x01, 0x02},
+                         b[] = {0x10, 0x11, 0x12, 0x13, 0x14, 0x15};
+    const uint8_t       *items[] = {a, b};
+    const size_t         lens[] = {sizeof(a), sizeof(b)};
+
+    ha_tuplehash128_hash(items, lens, 2, NULL, 0, output, ha_bB(256));
+
+    const char *expected_hash =
+        "c5d8786c1afb9b82111ab34b65b2c0048fa64e6d48e263264ce1707d3ffc8ed1";
+    assert(ha_cmphashstr(output, expected_hash, ha_bB(256)) == 0);
+    __fprintf(debug, stdout, "tuplehash128: passed\n");
+  }
+  {
+    uint8_t output[ha_bB(256)], data[24];
+
+    for (int i = 0; i < 24; ++i) data[i] = (uint8_t)((i / 8) * 16 + i % 8);
+    ha_parallelhash128_hash(data, sizeof(data), 8, NULL, 0, NULL, output,
+                            ha_bB(256));
+
+    const char *expected_hash =
+        "ba8dc1d1d979331d3f813603c67f72609ab5e44b94a0b8f9af46514454a2b4f5";
+    assert(ha_cmphashstr(output, expected_hash, ha_bB(256)) == 0);
+    __fprintf(debug, stdout, "parallelhash128: passed\n");
+  }
+  {
+    uint8_t output[ha_bB(256)];
+
+    ha_turboshake128_hash(NULL, 0, HA_TURBOSHAKE_DOMAIN, output,
+                          ha_bB(256));
+
+    const char *expected_hash =
+        "1e415f1c5983aff2169217277d17bb538cd945a397ddec541f1ce41af2c1b74c";
+    assert(ha_cmphashstr(output, expected_hash, ha_bB(256)) == 0);
+    __fprintf(debug, stdout, "turboshake128: passed\n");
+  }
+  {
+    uint8_t output[ha_bB(512)];
+
+    ha_turboshake256_hash(NULL, 0, HA_TURBOSHAKE_DOMAIN, output,
+                          ha_bB(512));
+
+    const char *expected_hash =
+        "367a329dafea871c7802ec67f905ae13c57695dc2c6663c61035f59a18f8e7db"
+        "11edc0e12e91ea60eb6b32df06dd7f002fbafabb6e13ec1cc20d995547600db0";
+    assert(ha_cmphashstr(output, expected_hash, ha_bB(512)) == 0);
+    __fprintf(debug, stdout, "turboshake256: passed\n");
+  }
+  {
+    uint8_t output[HA_K12_DIGEST_SIZE];
+
+    ha_k12_hash(NULL, 0, NULL, 0, NULL, output, sizeof(output));
+    assert(ha_cmphashstr(output,
+                         "1ac2d450fc3b4205d19da7bfca1b37513c0803577ac7167f"
+                         "06fe2ce1f0ef39e5",
+                         sizeof(output)) == 0);
+
+    ha_k12_hash((const uint8_t *)input, input_len,
+                (const uint8_t *)"app", 3, NULL, output, sizeof(output));
+    assert(ha_cmphashstr(output,
+                         "f520f9a1eb440ea5f391bc9c62e5d4911a6fb62da09c97fa"
+                         "c441b4e25bf1f405",
+                         sizeof(output)) == 0);
+    __fprintf(debug, stdout, "k12:          passed\n");
+  }
   {
     uint8_t output[ha_bB(128)];
 
@@ -296,6 +462,31 @@ void e2e_0()
            0);
     __fprintf(debug, stdout, "blake2b-512:  passed\n");
   }
+  {
+    uint8_t output[HA_BLAKE2BP_DIGEST_SIZE];
+
+    ha_blake2bp_hash((const uint8_t *)input, input_len, output,
+                     HA_BLAKE2BP_DIGEST_SIZE);
+
+    const char *expected_hash =
+        "3d9b524855d3675f3ccbe8e189b3f00a2712ba7301f9b88a7e31aad491677745"
+        "9953a70f9c98869bc39872591c30e6dfa5b5decbfcf977c909db9f9f7e4441d1";
+    assert(ha_cmphashstr(output, expected_hash, HA_BLAKE2BP_DIGEST_SIZE) ==
+           0);
+    __fprintf(debug, stdout, "blake2bp-512: passed\n");
+  }
+  {
+    uint8_t output[HA_BLAKE2SP_DIGEST_SIZE];
+
+    ha_blake2sp_hash((const uint8_t *)input, input_len, output,
+                     HA_BLAKE2SP_DIGEST_SIZE);
+
+    const char *expected_hash =
+        "223dfe42565ddf97210b34a384860b603717d5c63c1872c9fc99f1b15de6631b";
+    assert(ha_cmphashstr(output, expected_hash, HA_BLAKE2SP_DIGEST_SIZE) ==
+           0);
+    __fprintf(debug, stdout, "blake2sp-256: passed\n");
+  }
   {
     uint8_t output[ha_bB(224)];
 
@@ -540,6 +731,30 @@ void e2e_1()
     }
   }
 
+  {
+    {
+      ha_evp_hasher_init(hasher, HA_EVPTY_SHAKE, ha_bB(512));
+      ha_evp_hash(hasher, (ha_inbuf_t)input, input_len, digest);
+      const char *expected_hash =
+          "1234075ae4a1e77316cf2d8000974581a343b9ebbca7e3d1db83394c30f22162"
+          "6f594e4f0de63902349a5ea5781213215813919f92a4d86d127466e3d07e8be3";
+      assert(ha_cmphashstr(digest, expected_hash, ha_bB(512)) == 0);
+      __fprintf(debug, stdout, "shake256-512: passed\n");
+      ha_evp_hasher_cleanup(hasher);
+    }
+    {
+      ha_evp_hasher_set_keccak_rate(hasher, HA_SHAKE128_RATE);
+      ha_evp_hasher_init(hasher, HA_EVPTY_SHAKE, ha_bB(256));
+      ha_evp_hash(hasher, (ha_inbuf_t)input, input_len, digest);
+      const char *expected_hash =
+          "8eb4b6a932f280335ee1a279f8c208a349e7bc65daf831d3021c213825292463";
+      assert(ha_cmphashstr(digest, expected_hash, ha_bB(256)) == 0);
+      __fprintf(debug, stdout, "shake128-256: passed\n");
+      ha_evp_hasher_cleanup(hasher);
+      ha_evp_hasher_set_keccak_rate(hasher, 0);
+    }
+  }
+
   {
     {
       ha_evp_hasher_init(hasher, HA_EVPTY_BLAKE2S, ha_bB(128));
@@ -617,6 +832,31 @@ void e2e_1()
     }
   }
 
+  {
+    {
+      ha_evp_hasher_init(hasher, HA_EVPTY_BLAKE2BP, ha_bB(512));
+      ha_evp_hash(hasher, (ha_inbuf_t)input, input_len, digest);
+      const char *expected_hash =
+          "3d9b524855d3675f3ccbe8e189b3f00a2712ba7301f9b88a7e31aad49167774"
+          "59953a70f9c98869bc39872591c30e6dfa5b5decbfcf977c909db9f9f7e4441d"
+          "1";
+      assert(ha_cmphashstr(digest, expected_hash, ha_bB(512)) == 0);
+      __fprintf(debug, stdout, "blake2bp-512: passed\n");
+      ha_evp_hasher_cleanup(hasher);
+    }
+
+    {
+      ha_evp_hasher_init(hasher, HA_EVPTY_BLAKE2SP, ha_bB(256));
+      ha_evp_hash(hasher, (ha_inbuf_t)input, input_len, digest);
+      const char *expected_hash =
+          "223dfe42565ddf97210b34a384860b603717d5c63c1872c9fc99f1b15de6631"
+          "b";
+      assert(ha_cmphashstr(digest, expected_hash, ha_bB(256)) == 0);
+      __fprintf(debug, stdout, "blake2sp-256: passed\n");
+      ha_evp_hasher_cleanup(hasher);
+    }
+  }
+
   {
     {
       ha_evp_hasher_init(hasher, HA_EVPTY_BLAKE3, ha_bB(224));
@@ -877,6 +1117,23 @@ void e2e_2()
     }
   }
 
+  {
+    {
+      ha_evp_hasher_init(hasher, HA_EVPTY_SHAKE, ha_bB(256));
+      ha_evp_init(hasher);
+      ha_evp_update(hasher, (ha_inbuf_t)input, input_len);
+      /* the first 16 bytes from final, the rest from squeeze */
+      ha_evp_hasher_set_digestlen(hasher, ha_bB(128));
+      ha_evp_final(hasher, digest);
+      ha_evp_squeeze(hasher, digest + ha_bB(128), ha_bB(128));
+      const char *expected_hash =
+          "1234075ae4a1e77316cf2d8000974581a343b9ebbca7e3d1db83394c30f22162";
+      assert(ha_cmphashstr(digest, expected_hash, ha_bB(256)) == 0);
+      __fprintf(debug, stdout, "shake256-256: passed\n");
+      ha_evp_hasher_cleanup(hasher);
+    }
+  }
+
   {
     {
       ha_evp_hasher_init(hasher, HA_EVPTY_BLAKE2S, ha_bB(128));
@@ -954,6 +1211,31 @@ void e2e_2()
     }
   }
 
+  {
+    {
+      ha_evp_hasher_init(hasher, HA_EVPTY_BLAKE2BP, ha_bB(512));
+      ha_evp_digest(hasher, (ha_inbuf_t)input, input_len, digest);
+      const char *expected_hash =
+          "3d9b524855d3675f3ccbe8e189b3f00a2712ba7301f9b88a7e31aad49167774"
+          "59953a70f9c98869bc39872591c30e6dfa5b5decbfcf977c909db9f9f7e4441d"
+          "1";
+      assert(ha_cmphashstr(digest, expected_hash, ha_bB(512)) == 0);
+      __fprintf(debug, stdout, "blake2bp-512: passed\n");
+      ha_evp_hasher_cleanup(hasher);
+    }
+
+    {
+      ha_evp_hasher_init(hasher, HA_EVPTY_BLAKE2SP, ha_bB(256));
+      ha_evp_digest(hasher, (ha_inbuf_t)input, input_len, digest);
+      const char *expected_hash =
+          "223dfe42565ddf97210b34a384860b603717d5c63c1872c9fc99f1b15de6631"
+          "b";
+      assert(ha_cmphashstr(digest, expected_hash, ha_bB(256)) == 0);
+      __fprintf(debug, stdout, "blake2sp-256: passed\n");
+      ha_evp_hasher_cleanup(hasher);
+    }
+  }
+
   {
     {
       ha_evp_hasher_init(hasher, HA_EVPTY_BLAKE3, ha_bB(224));
@@ -1027,6 +1309,882 @@ void e2e_2()
   return;
 }
 
+void e2e_3()
+{
+  static const char *abc448 =
+      "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq";
+  size_t  abc448_len = strlen(abc448);
+  uint8_t a1000[1000];
+  memset(a1000, 'a', sizeof(a1000));
+
+  {
+    uint8_t output[HA_SHA2_224_DIGEST_SIZE];
+
+    ha_sha2_224_hash((const uint8_t *)abc448, abc448_len, output);
+    assert(ha_cmphashstr(
+               output,
+               "75388b16512776cc5dba5da1fd890150b0c6455cb4f58b1952522525",
+               HA_SHA2_224_DIGEST_SIZE) == 0);
+
+    ha_sha2_224_hash(a1000, sizeof(a1000), output);
+    assert(ha_cmphashstr(
+               output,
+               "4e8f0ce90b64661a2b5e84be6d93a7d9b76871062f1814433d04a03d",
+               HA_SHA2_224_DIGEST_SIZE) == 0);
+    __fprintf(debug, stdout, "sha2-224:     passed\n");
+  }
+  {
+    uint8_t output[HA_SHA2_256_DIGEST_SIZE];
+
+    ha_sha2_256_hash((const uint8_t *)abc448, abc448_len, output);
+    assert(ha_cmphashstr(output,
+                         "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167"
+                         "f6ecedd419db06c1",
+                         HA_SHA2_256_DIGEST_SIZE) == 0);
+
+    ha_sha2_256_context ctx;
+    ha_sha2_256_init(&ctx);
+    for (size_t i = 0; i < sizeof(a1000); i += 100)
+      ha_sha2_256_update(&ctx, a1000 + i, 100);
+    ha_sha2_256_final(&ctx, output);
+    assert(ha_cmphashstr(output,
+                         "41edece42d63e8d9bf515a9ba6932e1c20cbc9f5a5d13464"
+                         "5adb5db1b9737ea3",
+                         HA_SHA2_256_DIGEST_SIZE) == 0);
+    __fprintf(debug, stdout, "sha2-256:     passed\n");
+  }
+  {
+    static const char *abc896 =
+        "abcdefghbcdefghicdefghijdefghijkefghijklfghijklmghijklmn"
+        "hijklmnoijklmnopjklmnopqklmnopqrlmnopqrsmnopqrstnopqrstu";
+    uint8_t output[HA_SHA2_512_DIGEST_SIZE];
+
+    ha_sha2_384_hash((const uint8_t *)abc896, strlen(abc896), output);
+    assert(ha_cmphashstr(output,
+                         "09330c33f71147e83d192fc782cd1b4753111b173b3b05d2"
+                         "2fa08086e3b0f712fcc7c71a557e2db966c3e9fa91746039",
+                         HA_SHA2_384_DIGEST_SIZE) == 0);
+    __fprintf(debug, stdout, "sha2-384:     passed\n");
+
+    ha_sha2_512_hash((const uint8_t *)abc896, strlen(abc896), output);
+    assert(ha_cmphashstr(output,
+                         "8e959b75dae313da8cf4f72814fc143f8f7779c6eb9f7fa1"
+                         "7299aeadb6889018501d289e4900f7e4331b99dec4b5433a"
+                         "c7d329eeb6dd26545e96e55b874be909",
+                         HA_SHA2_512_DIGEST_SIZE) == 0);
+
+    /* ragged head, whole blocks and tail in one update */
+    ha_sha2_512_context ctx;
+    ha_sha2_512_init(&ctx);
+    ha_sha2_512_update(&ctx, a1000, 7);
+    ha_sha2_512_update(&ctx, a1000 + 7, 900);
+    ha_sha2_512_update(&ctx, a1000 + 907, 93);
+    ha_sha2_512_final(&ctx, output);
+    assert(ha_cmphashstr(output,
+                         "67ba5535a46e3f86dbfbed8cbbaf0125c76ed549ff8b0b9e"
+                         "03e0c88cf90fa634fa7b12b47d77b694de488ace8d9a6596"
+                         "7dc96df599727d3292a8d9d447709c97",
+                         HA_SHA2_512_DIGEST_SIZE) == 0);
+    __fprintf(debug, stdout, "sha2-512:     passed\n");
+  }
+  {
+    /* output read in pieces across rate boundaries equals the one-shot
+       output */
+    static const size_t pieces[] = {0, 1, 7, 160, 168, 169, 500, 1};
+    uint8_t             whole[1006], pieced[1006];
+    size_t              off = 0;
+    ha_shake128_context ctx;
+
+    ha_shake128_hash((const uint8_t *)input, input_len, whole,
+                     sizeof(whole));
+    ha_shake128_init(&ctx);
+    ha_shake128_update(&ctx, (const uint8_t *)input, input_len);
+    ha_shake128_final(&ctx, pieced, pieces[0]);
+    for (size_t i = 1; i < sizeof(pieces) / sizeof(pieces[0]); ++i)
+    {
+      ha_shake128_squeeze(&ctx, pieced + off, pieces[i]);
+      off += pieces[i];
+    }
+    assert(off == sizeof(whole));
+    assert(memcmp(whole, pieced, sizeof(whole)) == 0);
+    __fprintf(debug, stdout, "shake128:     passed\n");
+  }
+  {
+    /* a reset KMAC context starts from the keyed prefix again */
+    uint8_t             key[200], mac[ha_bB(256)], expected[ha_bB(256)];
+    ha_kmac128_context  ctx;
+
+    for (size_t i = 0; i < sizeof(key); ++i) key[i] = (uint8_t)i;
+    ha_kmac128_hash(key, sizeof(key), NULL, 0, (const uint8_t *)input,
+                    input_len, expected, sizeof(expected));
+    ha_kmac128_init(&ctx, key, sizeof(key), NULL, 0);
+    for (int round = 0; round < 2; ++round)
+    {
+      ha_cshake128_reset(&ctx);
+      ha_kmac128_update(&ctx, (const uint8_t *)input, 2);
+      ha_kmac128_update(&ctx, (const uint8_t *)input + 2, input_len - 2);
+      ha_kmac128_final(&ctx, mac, sizeof(mac));
+      assert(memcmp(mac, expected, sizeof(mac)) == 0);
+    }
+    __fprintf(debug, stdout, "kmac128:      passed\n");
+  }
+  {
+    /* blocks hashed on a pool, fed in uneven pieces, give the serial
+       digest */
+    enum
+    {
+      LEN = 300001
+    };
+    static uint8_t             data[LEN];
+    uint8_t                    serial[64], pooled[64];
+    ha_parallelhash256_context ctx;
+    ha_pool                   *pool = ha_pool_create(3);
+
+    for (size_t i = 0; i < LEN; ++i) data[i] = (uint8_t)(i * 31);
+    ha_parallelhash256_hash(data, LEN, 1000, (const uint8_t *)"S", 1, NULL,
+                            serial, sizeof(serial));
+    ha_parallelhash256_init(&ctx, 1000, (const uint8_t *)"S", 1, pool);
+    for (size_t off = 0, piece = 1; off < LEN; piece = piece * 7 % 65537)
+    {
+      size_t n = piece < LEN - off ? piece : LEN - off;
+      ha_parallelhash256_update(&ctx, data + off, n);
+      off += n;
+    }
+    ha_parallelhash256_final(&ctx, pooled, sizeof(pooled));
+    ha_pool_destroy(pool);
+    assert(memcmp(serial, pooled, sizeof(serial)) == 0);
+    __fprintf(debug, stdout, "parallelhash256: passed\n");
+  }
+  {
+    /* five chunks, hashed on a pool and fed in pieces that straddle the
+       chunk boundaries */
+    enum
+    {
+      LEN = 40000
+    };
+    static uint8_t data[LEN];
+    static const size_t pieces[] = {1, 8190, 2, 9000, 16384, 6423};
+    uint8_t        output[HA_K12_DIGEST_SIZE];
+    ha_k12_context ctx;
+    ha_pool       *pool = ha_pool_create(2);
+    size_t         off = 0;
+
+    for (size_t i = 0; i < LEN; ++i) data[i] = (uint8_t)(i % 251);
+    ha_k12_init(&ctx, pool);
+    for (size_t i = 0; i < sizeof(pieces) / sizeof(pieces[0]); ++i)
+    {
+      ha_k12_update(&ctx, data + off, pieces[i]);
+      off += pieces[i];
+    }
+    assert(off == LEN);
+    ha_k12_final(&ctx, NULL, 0, output, sizeof(output));
+    ha_pool_destroy(pool);
+    assert(ha_cmphashstr(output,
+                         "535a38f6fe5da7c5daa7895df4c71020b1064a66cef7bc3d"
+                         "d3ab7ba6872dbc10",
+                         sizeof(output)) == 0);
+    __fprintf(debug, stdout, "k12:          passed\n");
+  }
+  {
+    /* forty chunks fed in pieces that split blocks and chunks, so that
+       runs of whole chunks go through the SIMD lanes between them */
+    enum
+    {
+      LEN = 40000
+    };
+    static uint8_t data[LEN];
+    static const size_t pieces[] = {1, 1023, 5000, 17000, 64, 16912};
+    uint8_t           output[32];
+    ha_blake3_context ctx;
+    size_t            off = 0;
+
+    for (size_t i = 0; i < LEN; ++i) data[i] = (uint8_t)(i % 251);
+    ha_blake3_init(&ctx);
+    for (size_t i = 0; i < sizeof(pieces) / sizeof(pieces[0]); ++i)
+    {
+      ha_blake3_update(&ctx, data + off, pieces[i]);
+      off += pieces[i];
+    }
+    assert(off == LEN);
+    ha_blake3_final(&ctx, output, sizeof(output));
+    assert(ha_cmphashstr(output,
+                         "ccd32b4544a24c50fbefb249e10a8fcedc26e2794c79eb8a"
+                         "44ad0631bf07f53f",
+                         sizeof(output)) == 0);
+    __fprintf(debug, stdout, "blake3:       passed\n");
+  }
+  {
+    /* pieces that split blocks and strides, around runs of strides
+       compressed straight from the input */
+    enum
+    {
+      LEN = 40000
+    };
+    static uint8_t data[LEN];
+    static const size_t pieces[] = {1, 1023, 5000, 17000, 64, 16912};
+    uint8_t             output[HA_BLAKE2BP_DIGEST_SIZE];
+    ha_blake2bp_context bctx;
+    ha_blake2sp_context sctx;
+    size_t              off = 0;
+
+    for (size_t i = 0; i < LEN; ++i) data[i] = (uint8_t)(i % 251);
+    ha_blake2bp_init(&bctx, HA_BLAKE2BP_DIGEST_SIZE);
+    ha_blake2sp_init(&sctx, HA_BLAKE2SP_DIGEST_SIZE);
+    for (size_t i = 0; i < sizeof(pieces) / sizeof(pieces[0]); ++i)
+    {
+      ha_blake2bp_update(&bctx, data + off, pieces[i]);
+      ha_blake2sp_update(&sctx, data + off, pieces[i]);
+      off += pieces[i];
+    }
+    assert(off == LEN);
+    ha_blake2bp_final(&bctx, output);
+    assert(ha_cmphashstr(output,
+                         "8bc3f408faa13194244e8e86954660a41282f779753f16f0"
+                         "2cd9e5e9c0ca774fbdcf3201a0d3fcd11746f1f0cda7b78b"
+                         "5e00fa7d592eae2c77a8b7b6ce51604a",
+                         HA_BLAKE2BP_DIGEST_SIZE) == 0);
+    __fprintf(debug, stdout, "blake2bp:     passed\n");
+    ha_blake2sp_final(&sctx, output);
+    assert(ha_cmphashstr(output,
+                         "a9c0f8b75744e19743e42c64d5cd1abdf1a9b75ef93c92cd"
+                         "51b8c4bd9af7175f",
+                         HA_BLAKE2SP_DIGEST_SIZE) == 0);
+    __fprintf(debug, stdout, "blake2sp:     passed\n");
+
+    /* a digest length past the root's chaining value, or 0, is an error
+       and writes no digest */
+    g_ha_opts.noabort = 1;
+    memset(output, 0xee, sizeof(output));
+    ha_blake2bp_hash(data, LEN, output, HA_BLAKE2BP_DIGEST_SIZE + 1);
+    ha_blake2bp_hash(data, LEN, output, 0);
+    ha_blake2sp_hash(data, LEN, output, HA_BLAKE2SP_DIGEST_SIZE + 1);
+    ha_blake2sp_hash(data, LEN, output, 0);
+    for (size_t i = 0; i < sizeof(output); ++i) assert(output[i] == 0xee);
+    g_ha_opts.noabort = 0;
+    __fprintf(debug, stdout, "blake2p-lengths: passed\n");
+  }
+  {
+    /* subtrees hashed on a pool, after a head that leaves the context
+       inside a chunk, give the serial digest */
+    enum
+    {
+      LEN = 700001
+    };
+    static uint8_t    data[LEN];
+    uint8_t           serial[40], pooled[40];
+    ha_blake3_context ctx;
+    ha_pool          *pool = ha_pool_create(3);
+
+    for (size_t i = 0; i < LEN; ++i) data[i] = (uint8_t)(i * 31);
+    ha_blake3_hash(data, LEN, serial, sizeof(serial));
+    ha_blake3_init(&ctx);
+    ha_blake3_update(&ctx, data, 5000);
+    ha_blake3_update_parallel(&ctx, data + 5000, LEN - 5000, pool);
+    ha_blake3_final(&ctx, pooled, sizeof(pooled));
+    ha_pool_destroy(pool);
+    assert(memcmp(serial, pooled, sizeof(serial)) == 0);
+    __fprintf(debug, stdout, "blake3-parallel: passed\n");
+  }
+  {
+    static const char *context =
+        "BLAKE3 2019-12-27 16:29:52 test vectors context";
+    uint8_t           key[HA_BLAKE3_KEY_SIZE], data[3000], output[32];
+    ha_blake3_context ctx;
+
+    for (size_t i = 0; i < sizeof(key); ++i) key[i] = (uint8_t)i;
+    for (size_t i = 0; i < sizeof(data); ++i) data[i] = (uint8_t)(i % 251);
+
+    ha_blake3_keyed_hash(key, data, sizeof(data), output, sizeof(output));
+    assert(ha_cmphashstr(output,
+                         "08d00236784eddb9c4739ea275858ea70518492523ec4e6b"
+                         "86ea75d6ea47f878",
+                         sizeof(output)) == 0);
+    ha_blake3_init_keyed(&ctx, key);
+    ha_blake3_final(&ctx, output, sizeof(output));
+    assert(ha_cmphashstr(output,
+                         "73492b19995d71cdb1e9d74decc09809eb732f1b00bc95c2"
+                         "7cb15f9dd4d6478f",
+                         sizeof(output)) == 0);
+    __fprintf(debug, stdout, "blake3-keyed: passed\n");
+
+    /* one context string, several derivations through reset */
+    ha_blake3_init_derive_key(&ctx, context);
+    ha_blake3_update(&ctx, data, sizeof(data));
+    ha_blake3_final(&ctx, output, sizeof(output));
+    assert(ha_cmphashstr(output,
+                         "844b8ed1a526c0e973c8e0eedb3d85014e6166ac41fa2b8b"
+                         "9d4daf0f3eed6f38",
+                         sizeof(output)) == 0);
+    ha_blake3_reset(&ctx);
+    ha_blake3_update(&ctx, (const uint8_t *)"tenant-1", 8);
+    ha_blake3_final(&ctx, output, sizeof(output));
+    assert(ha_cmphashstr(output,
+                         "cce60960b94b01ffbcb0a56f858d750054e23df72ec0c629"
+                         "286d3d39ab056e29",
+                         sizeof(output)) == 0);
+    ha_blake3_reset(&ctx);
+    ha_blake3_update(&ctx, (const uint8_t *)"tenant-2", 8);
+    ha_blake3_final(&ctx, output, sizeof(output));
+    assert(ha_cmphashstr(output,
+                         "b512af6b32cbcd10fba94b6d33f8742327f6afc553d00a38"
+                         "6166b238ea58b123",
+                         sizeof(output)) == 0);
+    __fprintf(debug, stdout, "blake3-derive-key: passed\n");
+  }
+  {
+    uint8_t             key[HA_BLAKE2B_KEY_SIZE], data[1000], output[64];
+    uint8_t             long_key[256];
+    ha_blake2b_param    bparam;
+    ha_blake2s_param    sparam;
+    ha_blake2b_context  bctx;
+    ha_blake2s_context  sctx;
+    ha_blake2b_midstate bms;
+    ha_blake2s_midstate sms;
+    ha_evp_phasher_t    hasher = ha_evp_hasher_new();
+
+    for (size_t i = 0; i < sizeof(key); ++i) key[i] = (uint8_t)i;
+    for (size_t i = 0; i < sizeof(data); ++i) data[i] = (uint8_t)(i % 251);
+
+    ha_blake2b_hash(data, sizeof(data), output, 32);
+    assert(ha_cmphashstr(output,
+                         "b372d0608f720c8c3dd41e9c8eecb10143b41abe520b6166"
+                         "07e754bf79c08331",
+                         32) == 0);
+    ha_blake2b_keyed_hash(key, 64, data, sizeof(data), output, 64);
+    assert(ha_cmphashstr(output,
+                         "715377e0611515b904d259ce52fc8e5d2c50468b1680b298"
+                         "4786b6949cc571f453d28cfb6969cb523ec84e06bf2a4465"
+                         "f3f37511db7792228d038942935750c1",
+                         64) == 0);
+    ha_blake2s_keyed_hash(key, 32, data, sizeof(data), output, 32);
+    assert(ha_cmphashstr(output,
+                         "d5c42863172fb2424de520ff25866bf2ac9201ce81b6a8b7"
+                         "03f67ea4c6735767",
+                         32) == 0);
+    __fprintf(debug, stdout, "blake2-keyed: passed\n");
+
+    ha_blake2b_param_init(&bparam, 48);
+    bparam.key_length = 5;
+    memcpy(bparam.salt, "saltsaltsaltsalt", HA_BLAKE2B_SALT_SIZE);
+    memcpy(bparam.personal, "personal-string!", HA_BLAKE2B_PERSONAL_SIZE);
+    ha_blake2b_init_param(&bctx, &bparam, key);
+    ha_blake2b_update(&bctx, data, sizeof(data));
+    ha_blake2b_final(&bctx, output, 48);
+    assert(ha_cmphashstr(output,
+                         "0977d4f98b39b837cea71cb95be0e38c879c78f76d9cf589"
+                         "d5657d667839eed47e0af139a4a607ec7a916e2c1eb958cb",
+                         48) == 0);
+    ha_blake2s_param_init(&sparam, 28);
+    memcpy(sparam.salt, "saltsalt", HA_BLAKE2S_SALT_SIZE);
+    memcpy(sparam.personal, "personal", HA_BLAKE2S_PERSONAL_SIZE);
+    ha_blake2s_init_param(&sctx, &sparam, NULL);
+    ha_blake2s_update(&sctx, data, sizeof(data));
+    ha_blake2s_final(&sctx, output, 28);
+    assert(ha_cmphashstr(output,
+                         "714513f276484c66e3b3cad07704614fd58a674b9885da0d"
+                         "6cd9322c",
+                         28) == 0);
+    __fprintf(debug, stdout, "blake2-param: passed\n");
+
+    /* one key block compression, then several messages from it,
+       including the empty one, which ends with the key block */
+    ha_blake2b_init_keyed(&bctx, key, 64, 64);
+    ha_blake2b_save_midstate(&bctx, &bms);
+    ha_blake2b_init_midstate(&bctx, &bms);
+    ha_blake2b_update(&bctx, (const uint8_t *)"tenant-1", 8);
+    ha_blake2b_final(&bctx, output, 64);
+    assert(ha_cmphashstr(output,
+                         "f01b6f7718b11cea72e87a1575911a2ea3e6a77385c96897"
+                         "826d9b062f31aa2bd458b8e837e121b2488dd90b362a5bf5"
+                         "edd1c752ef5468fad547885f6371bd21",
+                         64) == 0);
+    ha_blake2b_init_midstate(&bctx, &bms);
+    ha_blake2b_final(&bctx, output, 64);
+    assert(ha_cmphashstr(output,
+                         "10ebb67700b1868efb4417987acf4690ae9d972fb7a590c2"
+                         "f02871799aaa4786b5e996e8f0f4eb981fc214b005f42d2f"
+                         "f4233499391653df7aefcbc13fc51568",
+                         64) == 0);
+    ha_blake2s_init_keyed(&sctx, key, 32, 32);
+    ha_blake2s_save_midstate(&sctx, &sms);
+    ha_blake2s_init_midstate(&sctx, &sms);
+    ha_blake2s_update(&sctx, (const uint8_t *)"tenant-1", 8);
+    ha_blake2s_final(&sctx, output, 32);
+    assert(ha_cmphashstr(output,
+                         "365368ff42cc36fe8429adde0d0cf07ef6984333a6355cba"
+                         "776631d4415982c1",
+                         32) == 0);
+    __fprintf(debug, stdout, "blake2-midstate: passed\n");
+
+    /* lengths the parameter block cannot hold, and a digest length that
+       changed after a compression, are errors that write no digest */
+    g_ha_opts.noabort = 1;
+    memset(long_key, 0x5a, sizeof(long_key));
+    memset(output, 0xee, sizeof(output));
+    ha_blake2b_keyed_hash(long_key, 65, data, sizeof(data), output, 64);
+    ha_blake2b_keyed_hash(long_key, 256, data, sizeof(data), output, 64);
+    ha_blake2b_hash(data, sizeof(data), output, 0);
+    ha_blake2b_hash(data, sizeof(data), output, 65);
+    ha_blake2b_init_keyed(&bctx, long_key, 256, 64);
+    ha_blake2b_update(&bctx, data, sizeof(data));
+    ha_blake2b_final(&bctx, output, 64);
+    ha_blake2b_init_midstate(&bctx, &bms);
+    ha_blake2b_final(&bctx, output, 32);
+    ha_blake2b_init_keyed(&bctx, NULL, 0, 64);
+    ha_blake2b_update(&bctx, data, sizeof(data));
+    ha_blake2b_final(&bctx, output, 32);
+    ha_blake2s_keyed_hash(long_key, 33, data, sizeof(data), output, 32);
+    ha_blake2s_keyed_hash(long_key, 256, data, sizeof(data), output, 32);
+    ha_blake2s_hash(data, sizeof(data), output, 33);
+    ha_blake2s_init_midstate(&sctx, &sms);
+    ha_blake2s_final(&sctx, output, 16);
+    ha_blake2s_init_keyed(&sctx, NULL, 0, 32);
+    ha_blake2s_update(&sctx, data, sizeof(data));
+    ha_blake2s_final(&sctx, output, 16);
+    for (size_t i = 0; i < sizeof(output); ++i) assert(output[i] == 0xee);
+    g_ha_opts.noabort = 0;
+    __fprintf(debug, stdout, "blake2-lengths: passed\n");
+
+    ha_evp_hasher_set_key(hasher, key, 64);
+    ha_evp_hasher_init(hasher, HA_EVPTY_BLAKE2B, ha_bB(512));
+    ha_evp_digest(hasher, data, sizeof(data), output);
+    assert(ha_cmphashstr(output,
+                         "715377e0611515b904d259ce52fc8e5d2c50468b1680b298"
+                         "4786b6949cc571f453d28cfb6969cb523ec84e06bf2a4465"
+                         "f3f37511db7792228d038942935750c1",
+                         64) == 0);
+    ha_evp_hash(hasher, (const uint8_t *)"tenant-1", 8, output);
+    assert(ha_cmphashstr(output,
+                         "f01b6f7718b11cea72e87a1575911a2ea3e6a77385c96897"
+                         "826d9b062f31aa2bd458b8e837e121b2488dd90b362a5bf5"
+                         "edd1c752ef5468fad547885f6371bd21",
+                         64) == 0);
+    ha_evp_hasher_cleanup(hasher);
+    ha_evp_hasher_set_key(hasher, key, 32);
+    ha_evp_hasher_init(hasher, HA_EVPTY_BLAKE2S, ha_bB(256));
+    ha_evp_digest(hasher, data, sizeof(data), output);
+    assert(ha_cmphashstr(output,
+                         "d5c42863172fb2424de520ff25866bf2ac9201ce81b6a8b7"
+                         "03f67ea4c6735767",
+                         32) == 0);
+    ha_evp_hasher_cleanup(hasher);
+    ha_evp_hasher_delete(hasher);
+    __fprintf(debug, stdout, "blake2-evp-keyed: passed\n");
+  }
+  {
+    /* keyed one- and two-node outputs, the second node short, and a
+       read at an offset of an open-ended output */
+    uint8_t             key[HA_BLAKE2B_KEY_SIZE], data[200], output[80];
+    uint8_t             first[32];
+    ha_blake2xb_context bctx;
+    ha_blake2xs_context sctx;
+    ha_evp_phasher_t    hasher = ha_evp_hasher_new();
+
+    for (size_t i = 0; i < sizeof(key); ++i) key[i] = (uint8_t)i;
+    for (size_t i = 0; i < sizeof(data); ++i) data[i] = (uint8_t)i;
+
+    ha_blake2xb_init_keyed(&bctx, key, 64, 1);
+    ha_blake2xb_update(&bctx, data, sizeof(data));
+    ha_blake2xb_final(&bctx, output, 1);
+    assert(ha_cmphashstr(output, "f1", 1) == 0);
+    ha_blake2xb_init_keyed(&bctx, key, 64, 80);
+    ha_blake2xb_update(&bctx, data, sizeof(data));
+    ha_blake2xb_final(&bctx, output, 80);
+    assert(ha_cmphashstr(output,
+                         "9163911b8db6a01293039b68c6d280c2798b9c26b68cb4c1"
+                         "7dc961c57afbb368776bf8e92aa3c1382d526135f94ac3e6"
+                         "c8b11a14d246a1fb98f3a765a28c4574fc8d76dda34ea4b2"
+                         "7018050535f2f2e0",
+                         80) == 0);
+    ha_blake2xs_init_keyed(&sctx, key, 32, 1);
+    ha_blake2xs_update(&sctx, data, sizeof(data));
+    ha_blake2xs_final(&sctx, output, 1);
+    assert(ha_cmphashstr(output, "c6", 1) == 0);
+    ha_blake2xs_init_keyed(&sctx, key, 32, 40);
+    ha_blake2xs_update(&sctx, data, sizeof(data));
+    ha_blake2xs_final(&sctx, output, 40);
+    assert(ha_cmphashstr(output,
+                         "5ef5c97a9fcf1a60623c9db9823394d888b2a5c109fcd3d8"
+                         "c740fb94b3618ecc27a6b2a03b77e997",
+                         40) == 0);
+    __fprintf(debug, stdout, "blake2x:      passed\n");
+
+    /* an output length the node offset field cannot hold is an error,
+       and the rejected context yields no output bytes */
+    g_ha_opts.noabort = 1;
+    memset(output, 0xee, sizeof(output));
+    ha_blake2xs_init(&sctx, 100000);
+    ha_blake2xs_update(&sctx, data, sizeof(data));
+    ha_blake2xs_final(&sctx, output, sizeof(output));
+    for (size_t i = 0; i < sizeof(output); ++i) assert(output[i] == 0);
+    memset(output, 0xee, sizeof(output));
+    ha_blake2xb_init(&bctx, 0);
+    ha_blake2xb_final(&bctx, output, sizeof(output));
+    for (size_t i = 0; i < sizeof(output); ++i) assert(output[i] == 0);
+    if (sizeof(size_t) > 4)
+    {
+      memset(output, 0xee, sizeof(output));
+      ha_blake2xb_init(&bctx, (size_t)HA_BLAKE2XB_UNKNOWN_LENGTH + 1);
+      ha_blake2xb_final(&bctx, output, sizeof(output));
+      for (size_t i = 0; i < sizeof(output); ++i) assert(output[i] == 0);
+    }
+    g_ha_opts.noabort = 0;
+    __fprintf(debug, stdout, "blake2x-outlen: passed\n");
+
+    ha_blake2xb_init(&bctx, HA_BLAKE2XB_UNKNOWN_LENGTH);
+    ha_blake2xb_update(&bctx, data, sizeof(data));
+    ha_blake2xb_final(&bctx, first, sizeof(first));
+    ha_blake2xb_seek(&bctx, 70000);
+    ha_blake2xb_squeeze(&bctx, output, 32);
+    assert(ha_cmphashstr(output,
+                         "ba99b69cb0bb7623440eafea1f7eac2c62e457f03b128bf6"
+                         "dc868224ed2dabb7",
+                         32) == 0);
+    ha_blake2xb_seek(&bctx, 0);
+    ha_blake2xb_squeeze(&bctx, output, sizeof(first));
+    assert(memcmp(output, first, sizeof(first)) == 0);
+    ha_blake2xs_init(&sctx, HA_BLAKE2XS_UNKNOWN_LENGTH);
+    ha_blake2xs_update(&sctx, data, sizeof(data));
+    ha_blake2xs_final(&sctx, output, 7);
+    ha_blake2xs_seek(&sctx, 5000);
+    ha_blake2xs_squeeze(&sctx, output, 3);
+    ha_blake2xs_squeeze(&sctx, output + 3, 29);
+    assert(ha_cmphashstr(output,
+                         "2b6c346893517b79b1d0826a5d98f5e46e096b03ec5f149b"
+                         "d420e103be24850e",
+                         32) == 0);
+    __fprintf(debug, stdout, "blake2x-seek: passed\n");
+
+    ha_evp_hasher_init(hasher, HA_EVPTY_BLAKE2XB, 80);
+    ha_evp_digest(hasher, (ha_inbuf_t)input, input_len, output);
+    assert(ha_cmphashstr(output,
+                         "7850226579c0199008e607404e0eaa208aff1d7bf8321fdb"
+                         "3c4af9168c680029e656f35429c6b02321c0565b5e6d667c"
+                         "08050f95cb237efcb971294429a7861ff5d9148351f48441"
+                         "74d0edce8e9f740c",
+                         80) == 0);
+    ha_evp_hasher_cleanup(hasher);
+    ha_evp_hasher_init(hasher, HA_EVPTY_BLAKE2XS, 40);
+    ha_evp_hash(hasher, (ha_inbuf_t)input, input_len, output);
+    assert(ha_cmphashstr(output,
+                         "efc58e0d87a20f44c42dfdbf3e2bd504b1e930f8bfc717aa"
+                         "60939c784331034c885a2475ffd23968",
+                         40) == 0);
+    ha_evp_hasher_cleanup(hasher);
+    ha_evp_hasher_delete(hasher);
+    __fprintf(debug, stdout, "blake2x-evp:  passed\n");
+  }
+  {
+    /* the RFC 7693 appendix E self-test, and every length up to three
+       blocks and one byte, hashed in one piece and in three; inputs of
+       whole blocks end with a full last block, not an empty one */
+    static const size_t b_outs[] = {20, 32, 48, 64},
+                        s_outs[] = {16, 20, 28, 32},
+                        b_ins[] = {0, 3, 128, 129, 255, 1024},
+                        s_ins[] = {0, 3, 64, 65, 255, 1024};
+    uint8_t             in[1024], key[64], md[64], split[64];
+    ha_blake2b_context  bctx, bsum;
+    ha_blake2s_context  sctx, ssum;
+
+    ha_blake2b_init_keyed(&bsum, NULL, 0, 32);
+    ha_blake2s_init_keyed(&ssum, NULL, 0, 32);
+    for (size_t o = 0; o < 4; ++o)
+    {
+      for (size_t i = 0; i < 6; ++i)
+      {
+        for (int k = 0; k < 2; ++k)
+        {
+          size_t   outlen = k ? b_outs[o] : s_outs[o],
+                   inlen = k ? b_ins[i] : s_ins[i];
+          uint32_t a, b = 1, t;
+
+          /* the RFC's selftest_seq () for the input and the key */
+          a = 0xDEAD4BADu * (uint32_t)inlen;
+          for (size_t j = 0; j < inlen; ++j, a = b, b = t)
+            in[j] = (uint8_t)((t = a + b) >> 24);
+          a = 0xDEAD4BADu * (uint32_t)outlen, b = 1;
+          for (size_t j = 0; j < outlen; ++j, a = b, b = t)
+            key[j] = (uint8_t)((t = a + b) >> 24);
+
+          if (k)
+          {
+            ha_blake2b_keyed_hash(NULL, 0, in, inlen, md, outlen);
+            ha_blake2b_update(&bsum, md, outlen);
+            ha_blake2b_keyed_hash(key, outlen, in, inlen, md, outlen);
+            ha_blake2b_update(&bsum, md, outlen);
+          }
+          else
+          {
+            ha_blake2s_keyed_hash(NULL, 0, in, inlen, md, outlen);
+            ha_blake2s_update(&ssum, md, outlen);
+            ha_blake2s_keyed_hash(key, outlen, in, inlen, md, outlen);
+            ha_blake2s_update(&ssum, md, outlen);
+          }
+        }
+      }
+    }
+    ha_blake2b_final(&bsum, md, 32);
+    assert(ha_cmphashstr(md,
+                         "c23a7800d98123bd10f506c61e29da56"
+                         "03d763b8bbad2e737f5e765a7bccd475",
+                         32) == 0);
+    ha_blake2s_final(&ssum, md, 32);
+    assert(ha_cmphashstr(md,
+                         "6a411f08ce25adcdfb02aba641451cec"
+                         "53c598b24f4fc787fbdc88797f4c1dfe",
+                         32) == 0);
+    __fprintf(debug, stdout, "blake2-rfc7693: passed\n");
+
+    for (size_t j = 0; j < sizeof(in); ++j) in[j] = (uint8_t)(j * 7);
+    ha_blake2b_init_keyed(&bsum, NULL, 0, 32);
+    for (size_t len = 0; len <= 3 * HA_BLAKE2B_BLOCK_SIZE + 1; ++len)
+    {
+      ha_blake2b_hash(in, len, md, HA_BLAKE2B_DIGEST_SIZE);
+      ha_blake2b_update(&bsum, md, HA_BLAKE2B_DIGEST_SIZE);
+      ha_blake2b_init(&bctx);
+      ha_blake2b_update(&bctx, in, len / 3);
+      ha_blake2b_update(&bctx, in + len / 3, len / 2);
+      ha_blake2b_update(&bctx, in + len / 3 + len / 2,
+                        len - len / 3 - len / 2);
+      ha_blake2b_final(&bctx, split, HA_BLAKE2B_DIGEST_SIZE);
+      assert(memcmp(md, split, HA_BLAKE2B_DIGEST_SIZE) == 0);
+    }
+    ha_blake2b_final(&bsum, md, 32);
+    assert(ha_cmphashstr(md,
+                         "5283d4bdc53620321071f68eda84a5f8"
+                         "fa8d7e6274918f0b4115ea05b860a0c6",
+                         32) == 0);
+    ha_blake2s_init_keyed(&ssum, NULL, 0, 32);
+    for (size_t len = 0; len <= 3 * HA_BLAKE2S_BLOCK_SIZE + 1; ++len)
+    {
+      ha_blake2s_hash(in, len, md, HA_BLAKE2S_DIGEST_SIZE);
+      ha_blake2s_update(&ssum, md, HA_BLAKE2S_DIGEST_SIZE);
+      ha_blake2s_init(&sctx);
+      ha_blake2s_update(&sctx, in, len / 3);
+      ha_blake2s_update(&sctx, in + len / 3, len / 2);
+      ha_blake2s_update(&sctx, in + len / 3 + len / 2,
+                        len - len / 3 - len / 2);
+      ha_blake2s_final(&sctx, split, HA_BLAKE2S_DIGEST_SIZE);
+      assert(memcmp(md, split, HA_BLAKE2S_DIGEST_SIZE) == 0);
+    }
+    ha_blake2s_final(&ssum, md, 32);
+    assert(ha_cmphashstr(md,
+                         "44269ecac735393cf9d33e67fdeac5fc"
+                         "8a1c8cf5612579cec467da603cc8b6e9",
+                         32) == 0);
+    __fprintf(debug, stdout, "blake2-sweep:   passed\n");
+  }
+  {
+    /* three blocks through the compression kernel the dispatcher picked;
+       make check runs again with each kernel forced by
+       HASHA_BLAKE2_IMPL */
+    const char *impl = getenv("HASHA_BLAKE2_IMPL");
+    uint8_t     data[3 * HA_BLAKE2B_BLOCK_SIZE], digest[64];
+
+    for (size_t i = 0; i < sizeof(data); ++i) data[i] = (uint8_t)(i * 7);
+    ha_blake2b_hash(data, sizeof(data), digest, 64);
+    assert(ha_cmphashstr(digest,
+                         "6ce1903b1f073781c2e1e8363783df6a850a1ed4118c9487"
+                         "997b77c11f9c1d18a1e078433ffd7fe94837c08237727ff3"
+                         "3d702c858ac70b1f9e6223d11440ba4e",
+                         64) == 0);
+    ha_blake2s_hash(data, 3 * HA_BLAKE2S_BLOCK_SIZE, digest, 32);
+    assert(ha_cmphashstr(digest,
+                         "9e9df5b4984de5caa1fc5f183091276dd86618c00bff43e5"
+                         "00c9173d4a75c1f6",
+                         32) == 0);
+    __fprintf(debug, stdout, "blake2-kernel (%s): passed\n",
+              impl && *impl ? impl : "auto");
+  }
+  {
+    /* the output at an offset read straight after a seek, and read past
+       the first kilobyte in one go, which runs the SIMD lanes */
+    uint8_t              data[2000], output[48], stream[1040];
+    ha_blake3_context    ctx;
+    ha_blake3_xof_reader reader;
+
+    for (size_t i = 0; i < sizeof(data); ++i) data[i] = (uint8_t)(i % 251);
+    ha_blake3_init(&ctx);
+    ha_blake3_update(&ctx, data, sizeof(data));
+    ha_blake3_finalize_xof(&ctx, &reader);
+
+    ha_blake3_xof_seek(&reader, ((uint64_t)1 << 38) - 5);
+    ha_blake3_xof_read(&reader, output, 1);
+    ha_blake3_xof_read(&reader, output + 1, sizeof(output) - 1);
+    assert(ha_cmphashstr(output,
+                         "24a30b86a83d8405b0ae262db49f446a3ef34b6b8c95eb44"
+                         "31fd07932a4f7bbf642773b9a54cee7e91134bbd65437265",
+                         sizeof(output)) == 0);
+
+    ha_blake3_xof_seek(&reader, 0);
+    ha_blake3_xof_read(&reader, stream, sizeof(stream));
+    assert(ha_cmphashstr(stream + 1000,
+                         "217a22d5d99674e6fe38bb99d88f1586aecf09f2698ce8b4"
+                         "ae28658af58d2bfdbe8b2334adf67c84",
+                         40) == 0);
+    __fprintf(debug, stdout, "blake3-xof:   passed\n");
+  }
+  {
+    /* ten 16 KiB subtrees hashed apart, the last one short, then merged
+       directly and through groups of four */
+    enum
+    {
+      LEN = 150000,
+      SUB = 16 * HA_BLAKE3_CHUNK_SIZE,
+      N = (LEN + SUB - 1) / SUB
+    };
+    static uint8_t       data[LEN];
+    uint8_t              serial[32], merged[32];
+    uint8_t              cvs[N * HA_BLAKE3_CV_SIZE];
+    uint8_t              groups[3 * HA_BLAKE3_CV_SIZE];
+    ha_blake3_context    ctx;
+    ha_blake3_xof_reader reader;
+
+    for (size_t i = 0; i < LEN; ++i) data[i] = (uint8_t)(i * 7);
+    ha_blake3_hash(data, LEN, serial, sizeof(serial));
+    for (size_t i = 0; i < N; ++i)
+    {
+      size_t off = i * SUB, len = LEN - off < SUB ? LEN - off : SUB;
+
+      ha_blake3_init(&ctx);
+      ha_blake3_set_input_offset(&ctx, off);
+      ha_blake3_update(&ctx, data + off, len);
+      ha_blake3_finalize_subtree(&ctx, cvs + i * HA_BLAKE3_CV_SIZE);
+    }
+
+    ha_blake3_init(&ctx);
+    ha_blake3_merge_root(&ctx, cvs, N, &reader);
+    ha_blake3_xof_read(&reader, merged, sizeof(merged));
+    assert(memcmp(serial, merged, sizeof(serial)) == 0);
+
+    ha_blake3_merge_subtrees(&ctx, cvs, 4, groups);
+    ha_blake3_merge_subtrees(&ctx, cvs + 4 * HA_BLAKE3_CV_SIZE, 4,
+                             groups + HA_BLAKE3_CV_SIZE);
+    ha_blake3_merge_subtrees(&ctx, cvs + 8 * HA_BLAKE3_CV_SIZE, 2,
+                             groups + 2 * HA_BLAKE3_CV_SIZE);
+    ha_blake3_merge_root(&ctx, groups, 3, &reader);
+    ha_blake3_xof_read(&reader, merged, sizeof(merged));
+    assert(memcmp(serial, merged, sizeof(serial)) == 0);
+    __fprintf(debug, stdout, "blake3-subtree: passed\n");
+  }
+  {
+    /* 98 chunks: the outboard tree, then a slice that spans a chunk
+       boundary checked against the root, and tampered with */
+    enum
+    {
+      LEN = 100000,
+      OUTBOARD = 8 + 97 * 64
+    };
+    static uint8_t data[LEN], outboard[OUTBOARD];
+    uint8_t        hash[HA_BAO_HASH_SIZE], digest[32];
+
+    for (size_t i = 0; i < LEN; ++i) data[i] = (uint8_t)(i * 7);
+    assert(ha_bao_outboard_size(LEN) == OUTBOARD);
+    ha_bao_encode_outboard(data, LEN, outboard, hash);
+    assert(ha_cmphashstr(hash,
+                         "760994ef4b09b4711b1b7808d85293681252f4ffafba45e0"
+                         "0473786bf2868c78",
+                         sizeof(hash)) == 0);
+    ha_blake3_hash(outboard, OUTBOARD, digest, sizeof(digest));
+    assert(ha_cmphashstr(digest,
+                         "27f0be6936c46f17b94bbf38c0ed45f8f681e18df0a269a1"
+                         "df4a707e17bade1e",
+                         sizeof(digest)) == 0);
+
+    assert(ha_bao_verify_range(hash, outboard, OUTBOARD, 50000, 3000,
+                               data + 48 * HA_BLAKE3_CHUNK_SIZE,
+                               4 * HA_BLAKE3_CHUNK_SIZE));
+    assert(ha_bao_verify_range(hash, outboard, OUTBOARD, 0, LEN, data,
+                               LEN));
+    assert(!ha_bao_verify_range(hash, outboard, OUTBOARD, 50000, 3000,
+                                data + 48 * HA_BLAKE3_CHUNK_SIZE,
+                                4 * HA_BLAKE3_CHUNK_SIZE - 1));
+    data[51000] ^= 1;
+    assert(!ha_bao_verify_range(hash, outboard, OUTBOARD, 50000, 3000,
+                                data + 48 * HA_BLAKE3_CHUNK_SIZE,
+                                4 * HA_BLAKE3_CHUNK_SIZE));
+    data[51000] ^= 1;
+    outboard[8] ^= 1; /* the root node */
+    assert(!ha_bao_verify_range(hash, outboard, OUTBOARD, 50000, 3000,
+                                data + 48 * HA_BLAKE3_CHUNK_SIZE,
+                                4 * HA_BLAKE3_CHUNK_SIZE));
+    outboard[8] ^= 1;
+    /* a header that grows the last chunk, which the outboard size cannot
+       tell, is caught by the buffer size before the chunk is read */
+    assert(ha_bao_verify_range(hash, outboard, OUTBOARD, 99500, 100,
+                               data + 97 * HA_BLAKE3_CHUNK_SIZE,
+                               LEN - 97 * HA_BLAKE3_CHUNK_SIZE));
+    outboard[1] = (uint8_t)((98 * HA_BLAKE3_CHUNK_SIZE) >> 8);
+    outboard[0] = (uint8_t)(98 * HA_BLAKE3_CHUNK_SIZE);
+    assert(!ha_bao_verify_range(hash, outboard, OUTBOARD, 99500, 100,
+                                data + 97 * HA_BLAKE3_CHUNK_SIZE,
+                                LEN - 97 * HA_BLAKE3_CHUNK_SIZE));
+    outboard[1] = (uint8_t)(LEN >> 8);
+    outboard[0] = (uint8_t)LEN;
+    __fprintf(debug, stdout, "bao:          passed\n");
+  }
+}
+
+void e2e_4()
+{
+  enum
+  {
+    N = 37,
+    STRIDE = 288
+  };
+  static const struct
+  {
+    void (*many)(const uint8_t *const *, const size_t *, size_t,
+                 uint8_t *);
+    void (*one)(ha_inbuf_t, size_t, ha_digest_t);
+    size_t      size;
+    const char *name;
+  } algs[] = {
+      {    ha_sha2_224_hash_many,     ha_sha2_224_hash,
+       HA_SHA2_224_DIGEST_SIZE,     "sha2-224:"    },
+      {    ha_sha2_256_hash_many,     ha_sha2_256_hash,
+       HA_SHA2_256_DIGEST_SIZE,     "sha2-256:"    },
+      {    ha_sha2_384_hash_many,     ha_sha2_384_hash,
+       HA_SHA2_384_DIGEST_SIZE,     "sha2-384:"    },
+      {    ha_sha2_512_hash_many,     ha_sha2_512_hash,
+       HA_SHA2_512_DIGEST_SIZE,     "sha2-512:"    },
+      {ha_sha2_512_224_hash_many, ha_sha2_512_224_hash,
+       HA_SHA2_512_224_DIGEST_SIZE, "sha2-512/224:"},
+      {ha_sha2_512_256_hash_many, ha_sha2_512_256_hash,
+       HA_SHA2_512_256_DIGEST_SIZE, "sha2-512/256:"},
+      {    ha_sha3_256_hash_many,     ha_sha3_256_hash,
+       HA_SHA3_256_DIGEST_SIZE,     "sha3-256:"    },
+      {  ha_keccak_256_hash_many,   ha_keccak_256_hash,
+       HA_KECCAK_256_DIGEST_SIZE,   "keccak-256:"  },
+      {         ha_md5_hash_many,          ha_md5_hash,
+       HA_MD5_DIGEST_SIZE,          "md5:"         },
+  };
+  static uint8_t data[N * STRIDE];
+  const uint8_t *bufs[N];
+  size_t         lens[N];
+  static uint8_t many[N * HA_SHA2_512_DIGEST_SIZE];
+  uint8_t        one[HA_SHA2_512_DIGEST_SIZE];
+
+  for (size_t i = 0; i < sizeof(data); ++i) data[i] = (uint8_t)(i * 7);
+  /* unequal lengths around the one- and two-block padding edges */
+  for (size_t i = 0; i < N; ++i)
+  {
+    bufs[i] = data + i * STRIDE;
+    lens[i] = (i * 53) % STRIDE;
+  }
+
+  for (size_t k = 0; k < sizeof(algs) / sizeof(algs[0]); ++k)
+  {
+    algs[k].many(bufs, lens, N, many);
+    for (size_t i = 0; i < N; ++i)
+    {
+      algs[k].one(bufs[i], lens[i], one);
+      assert(memcmp(many + i * algs[k].size, one, algs[k].size) == 0);
+    }
+    __fprintf(debug, stdout, "%-13s passed\n", algs[k].name);
+  }
+}
+
 void rune2e()
 {
   __fprintf(debug, stdout, "\n == hash\n");
@@ -1035,6 +2193,10 @@ void rune2e()
   e2e_1();
   __fprintf(debug, stdout, "\n == evp [ha_evp_digest]:\n");
   e2e_2();
+  __fprintf(debug, stdout, "\n == hash [multi-block]:\n");
+  e2e_3();
+  __fprintf(debug, stdout, "\n == hash [many]:\n");
+  e2e_4();
   __fprintf(debug, stdout, "\n");
 }
 
@@ -96,8 +96,14 @@ HA_PRVFUN void print_usage(const char *prog_name)
       "keccak384, keccak512\n");
   printf(
       "  blake2s_<digestlen(8...256)>"
-      "  blake2s_<digestlen(8...512)>"
+      "  blake2b_<digestlen(8...512)>"
       "  blake3_<digestlen>\n");
+  printf(
+      "  blake2sp_<digestlen(8...256)>"
+      "  blake2bp_<digestlen(8...512)>\n");
+  printf(
+      "  blake2xs_<digestlen(8...4096)>"
+      "  blake2xb_<digestlen(8...4096)>\n");
   printf("Options:\n");
   printf(
       "  -t, --iters NUM      Number of iterations for benchmarking "
@@ -157,6 +163,25 @@ HA_PRVFUN void file_bufread(char *content, size_t sz, size_t bufsz,
     content[sz] = '\0';  // Null-terminate the string
 }
 
+// Helper: bit length of a <name>_<bits> token, a multiple of 8 in
+// 8...max_bits, or 0 after reporting a bad one
+HA_PRVFUN long blake2_digest_bits(const char *name, const char *token,
+                                  long max_bits)
+{
+  const char *len_str = token + strlen(name) + 1;
+  char       *end;
+  long        bits = strtol(len_str, &end, 10);
+  if (end == len_str || *end != '\0' || bits < 8 || bits > max_bits ||
+      bits % 8 != 0)
+  {
+    ha_throw_error(0, ha_curpos,
+                   ha_bench_error_strings[INVALID_DIGEST_LEN_ERROR], name,
+                   token);
+    return 0;
+  }
+  return bits;
+}
+
 int main(int argc, char *argv[])
 {
   int                  iterations = 1;        // Default iterations
@@ -318,6 +343,14 @@ int main(int argc, char *argv[])
               (const uint8_t *)input, input_len, output, ha_bB(256));
     BENCHMARK(iterations, "BLAKE2B-512", ha_blake2b_hash, result_file,
               (const uint8_t *)input, input_len, output, ha_bB(512));
+    BENCHMARK(iterations, "BLAKE2SP-256", ha_blake2sp_hash, result_file,
+              (const uint8_t *)input, input_len, output, ha_bB(256));
+    BENCHMARK(iterations, "BLAKE2BP-512", ha_blake2bp_hash, result_file,
+              (const uint8_t *)input, input_len, output, ha_bB(512));
+    BENCHMARK(iterations, "BLAKE2XS-4096", ha_blake2xs_hash, result_file,
+              (const uint8_t *)input, input_len, output, ha_bB(4096));
+    BENCHMARK(iterations, "BLAKE2XB-4096", ha_blake2xb_hash, result_file,
+              (const uint8_t *)input, input_len, output, ha_bB(4096));
     BENCHMARK(iterations, "BLAKE3-224", ha_blake3_hash, result_file,
               (const uint8_t *)input, input_len, output, ha_bB(224));
     BENCHMARK(iterations, "BLAKE3-256", ha_blake3_hash, result_file,
@@ -428,38 +461,96 @@ int main(int argc, char *argv[])
         BENCHMARK(iterations, "KECCAKF-1600", ha_keccakf1600, result_file,
                   state);
       }
-      else if (strncmp(token, "blake2s_", 7) == 0)
+      else if (strncmp(token, "blake2xs_", 9) == 0)
       {
         char *endptr;
-        long  digest_bits = strtol(token + 8, &endptr, 10);
-        if ((token + 7) == endptr || digest_bits <= 0)
+        long  digest_bits = strtol(token + 9, &endptr, 10);
+        if ((token + 9) == endptr || digest_bits <= 0
+            || digest_bits > 8 * (long)sizeof(output))
         {
           ha_throw_error(0, ha_curpos,
                          ha_bench_error_strings[INVALID_DIGEST_LEN_ERROR],
-                         "blake2s", token);
+                         "blake2xs", token);
         }
         else
         {
           size_t digest_bytes = ha_bB(digest_bits);
           char   benchname[64];
-          snprintf(benchname, sizeof(benchname), "hasha BLAKE2S-%ld",
+          snprintf(benchname, sizeof(benchname), "hasha BLAKE2XS-%ld",
                    digest_bits);
-          BENCHMARK(iterations, benchname, ha_blake2s_hash, result_file,
+          BENCHMARK(iterations, benchname, ha_blake2xs_hash, result_file,
                     (const uint8_t *)input, input_len, output,
                     digest_bytes);
         }
       }
-      else if (strncmp(token, "blake2b_", 7) == 0)
+      else if (strncmp(token, "blake2xb_", 9) == 0)
       {
         char *endptr;
-        long  digest_bits = strtol(token + 8, &endptr, 10);
-        if ((token + 7) == endptr || digest_bits <= 0)
+        long  digest_bits = strtol(token + 9, &endptr, 10);
+        if ((token + 9) == endptr || digest_bits <= 0
+            || digest_bits > 8 * (long)sizeof(output))
         {
           ha_throw_error(0, ha_curpos,
                          ha_bench_error_strings[INVALID_DIGEST_LEN_ERROR],
-                         "blake2b", token);
+                         "blake2xb", token);
         }
         else
+        {
+          size_t digest_bytes = ha_bB(digest_bits);
+          char   benchname[64];
+          snprintf(benchname, sizeof(benchname), "hasha BLAKE2XB-%ld",
+                   digest_bits);
+          BENCHMARK(iterations, benchname, ha_blake2xb_hash, result_file,
+                    (const uint8_t *)input, input_len, output,
+                    digest_bytes);
+        }
+      }
+      else if (strncmp(token, "blake2sp_", 9) == 0)
+      {
+        long digest_bits = blake2_digest_bits("blake2sp", token, 256);
+        if (digest_bits)
+        {
+          size_t digest_bytes = ha_bB(digest_bits);
+          char   benchname[64];
+          snprintf(benchname, sizeof(benchname), "hasha BLAKE2SP-%ld",
+                   digest_bits);
+          BENCHMARK(iterations, benchname, ha_blake2sp_hash, result_file,
+                    (const uint8_t *)input, input_len, output,
+                    digest_bytes);
+        }
+      }
+      else if (strncmp(token, "blake2bp_", 9) == 0)
+      {
+        long digest_bits = blake2_digest_bits("blake2bp", token, 512);
+        if (digest_bits)
+        {
+          size_t digest_bytes = ha_bB(digest_bits);
+          char   benchname[64];
+          snprintf(benchname, sizeof(benchname), "hasha BLAKE2BP-%ld",
+                   digest_bits);
+          BENCHMARK(iterations, benchname, ha_blake2bp_hash, result_file,
+                    (const uint8_t *)input, input_len, output,
+                    digest_bytes);
+        }
+      }
+      else if (strncmp(token, "blake2s_", 8) == 0)
+      {
+        long digest_bits = blake2_digest_bits("blake2s", token, 256);
+        if (digest_bits)
+        {
+          size_t digest_bytes = ha_bB(digest_bits);
+          char   benchname[64];
+          snprintf(benchname, sizeof(benchname), "hasha BLAKE2S-%ld",
+                   digest_bits);
+          BENCHMARK(iterations, benchname, ha_blake2s_hash, result_file,
+                    (const uint8_t *)input, input_len, output,
+                    digest_bytes);
+        }
+      }
+      else if (strncmp(token, "blake2b_", 8) == 0)
+      {
+        long digest_bits = blake2_digest_bits("blake2b", token, 512);
+        if (digest_bits)
         {
           size_t digest_bytes = ha_bB(digest_bits);
           char   benchname[64];
@@ -55,8 +55,9 @@ int main(int argc, char *argv[])
         return EXIT_SUCCESS;
       case 0:    // --keccakf1600-implid (long option without short
                  // equivalent)
-        ha_throw(1, 1, ha_curpos, "info", "keccakf1600 implid: 0x%.5x",
-                 ha_keccakf1600_implid());
+        ha_throw(1, 1, ha_curpos, "info",
+                 "keccakf1600 implid: 0x%.5x (%s)", ha_keccakf1600_implid(),
+                 ha_keccakf1600_implname());
         return EXIT_SUCCESS;
       default:
         // throw_usage(argv[0]);
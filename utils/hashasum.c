@@ -39,8 +39,11 @@ void print_usage(const char *execu)
       "keccak384, keccak512\n");
   printf(
       "  blake2s_<digestlen(8...256)>"
-      "  blake2s_<digestlen(8...512)>"
+      "  blake2b_<digestlen(8...512)>"
       "  blake3_<digestlen>\n");
+  printf(
+      "  blake2sp_<digestlen(8...256)>"
+      "  blake2bp_<digestlen(8...512)>\n");
   printf("\nData source options:\n");
   printf("  -s <string>        Hash a string provided as an argument\n");
   printf("  -f <file_path>     Hash the contents of a file\n");
@@ -51,6 +54,22 @@ void print_usage(const char *execu)
       "hash\n");
 }
 
+// digest size in bytes of a blake2*_<bits> name, bits in 8...max_bits
+size_t blake2_digest_size(const char *algorithm, const char *len_str,
+                          long max_bits)
+{
+  char *end;
+  long  len = strtol(len_str, &end, 10);
+  if (end == len_str || *end != '\0' || len < 8 || len > max_bits ||
+      len % 8 != 0)
+  {
+    ha_throw_error(0, ha_curpos, ha_sum_error_strings[UNSUPPORTED_ERR],
+                   "digest length in '%s'", algorithm);
+    exit(EXIT_FAILURE);
+  }
+  return ha_bB(len);
+}
+
 void hash_data(const char *algorithm, ha_inbuf_t data, size_t length,
                ha_digest_t digest, size_t *digest_size)
 {
@@ -140,20 +159,24 @@ void hash_data(const char *algorithm, ha_inbuf_t data, size_t length,
     *digest_size = HA_KECCAK_512_DIGEST_SIZE;
     ha_keccak_512_hash(data, length, digest);
   }
-  else if (strncmp(algorithm, "blake2b_", 7) == 0)
+  else if (strncmp(algorithm, "blake2bp_", 9) == 0)
   {
-    const char *len_str = algorithm + 8;
-    char       *end;
-    long        len = strtol(len_str, &end, 10);
-    *digest_size    = ha_bB(len);
+    *digest_size = blake2_digest_size(algorithm, algorithm + 9, 512);
+    ha_blake2bp_hash(data, length, digest, *digest_size);
+  }
+  else if (strncmp(algorithm, "blake2sp_", 9) == 0)
+  {
+    *digest_size = blake2_digest_size(algorithm, algorithm + 9, 256);
+    ha_blake2sp_hash(data, length, digest, *digest_size);
+  }
+  else if (strncmp(algorithm, "blake2b_", 8) == 0)
+  {
+    *digest_size = blake2_digest_size(algorithm, algorithm + 8, 512);
     ha_blake2b_hash(data, length, digest, *digest_size);
   }
-  else if (strncmp(algorithm, "blake2s_", 7) == 0)
+  else if (strncmp(algorithm, "blake2s_", 8) == 0)
   {
-    const char *len_str = algorithm + 8;
-    char       *end;
-    long        len = strtol(len_str, &end, 10);
-    *digest_size    = ha_bB(len);
+    *digest_size = blake2_digest_size(algorithm, algorithm + 8, 256);
     ha_blake2s_hash(data, length, digest, *digest_size);
   }
   else if (strncmp(algorithm, "blake3_", 7) == 0)